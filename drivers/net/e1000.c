@@ -36,7 +36,9 @@
 #include <nuttx/addrenv.h>
 #include <nuttx/spinlock.h>
 
+#include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/pci/pci.h>
 #include <nuttx/net/e1000.h>
 
@@ -608,6 +610,50 @@ static int e1000_transmit(FAR struct netdev_lowerhalf_s *dev,
   priv->tx[desc].cso    = 0;
   priv->tx[desc].status = 0;
 
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  if (netpkt_is_csumpartial(dev, pkt))
+    {
+      unsigned int llhdrlen = NET_LL_HDRLEN(&dev->netdev);
+      unsigned int offset;
+      unsigned int css;
+
+      css = netpkt_getcsumstart(dev, pkt, &offset);
+
+#ifdef CONFIG_NET_IPv6
+      if ((*IOB_DATA(pkt) & IP_VERSION_MASK) == IPv6_VERSION &&
+          offset == offsetof(struct udp_hdr_s, udpchksum))
+        {
+          FAR uint8_t *field = netpkt_getdata(dev, pkt) + css + offset;
+          uint16_t sum;
+
+          /* The hardware would insert a sum of 0 as it is, which is not a
+           * valid UDP checksum over IPv6.  Complete it here and send
+           * 0xffff instead, like udp_send() does.
+           */
+
+          sum = ~chksum_iob(0, pkt, css - llhdrlen);
+          if (sum == 0)
+            {
+              sum = 0xffff;
+            }
+
+          field[0] = sum >> 8;
+          field[1] = sum & 0xff;
+        }
+      else
+#endif
+        {
+          /* The hardware sums up from CSS to the end of the packet,
+           * including the pseudo header sum already stored at CSO.
+           */
+
+          priv->tx[desc].css  = css;
+          priv->tx[desc].cso  = css + offset;
+          priv->tx[desc].cmd |= E1000_TDESC_CMD_IC;
+        }
+    }
+#endif
+
   UP_DSB();
 
   /* Update TX tail */
@@ -639,61 +685,86 @@ static int e1000_transmit(FAR struct netdev_lowerhalf_s *dev,
 static FAR netpkt_t *e1000_receive(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct e1000_driver_s *priv = (FAR struct e1000_driver_s *)dev;
-  FAR netpkt_t              *pkt  = NULL;
-  FAR struct e1000_rx_leg_s *rx   = NULL;
-  int                        desc = desc = priv->rx_now;
+  FAR netpkt_t              *pkt;
+  FAR struct e1000_rx_leg_s *rx;
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  uint8_t                    status;
+#endif
+  uint8_t                    errors;
+  int                        desc;
 
-  /* Get RX descriptor and RX packet */
+  /* Skip the frames with errors, so that they do not end the batch */
 
-  rx = &priv->rx[desc];
-  pkt = priv->rx_pkt[desc];
+  for (; ; )
+    {
+      /* Get RX descriptor and RX packet */
 
-  /* Check if descriptor done */
+      desc = priv->rx_now;
+      rx   = &priv->rx[desc];
+      pkt  = priv->rx_pkt[desc];
 
-  if (!(rx->status & E1000_RDESC_STATUS_DD))
-    {
-      return NULL;
-    }
+      /* Check if descriptor done */
 
-  /* Next descriptor */
+      if (!(rx->status & E1000_RDESC_STATUS_DD))
+        {
+          return NULL;
+        }
 
-  priv->rx_now = (priv->rx_now + 1) % E1000_RX_DESC;
+      /* Next descriptor */
 
-  /* Allocate new rx packet */
+      priv->rx_now = (priv->rx_now + 1) % E1000_RX_DESC;
 
-  priv->rx_pkt[desc] = netpkt_alloc(dev, NETPKT_RX);
-  if (priv->rx_pkt[desc] == NULL)
-    {
-      nerr("alloc pkt_new failed\n");
-      PANIC();
-    }
+      /* Allocate new rx packet */
 
-  /* Set packet length */
+      priv->rx_pkt[desc] = netpkt_alloc(dev, NETPKT_RX);
+      if (priv->rx_pkt[desc] == NULL)
+        {
+          nerr("alloc pkt_new failed\n");
+          PANIC();
+        }
 
-  netpkt_setdatalen(dev, pkt, rx->len);
+      /* Set packet length */
 
-  /* Store new packet in RX descriptor ring */
+      netpkt_setdatalen(dev, pkt, rx->len);
 
-  rx->addr   = up_addrenv_va_to_pa(
-               netpkt_getdata(dev, priv->rx_pkt[desc]));
-  rx->len    = 0;
-  rx->status = 0;
+      /* Store new packet in RX descriptor ring */
 
-  /* Update RX tail */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      status     = rx->status;
+#endif
+      errors     = rx->errors;
+      rx->addr   = up_addrenv_va_to_pa(
+                   netpkt_getdata(dev, priv->rx_pkt[desc]));
+      rx->len    = 0;
+      rx->status = 0;
+      rx->errors = 0;
 
-  e1000_putreg_mem(priv, E1000_RDT, desc);
+      /* Update RX tail */
 
-  /* Handle errors */
+      e1000_putreg_mem(priv, E1000_RDT, desc);
 
-  if (rx->errors)
-    {
-      nerr("RX error reported (%"PRIu8")\n", rx->errors);
-      NETDEV_RXERRORS(&priv->dev.netdev);
-      netpkt_free(dev, pkt, NETPKT_RX);
-      return NULL;
-    }
+      /* Handle errors */
 
-  return pkt;
+      if (errors != 0)
+        {
+          nerr("RX error reported (%"PRIu8")\n", errors);
+          NETDEV_RXERRORS(&priv->dev.netdev);
+          netpkt_free(dev, pkt, NETPKT_RX);
+          continue;
+        }
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      /* Packets with a bad checksum were dropped on E1000_RDESC_ERRORS */
+
+      if ((status & (E1000_RDESC_STATUS_TCPCS | E1000_RDESC_STATUS_IXSM)) ==
+          E1000_RDESC_STATUS_TCPCS)
+        {
+          netpkt_setcsumvalid(dev, pkt);
+        }
+#endif
+
+      return pkt;
+    }
 }
 
 /*****************************************************************************
@@ -1333,6 +1404,14 @@ static void e1000_enable(FAR struct e1000_driver_s *priv)
 #endif
   e1000_putreg_mem(priv, E1000_RCTL, regval);
 
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  /* Let the hardware check the TCP/UDP checksums */
+
+  regval = e1000_getreg_mem(priv, E1000_RXCSUM);
+  regval |= E1000_RXCSUM_IPOFL | E1000_RXCSUM_TUOFL;
+  e1000_putreg_mem(priv, E1000_RXCSUM, regval);
+#endif
+
   /* REVISIT: Set granularity to Descriptors */
 
   regval = e1000_getreg_mem(priv, E1000_RXDCTL);
@@ -1539,6 +1618,9 @@ static int e1000_probe(FAR struct pci_device_s *dev)
   netdev->quota[NETPKT_TX] = E1000_TX_QUOTA;
   netdev->quota[NETPKT_RX] = E1000_RX_QUOTA;
   netdev->ops = &g_e1000_ops;
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  netdev->features = NETDEV_TX_CSUM | NETDEV_RX_CSUM;
+#endif
 
   return netdev_lower_register(netdev, NET_LL_ETHERNET);
 
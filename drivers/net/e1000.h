@@ -297,6 +297,13 @@
 #define E1000_RCTL_SECRC            (1 << 26)  /* Bit 26: Strip Ethernet CRC from incoming packet */
                                                /* Bits 27-31: Reserved */
 
+/* Receive Checksum Control */
+
+#define E1000_RXCSUM_PCSS_SHIFT     (0)        /* Bits 0-7: Packet Checksum Start */
+#define E1000_RXCSUM_IPOFL          (1 << 8)   /* Bit 8: IP Checksum Off-load Enable */
+#define E1000_RXCSUM_TUOFL          (1 << 9)   /* Bit 9: TCP/UDP Checksum Off-load Enable */
+                                               /* Bits 10-31: Reserved */
+
 /* Receive Descriptor Control */
 
 #define E1000_RXDCTL_PTHRESH_SHIFT  (0)        /* Bits 0-5: Prefetch Threshold */
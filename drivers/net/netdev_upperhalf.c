@@ -29,9 +29,11 @@
 #include <debug.h>
 #include <errno.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
+#include <nuttx/ethtool.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
@@ -39,6 +41,8 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 
@@ -66,6 +70,39 @@
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_NETDEV_GSO
+/* This structure describes a GSO packet being cut into TCP segments */
+
+struct netdev_gso_s
+{
+  FAR netpkt_t *pkt;       /* The GSO packet, NULL if none is pending */
+  uint16_t      iphdrlen;  /* Length of the IP header */
+  uint16_t      hdrlen;    /* Length of the IP and TCP headers */
+  uint16_t      mss;       /* TCP payload length of each segment */
+  uint16_t      offset;    /* TCP payload already sent */
+  uint16_t      index;     /* Index of the next segment */
+};
+#endif
+
+#ifdef CONFIG_NETDEV_GRO
+/* This structure describes the TCP segments being merged by GRO */
+
+struct netdev_gro_s
+{
+  FAR netpkt_t *pkt;       /* The merged packet, NULL if none is held */
+  uint32_t      seqno;     /* Sequence number expected in the next segment */
+  uint16_t      iphdrlen;  /* Length of the IP header */
+  uint16_t      hdrlen;    /* Length of the IP and TCP headers */
+  uint16_t      iplen;     /* Length of the merged IP packet */
+  uint16_t      sum;       /* Checksum of the merged TCP payload */
+  uint16_t      nsegs;     /* Number of segments in the merged packet */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  bool          verified;  /* The driver verified all merged segments */
+#endif
+  bool          enabled;   /* Merge received segments on this device */
+};
+#endif
+
 /* This structure describes the state of the upper half driver */
 
 struct netdev_upperhalf_s
@@ -87,6 +124,18 @@ struct netdev_upperhalf_s
 #if CONFIG_IOB_NCHAINS > 0
   struct iob_queue_s txq;
 #endif
+
+  /* GSO packet being segmented in software */
+
+#ifdef CONFIG_NETDEV_GSO
+  struct netdev_gso_s gso;
+#endif
+
+  /* TCP segments being merged in software */
+
+#ifdef CONFIG_NETDEV_GRO
+  struct netdev_gro_s gro;
+#endif
 };
 
 /****************************************************************************
@@ -179,6 +228,9 @@ static void netpkt_put(FAR struct net_driver_s *dev, FAR netpkt_t *pkt,
                        enum netpkt_type_e type)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  uint8_t csumstate = dev->d_csumstate;
+#endif
 
   DEBUGASSERT(dev && pkt);
 
@@ -191,6 +243,9 @@ static void netpkt_put(FAR struct net_driver_s *dev, FAR netpkt_t *pkt,
   netdev_iob_release(dev);
   dev->d_iob = pkt;
   dev->d_len = netpkt_getdatalen(upper->lower, pkt);
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  dev->d_csumstate = csumstate; /* The state belongs to pkt */
+#endif
 }
 
 /****************************************************************************
@@ -248,6 +303,145 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
   return quota > 0;
 }
 
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+/****************************************************************************
+ * Name: netdev_upper_csumcap
+ *
+ * Description:
+ *   Get the NETDEV_CSUM_* capabilities from the features of the lower half.
+ *
+ ****************************************************************************/
+
+static uint8_t netdev_upper_csumcap(FAR struct netdev_lowerhalf_s *lower)
+{
+  uint8_t cap = 0;
+
+  if ((lower->features & NETDEV_TX_CSUM) != 0)
+    {
+      cap |= NETDEV_CSUM_TX;
+    }
+
+  if ((lower->features & NETDEV_RX_CSUM) != 0)
+    {
+      cap |= NETDEV_CSUM_RX;
+    }
+
+  return cap;
+}
+#endif
+
+#ifdef CONFIG_NETDEV_GSO
+/****************************************************************************
+ * Name: netdev_upper_tso_capable
+ *
+ * Description:
+ *   Check if the lower half can segment the GSO packet by itself.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_tso_capable(FAR struct netdev_lowerhalf_s *lower,
+                                     FAR netpkt_t *pkt)
+{
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  uint8_t version = *IOB_DATA(pkt) & IP_VERSION_MASK;
+
+  /* The TCP stack leaves the checksum of a GSO packet to the segments, so
+   * the hardware has to compute it for every segment it cuts.
+   */
+
+  if (lower->netdev.d_csumstate == NETDEV_CSUM_PARTIAL)
+    {
+      return (version == IPv4_VERSION &&
+              (lower->features & NETDEV_TX_TSO4) != 0) ||
+             (version == IPv6_VERSION &&
+              (lower->features & NETDEV_TX_TSO6) != 0);
+    }
+#endif
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gso_start
+ *
+ * Description:
+ *   Take the GSO packet in d_iob from the network stack, it is cut into
+ *   TCP segments by the following netdev_upper_gso_cut() calls.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *   gso - The segmentation state to set up
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_gso_start(FAR struct net_driver_s *dev,
+                                  FAR struct netdev_gso_s *gso)
+{
+  FAR netpkt_t *pkt = dev->d_iob;
+  FAR struct tcp_hdr_s *tcp;
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  unsigned int iphdrlen;
+  unsigned int hdrlen;
+
+  DEBUGASSERT(gso->pkt == NULL);
+
+#ifdef CONFIG_NET_IPv4
+  if ((*ip & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      iphdrlen = (*ip & IPv4_HLMASK) << 2;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((*ip & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      iphdrlen = IPv6_HDRLEN;
+    }
+  else
+#endif
+    {
+      iphdrlen = pkt->io_len;
+    }
+
+  /* The IP and TCP headers must be in the first buffer */
+
+  tcp    = (FAR struct tcp_hdr_s *)(ip + iphdrlen);
+  hdrlen = iphdrlen + TCP_HDRLEN;
+  if (hdrlen <= pkt->io_len)
+    {
+      hdrlen = iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+    }
+
+  if (hdrlen > pkt->io_len || hdrlen >= pkt->io_pktlen)
+    {
+      nerr("ERROR: Bad GSO packet\n");
+      NETDEV_TXERRORS(dev);
+      netdev_iob_release(dev);
+      return -EINVAL;
+    }
+
+  gso->pkt      = pkt;
+  gso->iphdrlen = iphdrlen;
+  gso->hdrlen   = hdrlen;
+  gso->mss      = dev->d_gsosize;
+  gso->offset   = 0;
+  gso->index    = 0;
+
+  netdev_iob_clear(dev);
+  dev->d_gsosize = 0;
+
+  return NETDEV_TX_CONTINUE;
+}
+
+#endif /* CONFIG_NETDEV_GSO */
+
 /****************************************************************************
  * Name: netdev_upper_txpoll
  *
@@ -282,6 +476,26 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
   DEBUGASSERT(dev->d_len > 0);
 
+#ifdef CONFIG_NETDEV_GSO
+  if (dev->d_gsosize > 0)
+    {
+      if (netpkt_getdatalen(lower, dev->d_iob) <= NETDEV_PKTSIZE(dev))
+        {
+          /* Small enough to be sent as is, e.g. replaced by an ARP
+           * request.
+           */
+
+          dev->d_gsosize = 0;
+        }
+      else if (!netdev_upper_tso_capable(lower, dev->d_iob))
+        {
+          /* Segment it in software, see netdev_upper_gso_next() */
+
+          return netdev_upper_gso_start(dev, &upper->gso);
+        }
+    }
+#endif
+
   NETDEV_TXPACKETS(dev);
 
 #ifdef CONFIG_NET_PKT
@@ -292,7 +506,8 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
   pkt = netpkt_get(dev, NETPKT_TX);
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev) &&
+      netpkt_getgsosize(lower, pkt) == 0)
     {
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
@@ -313,9 +528,179 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
       return ret;
     }
 
+#ifdef CONFIG_NETDEV_GSO
+  dev->d_gsosize = 0;
+#endif
+
   return NETDEV_TX_CONTINUE;
 }
 
+#ifdef CONFIG_NETDEV_GSO
+/****************************************************************************
+ * Name: netdev_upper_gso_cut
+ *
+ * Description:
+ *   Cut the next TCP segment from a GSO packet into d_iob, with its own
+ *   IP header and TCP checksum.  The GSO packet is released after its last
+ *   segment.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *   gso - The segmentation state
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_gso_cut(FAR struct net_driver_s *dev,
+                                FAR struct netdev_gso_s *gso)
+{
+  FAR struct tcp_hdr_s *tcp;
+  FAR netpkt_t *seg;
+  FAR uint8_t *ip;
+  unsigned int llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int paylen;
+  unsigned int seglen;
+  uint16_t len;
+  int ret;
+
+  paylen = gso->pkt->io_pktlen - gso->hdrlen;
+  seglen = MIN(gso->mss, paylen - gso->offset);
+
+  seg = iob_tryalloc(false);
+  if (seg == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+
+  /* Copy the link layer, IP and TCP headers, then the payload */
+
+  ip = IOB_DATA(seg);
+  memcpy(ip - llhdrlen, IOB_DATA(gso->pkt) - llhdrlen,
+         llhdrlen + gso->hdrlen);
+
+  ret = iob_clone_partial(gso->pkt, seglen, gso->hdrlen + gso->offset,
+                          seg, gso->hdrlen, false, false);
+  if (ret < 0)
+    {
+      iob_free_chain(seg);
+      return ret;
+    }
+
+  /* Fix up the headers for this segment */
+
+  tcp = (FAR struct tcp_hdr_s *)(ip + gso->iphdrlen);
+
+#ifdef CONFIG_NET_IPv4
+  if ((*ip & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+      uint16_t ipid = ((uint16_t)ipv4->ipid[0] << 8) + ipv4->ipid[1];
+
+      len            = gso->hdrlen + seglen;
+      ipid          += gso->index;
+      ipv4->len[0]   = len >> 8;
+      ipv4->len[1]   = len & 0xff;
+      ipv4->ipid[0]  = ipid >> 8;
+      ipv4->ipid[1]  = ipid & 0xff;
+      ipv4->ipchksum = 0;
+      ipv4->ipchksum = ~(ipv4_chksum(ipv4));
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if ((*ip & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      len            = gso->hdrlen - IPv6_HDRLEN + seglen;
+      ipv6->len[0]   = len >> 8;
+      ipv6->len[1]   = len & 0xff;
+    }
+#endif
+
+  net_incr32(tcp->seqno, gso->offset);
+  if (gso->offset + seglen < paylen)
+    {
+      tcp->flags &= ~(TCP_FIN | TCP_PSH);
+    }
+
+  netdev_iob_replace(dev, seg);
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  tcp->tcpchksum = 0;
+
+  if (!netdev_csum_partial(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+    {
+#ifdef CONFIG_NET_IPv4
+      if ((*ip & IP_VERSION_MASK) == IPv4_VERSION)
+        {
+          tcp->tcpchksum = ~ipv4_upperlayer_chksum(dev, IP_PROTO_TCP);
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      if ((*ip & IP_VERSION_MASK) == IPv6_VERSION)
+        {
+          tcp->tcpchksum = ~ipv6_upperlayer_chksum(dev, IP_PROTO_TCP,
+                                                   IPv6_HDRLEN);
+        }
+#endif
+    }
+#endif
+
+  /* Release the GSO packet after its last segment */
+
+  gso->offset += seglen;
+  gso->index++;
+  if (gso->offset >= paylen)
+    {
+      iob_free_chain(gso->pkt);
+      gso->pkt = NULL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gso_next
+ *
+ * Description:
+ *   Cut the next TCP segment from the pending GSO packet and send it.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_gso_next(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
+
+  ret = netdev_upper_gso_cut(dev, &upper->gso);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return netdev_upper_txpoll(dev);
+}
+#endif /* CONFIG_NETDEV_GSO */
+
 /****************************************************************************
  * Name: netdev_upper_tx
  *
@@ -337,9 +722,20 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
 static int netdev_upper_tx(FAR struct net_driver_s *dev)
 {
-#if CONFIG_IOB_NCHAINS > 0
+#if CONFIG_IOB_NCHAINS > 0 || defined(CONFIG_NETDEV_GSO)
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+#endif
+
+#ifdef CONFIG_NETDEV_GSO
+  if (upper->gso.pkt != NULL)
+    {
+      /* Finish the pending GSO packet first to keep the segments in order */
+
+      return netdev_upper_gso_next(dev);
+    }
+#endif
 
+#if CONFIG_IOB_NCHAINS > 0
   if (!IOB_QEMPTY(&upper->txq))
     {
       /* Put the packet back to the device */
@@ -383,205 +779,822 @@ static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
 }
 
 /****************************************************************************
- * Name: netdev_upper_queue_tx
+ * Name: netdev_upper_queue_tx
+ *
+ * Description:
+ *   Queue a TX packet to the upper half for sending later.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211) || defined(CONFIG_NET_MBIM)
+static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
+{
+#if CONFIG_IOB_NCHAINS > 0
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
+
+#ifdef CONFIG_NETDEV_GSO
+  /* The GSO size and the checksum state are kept on the device for the
+   * packet in d_iob only, cut a GSO packet into segments before queuing.
+   */
+
+  if (dev->d_gsosize > 0)
+    {
+      struct netdev_gso_s gso;
+
+      if (netpkt_getdatalen(upper->lower, dev->d_iob) <= NETDEV_PKTSIZE(dev))
+        {
+          dev->d_gsosize = 0;
+        }
+      else
+        {
+          gso.pkt = NULL;
+          if (netdev_upper_gso_start(dev, &gso) < 0)
+            {
+              return;
+            }
+
+          while (gso.pkt != NULL)
+            {
+              ret = netdev_upper_gso_cut(dev, &gso);
+              if (ret < 0)
+                {
+                  nwarn("WARNING: Failed to cut TX packet, dropping: %d\n",
+                        ret);
+                  iob_free_chain(gso.pkt);
+                  break;
+                }
+
+              netdev_upper_queue_tx(dev);
+            }
+
+          return;
+        }
+    }
+#endif
+
+  /* The checksum state is not kept for queued packets */
+
+  netdev_csum_complete(dev);
+
+  if ((ret = iob_tryadd_queue(dev->d_iob, &upper->txq)) >= 0)
+    {
+      netdev_iob_clear(dev);
+    }
+  else
+    {
+      nwarn("WARNING: Failed to queue TX packet, dropping: %d\n", ret);
+    }
+#else
+  /* Fall back to send the packet directly if we don't have IOB queue. */
+
+  netdev_upper_txpoll(dev);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: eth_input
+ *
+ * Description:
+ *   Handle L2 packet input.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX network driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+static void eth_input(FAR struct net_driver_s *dev)
+{
+  FAR struct eth_hdr_s *eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
+
+  /* Check if this is an 802.1Q VLAN tagged packet */
+
+  if (eth_hdr->type == HTONS(TPID_8021QVLAN))
+    {
+      /* Need to remove the 4 octet VLAN Tag, by moving src and dest
+       * addresses 4 octets to the right, and then read the actual
+       * ethertype. The VLAN ID and priority fields are currently
+       * ignored.
+       */
+
+      memmove((FAR uint8_t *)eth_hdr + 4, eth_hdr,
+              offsetof(struct eth_hdr_s, type));
+      dev->d_iob  = iob_trimhead(dev->d_iob, 4);
+      dev->d_len -= 4;
+
+      eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
+    }
+
+  /* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv4
+  if (eth_hdr->type == HTONS(ETHTYPE_IP))
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(dev);
+
+      /* Receive an IPv4 packet from the network device */
+
+      ipv4_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (eth_hdr->type == HTONS(ETHTYPE_IP6))
+    {
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(dev);
+
+      /* Give the IPv6 packet to the network layer */
+
+      ipv6_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_ARP
+  if (eth_hdr->type == HTONS(ETHTYPE_ARP))
+    {
+      ninfo("ARP frame\n");
+      NETDEV_RXARP(dev);
+
+      /* Handle ARP packet */
+
+      arp_input(dev);
+    }
+  else
+#endif
+    {
+      ninfo("INFO: Dropped, Unknown type: %04x\n", eth_hdr->type);
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+    }
+
+  /* If the above function invocation resulted in data
+   * that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ip_input
+ *
+ * Description:
+ *   Handle L3 packet input.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX network driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MBIM
+static void ip_input(FAR struct net_driver_s *dev)
+{
+  /* We only accept IP packets of the configured type */
+
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(dev);
+
+      /* Receive an IPv4 packet from the network device */
+
+      ipv4_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(dev);
+
+      /* Give the IPv6 packet to the network layer */
+
+      ipv6_input(dev);
+    }
+  else
+#endif
+    {
+      ninfo("INFO: Dropped, Unknown type\n");
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+    }
+
+  /* If the above function invocation resulted in data
+   * that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_input
+ *
+ * Description:
+ *   Pass the received packet in d_iob to the network stack according to
+ *   the link layer type of the device.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX network driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_input(FAR struct net_driver_s *dev)
+{
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_LOOPBACK
+    case NET_LL_LOOPBACK:
+#endif
+#ifdef CONFIG_NET_ETHERNET
+    case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+    case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+      eth_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_MBIM
+    case NET_LL_MBIM:
+      ip_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_CAN
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+}
+
+#ifdef CONFIG_NETDEV_GRO
+/****************************************************************************
+ * Name: netdev_upper_gro_relay
+ *
+ * Description:
+ *   Relay a packet taken by GRO back to dev, without touching the quota.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_gro_relay(FAR struct net_driver_s *dev,
+                                   FAR netpkt_t *pkt)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+
+  netdev_iob_release(dev);
+  dev->d_iob = pkt;
+  dev->d_len = netpkt_getdatalen(upper->lower, pkt);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_csum_add
+ *
+ * Description:
+ *   Add two 16-bit one's complement sums.
+ *
+ ****************************************************************************/
+
+static inline uint16_t netdev_upper_gro_csum_add(uint16_t a, uint16_t b)
+{
+  uint32_t sum = (uint32_t)a + b;
+
+  return (uint16_t)((sum & 0xffff) + (sum >> 16));
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_seqno
+ *
+ * Description:
+ *   Get the sequence number of a TCP header in host order.
+ *
+ ****************************************************************************/
+
+static inline uint32_t netdev_upper_gro_seqno(FAR const uint8_t *seqno)
+{
+  return ((uint32_t)seqno[0] << 24) | ((uint32_t)seqno[1] << 16) |
+         ((uint32_t)seqno[2] << 8) | seqno[3];
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_hdrsum
+ *
+ * Description:
+ *   Sum the TCP pseudo header and the TCP header (including the checksum
+ *   field) of a packet.
+ *
+ * Input Parameters:
+ *   ip       - The IP header of the packet
+ *   iphdrlen - Length of the IP header
+ *   hdrlen   - Length of the IP and TCP headers
+ *   iplen    - Length of the IP packet
+ *
+ * Returned Value:
+ *   The 16-bit one's complement sum in host order.
+ *
+ ****************************************************************************/
+
+static uint16_t netdev_upper_gro_hdrsum(FAR const uint8_t *ip,
+                                        uint16_t iphdrlen, uint16_t hdrlen,
+                                        uint16_t iplen)
+{
+  uint16_t sum = iplen - iphdrlen + IP_PROTO_TCP;
+
+#ifdef CONFIG_NET_IPv4
+  if ((*ip & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR const struct ipv4_hdr_s *ipv4 = (FAR const struct ipv4_hdr_s *)ip;
+
+      sum = chksum(sum, (FAR const uint8_t *)ipv4->srcipaddr,
+                   2 * sizeof(in_addr_t));
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if ((*ip & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR const struct ipv6_hdr_s *ipv6 = (FAR const struct ipv6_hdr_s *)ip;
+
+      sum = chksum(sum, (FAR const uint8_t *)ipv6->srcipaddr,
+                   2 * sizeof(net_ipv6addr_t));
+    }
+#endif
+
+  return chksum(sum, ip + iphdrlen, hdrlen - iphdrlen);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_parse
+ *
+ * Description:
+ *   Check if a received packet is a TCP segment that GRO can merge: an
+ *   Ethernet frame with an IPv4 header without options or fragmentation
+ *   or an IPv6 header without extension headers, the IP and TCP headers
+ *   in the first buffer, only ACK (and PSH) set and some payload.  The
+ *   Ethernet padding of the frame is trimmed.
+ *
+ * Input Parameters:
+ *   dev      - Reference to the NuttX network driver state structure
+ *   pkt      - The received packet
+ *   iphdrlen - Location to return the length of the IP header
+ *
+ * Returned Value:
+ *   The length of the IP and TCP headers, zero if it can't be merged.
+ *
+ ****************************************************************************/
+
+static uint16_t netdev_upper_gro_parse(FAR struct net_driver_s *dev,
+                                       FAR netpkt_t *pkt,
+                                       FAR uint16_t *iphdrlen)
+{
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  FAR struct eth_hdr_s *eth;
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t hdrlen;
+  uint16_t iplen = 0;
+
+  if (dev->d_lltype != NET_LL_ETHERNET)
+    {
+      return 0;
+    }
+
+  eth = (FAR struct eth_hdr_s *)(ip - NET_LL_HDRLEN(dev));
+
+#ifdef CONFIG_NET_IPv4
+  if (eth->type == HTONS(ETHTYPE_IP) && pkt->io_len >= IPv4_HDRLEN)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+      uint16_t ipoffset = ((uint16_t)ipv4->ipoffset[0] << 8) +
+                          ipv4->ipoffset[1];
+
+      if (ipv4->vhl != (IPv4_VERSION | (IPv4_HDRLEN >> 2)) ||
+          ipv4->proto != IP_PROTO_TCP ||
+          (ipoffset & ~IP_FLAG_DONTFRAG) != 0)
+        {
+          return 0;
+        }
+
+#ifdef CONFIG_NET_IPV4_CHECKSUMS
+      /* The IPv4 header is rebuilt for the merged packet, so check it
+       * here instead of leaving it to ipv4_input().
+       */
+
+      if (ipv4_chksum(ipv4) != 0xffff)
+        {
+          return 0;
+        }
+#endif
+
+      *iphdrlen = IPv4_HDRLEN;
+      iplen     = ((uint16_t)ipv4->len[0] << 8) + ipv4->len[1];
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (eth->type == HTONS(ETHTYPE_IP6) && pkt->io_len >= IPv6_HDRLEN)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      if ((ipv6->vtc & IP_VERSION_MASK) != IPv6_VERSION ||
+          ipv6->proto != IP_PROTO_TCP)
+        {
+          return 0;
+        }
+
+      *iphdrlen = IPv6_HDRLEN;
+      iplen     = IPv6_HDRLEN + ((uint16_t)ipv6->len[0] << 8) +
+                  ipv6->len[1];
+    }
+#endif
+
+  if (iplen == 0 || iplen > pkt->io_pktlen ||
+      *iphdrlen + TCP_HDRLEN > pkt->io_len)
+    {
+      return 0;
+    }
+
+  tcp    = (FAR struct tcp_hdr_s *)(ip + *iphdrlen);
+  hdrlen = *iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+
+  if (hdrlen < *iphdrlen + TCP_HDRLEN || hdrlen > pkt->io_len ||
+      hdrlen >= iplen || (tcp->flags & ~TCP_PSH) != TCP_ACK)
+    {
+      return 0;
+    }
+
+  /* Drop the Ethernet padding of short frames */
+
+  if (pkt->io_pktlen > iplen)
+    {
+      iob_update_pktlen(pkt, iplen, false);
+    }
+
+  return hdrlen;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_match
+ *
+ * Description:
+ *   Check if a TCP segment continues the merged packet: the same flow, the
+ *   next sequence number and the same IP and TCP headers otherwise.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro_match(FAR struct netdev_gro_s *gro,
+                                   FAR netpkt_t *pkt, uint16_t hdrlen)
+{
+  FAR uint8_t *held = IOB_DATA(gro->pkt);
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  FAR struct tcp_hdr_s *htcp;
+  FAR struct tcp_hdr_s *tcp;
+
+  if (hdrlen != gro->hdrlen || *ip != *held ||
+      gro->iplen + pkt->io_pktlen - hdrlen > CONFIG_NETDEV_GRO_MAXSIZE)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((*ip & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+      FAR struct ipv4_hdr_s *hipv4 = (FAR struct ipv4_hdr_s *)held;
+
+      if (ipv4->tos != hipv4->tos || ipv4->ttl != hipv4->ttl ||
+          ipv4->ipoffset[0] != hipv4->ipoffset[0] ||
+          memcmp(ipv4->srcipaddr, hipv4->srcipaddr,
+                 2 * sizeof(in_addr_t)) != 0)
+        {
+          return false;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if ((*ip & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+      FAR struct ipv6_hdr_s *hipv6 = (FAR struct ipv6_hdr_s *)held;
+
+      if (memcmp(ipv6, hipv6, offsetof(struct ipv6_hdr_s, len)) != 0 ||
+          ipv6->ttl != hipv6->ttl ||
+          memcmp(ipv6->srcipaddr, hipv6->srcipaddr,
+                 2 * sizeof(net_ipv6addr_t)) != 0)
+        {
+          return false;
+        }
+    }
+#endif
+
+  tcp  = (FAR struct tcp_hdr_s *)(ip + gro->iphdrlen);
+  htcp = (FAR struct tcp_hdr_s *)(held + gro->iphdrlen);
+
+  return tcp->srcport == htcp->srcport &&
+         tcp->destport == htcp->destport &&
+         netdev_upper_gro_seqno(tcp->seqno) == gro->seqno &&
+         memcmp(tcp->ackno, htcp->ackno, sizeof(tcp->ackno)) == 0 &&
+         memcmp(tcp->wnd, htcp->wnd, sizeof(tcp->wnd)) == 0 &&
+         memcmp(tcp->optdata, htcp->optdata,
+                hdrlen - gro->iphdrlen - TCP_HDRLEN) == 0;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_flush
  *
  * Description:
- *   Queue a TX packet to the upper half for sending later.
+ *   Pass the merged packet (if any) to the network stack, after fixing up
+ *   its IP length and checksums.  Whatever is left in d_iob is released.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
+ *   dev - Reference to the NuttX network driver state structure
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211) || defined(CONFIG_NET_MBIM)
-static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
+static void netdev_upper_gro_flush(FAR struct net_driver_s *dev)
 {
-#if CONFIG_IOB_NCHAINS > 0
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
-  int ret;
+  FAR struct netdev_gro_s *gro = &upper->gro;
+  FAR netpkt_t *pkt = gro->pkt;
+  FAR uint8_t *ip;
+  uint16_t len;
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t sum;
+#endif
 
-  if ((ret = iob_tryadd_queue(dev->d_iob, &upper->txq)) >= 0)
+  if (pkt == NULL)
     {
-      netdev_iob_clear(dev);
+      return;
     }
-  else
+
+  gro->pkt = NULL;
+
+  if (gro->nsegs > 1)
     {
-      nwarn("WARNING: Failed to queue TX packet, dropping: %d\n", ret);
+      ip = IOB_DATA(pkt);
+
+#ifdef CONFIG_NET_IPv4
+      if ((*ip & IP_VERSION_MASK) == IPv4_VERSION)
+        {
+          FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+          len            = gro->iplen;
+          ipv4->len[0]   = len >> 8;
+          ipv4->len[1]   = len & 0xff;
+          ipv4->ipchksum = 0;
+          ipv4->ipchksum = ~(ipv4_chksum(ipv4));
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      if ((*ip & IP_VERSION_MASK) == IPv6_VERSION)
+        {
+          FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+          len            = gro->iplen - IPv6_HDRLEN;
+          ipv6->len[0]   = len >> 8;
+          ipv6->len[1]   = len & 0xff;
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      /* The TCP checksum is built from the payload sums of the segments,
+       * so a corrupted segment still fails the check in tcp_input().
+       */
+
+      tcp = (FAR struct tcp_hdr_s *)(ip + gro->iphdrlen);
+      tcp->tcpchksum = 0;
+
+      sum = netdev_upper_gro_hdrsum(ip, gro->iphdrlen, gro->hdrlen,
+                                    gro->iplen);
+      sum = netdev_upper_gro_csum_add(sum, gro->sum);
+      tcp->tcpchksum = HTONS((uint16_t)~sum);
+#endif
+
+      NETDEV_RXGROPACKETS(dev);
     }
-#else
-  /* Fall back to send the packet directly if we don't have IOB queue. */
 
-  netdev_upper_txpoll(dev);
+  netdev_upper_gro_relay(dev, pkt);
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  if (gro->verified)
+    {
+      dev->d_csumstate = NETDEV_CSUM_VERIFIED;
+    }
 #endif
+
+  netdev_upper_input(dev);
 }
-#endif
 
 /****************************************************************************
- * Name: eth_input
+ * Name: netdev_upper_gro_receive
  *
  * Description:
- *   Handle L2 packet input.
+ *   Try to merge the received packet in d_iob with the TCP segments before
+ *   it.  Packets that can't be merged flush the merged packet first, so the
+ *   order of the packets is kept.
  *
  * Input Parameters:
  *   dev - Reference to the NuttX network driver state structure
  *
+ * Returned Value:
+ *   True if the packet is taken by GRO, false if it is still in d_iob and
+ *   should be passed to the network stack by the caller.
+ *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-static void eth_input(FAR struct net_driver_s *dev)
+static bool netdev_upper_gro_receive(FAR struct net_driver_s *dev)
 {
-  FAR struct eth_hdr_s *eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_gro_s *gro = &upper->gro;
+  FAR netpkt_t *pkt = dev->d_iob;
+  FAR struct tcp_hdr_s *tcp;
+  FAR uint8_t *ip;
+  uint16_t iphdrlen;
+  uint16_t hdrlen;
+  uint16_t paylen;
+  uint16_t sum = 0;
+  uint8_t flags;
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  bool verified = netdev_csum_valid(dev);
+#endif
 
-  /* Check if this is an 802.1Q VLAN tagged packet */
+  hdrlen = netdev_upper_gro_parse(dev, pkt, &iphdrlen);
 
-  if (eth_hdr->type == HTONS(TPID_8021QVLAN))
-    {
-      /* Need to remove the 4 octet VLAN Tag, by moving src and dest
-       * addresses 4 octets to the right, and then read the actual
-       * ethertype. The VLAN ID and priority fields are currently
-       * ignored.
-       */
+  netdev_iob_clear(dev);
 
-      memmove((FAR uint8_t *)eth_hdr + 4, eth_hdr,
-              offsetof(struct eth_hdr_s, type));
-      dev->d_iob  = iob_trimhead(dev->d_iob, 4);
-      dev->d_len -= 4;
+  if (hdrlen == 0)
+    {
+      netdev_upper_gro_flush(dev);
+      netdev_upper_gro_relay(dev, pkt);
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      if (verified)
+        {
+          dev->d_csumstate = NETDEV_CSUM_VERIFIED;
+        }
+#endif
 
-      eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
+      return false;
     }
 
-  /* We only accept IP packets of the configured type and ARP packets */
-
-#ifdef CONFIG_NET_IPv4
-  if (eth_hdr->type == HTONS(ETHTYPE_IP))
-    {
-      ninfo("IPv4 frame\n");
-      NETDEV_RXIPV4(dev);
+  ip     = IOB_DATA(pkt);
+  tcp    = (FAR struct tcp_hdr_s *)(ip + iphdrlen);
+  flags  = tcp->flags;
+  paylen = pkt->io_pktlen - hdrlen;
 
-      /* Receive an IPv4 packet from the network device */
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  /* A valid segment sums up to 0xffff, so the payload sums up to the
+   * one's complement of the pseudo header and TCP header sum.
+   */
 
-      ipv4_input(dev);
-    }
-  else
+  sum = ~netdev_upper_gro_hdrsum(ip, iphdrlen, hdrlen, pkt->io_pktlen);
 #endif
-#ifdef CONFIG_NET_IPv6
-  if (eth_hdr->type == HTONS(ETHTYPE_IP6))
+
+  if (gro->pkt != NULL && netdev_upper_gro_match(gro, pkt, hdrlen))
     {
-      ninfo("IPv6 frame\n");
-      NETDEV_RXIPV6(dev);
+      /* The payload lands at an odd offset, swap the bytes of its sum */
 
-      /* Give the IPv6 packet to the network layer */
+      if (((gro->iplen - gro->hdrlen) & 1) != 0)
+        {
+          sum = (uint16_t)((sum << 8) | (sum >> 8));
+        }
 
-      ipv6_input(dev);
-    }
-  else
+      gro->sum    = netdev_upper_gro_csum_add(gro->sum, sum);
+      gro->iplen += paylen;
+      gro->seqno += paylen;
+      gro->nsegs++;
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      gro->verified &= verified;
 #endif
-#ifdef CONFIG_NET_ARP
-  if (eth_hdr->type == HTONS(ETHTYPE_ARP))
-    {
-      ninfo("ARP frame\n");
-      NETDEV_RXARP(dev);
 
-      /* Handle ARP packet */
+      ((FAR struct tcp_hdr_s *)(IOB_DATA(gro->pkt) + iphdrlen))->flags |=
+        flags;
 
-      arp_input(dev);
+      iob_concat(gro->pkt, iob_trimhead(pkt, hdrlen));
+      NETDEV_RXGROMERGED(dev);
     }
   else
-#endif
     {
-      ninfo("INFO: Dropped, Unknown type: %04x\n", eth_hdr->type);
-      NETDEV_RXDROPPED(dev);
-      dev->d_len = 0;
+      /* Start a new merged packet from this segment */
+
+      netdev_upper_gro_flush(dev);
+
+      gro->pkt      = pkt;
+      gro->seqno    = netdev_upper_gro_seqno(tcp->seqno) + paylen;
+      gro->hdrlen   = hdrlen;
+      gro->iphdrlen = iphdrlen;
+      gro->iplen    = pkt->io_pktlen;
+      gro->sum      = sum;
+      gro->nsegs    = 1;
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      gro->verified = verified;
+#endif
     }
 
-  /* If the above function invocation resulted in data
-   * that should be sent out on the network,
-   * the field d_len will set to a value > 0.
-   */
+  /* The sender pushed its data, don't wait for more */
 
-  if (dev->d_len > 0)
+  if ((flags & TCP_PSH) != 0)
     {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
-       */
-
-      netdev_upper_queue_tx(dev);
+      netdev_upper_gro_flush(dev);
     }
+
+  return true;
 }
-#endif
+#endif /* CONFIG_NETDEV_GRO */
 
 /****************************************************************************
- * Name: ip_input
+ * Name: netdev_upper_receive
  *
  * Description:
- *   Handle L3 packet input.
+ *   Get the next received packet from the lower half.  With checksum
+ *   offload the lower half may mark it verified by netpkt_setcsumvalid(),
+ *   which is honoured only while RX checksum offload is enabled.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX network driver state structure
+ *   lower - The lower half device driver structure
+ *
+ * Returned Value:
+ *   The received packet, NULL if there is none.
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_MBIM
-static void ip_input(FAR struct net_driver_s *dev)
+static FAR netpkt_t *
+netdev_upper_receive(FAR struct netdev_lowerhalf_s *lower)
 {
-  /* We only accept IP packets of the configured type */
-
-#ifdef CONFIG_NET_IPv4
-  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
-    {
-      ninfo("IPv4 frame\n");
-      NETDEV_RXIPV4(dev);
-
-      /* Receive an IPv4 packet from the network device */
-
-      ipv4_input(dev);
-    }
-  else
-#endif
-#ifdef CONFIG_NET_IPv6
-  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
-    {
-      ninfo("IPv6 frame\n");
-      NETDEV_RXIPV6(dev);
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  FAR struct net_driver_s *dev = &lower->netdev;
+  FAR netpkt_t *pkt;
 
-      /* Give the IPv6 packet to the network layer */
+  dev->d_csumstate = NETDEV_CSUM_NONE;
+  pkt = lower->ops->receive(lower);
 
-      ipv6_input(dev);
-    }
-  else
-#endif
+  if ((dev->d_csumcap & NETDEV_CSUM_RX) == 0)
     {
-      ninfo("INFO: Dropped, Unknown type\n");
-      NETDEV_RXDROPPED(dev);
-      dev->d_len = 0;
+      dev->d_csumstate = NETDEV_CSUM_NONE;
     }
 
-  /* If the above function invocation resulted in data
-   * that should be sent out on the network,
-   * the field d_len will set to a value > 0.
-   */
-
-  if (dev->d_len > 0)
-    {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
-       */
-
-      netdev_upper_queue_tx(dev);
-    }
-}
+  return pkt;
+#else
+  return lower->ops->receive(lower);
 #endif
+}
 
 /****************************************************************************
  * Function: netdev_upper_rxpoll_work
@@ -606,7 +1619,7 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
 
   /* Loop while receive() successfully retrieves valid Ethernet frames. */
 
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  while ((pkt = netdev_upper_receive(lower)) != NULL)
     {
       if (!IFF_IS_UP(dev->d_flags))
         {
@@ -626,38 +1639,23 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
       pkt_input(dev);
 #endif
 
-      switch (dev->d_lltype)
+#ifdef CONFIG_NETDEV_GRO
+      /* Hold TCP segments back to merge them with the following ones */
+
+      if (upper->gro.enabled && netdev_upper_gro_receive(dev))
         {
-#ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
-#endif
-#ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
-#endif
-#ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
-#endif
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
-#endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
+          continue;
         }
+#endif
+
+      netdev_upper_input(dev);
     }
+
+#ifdef CONFIG_NETDEV_GRO
+  /* Nothing is held across batches, pass the merged packet on now */
+
+  netdev_upper_gro_flush(dev);
+#endif
 }
 
 /****************************************************************************
@@ -1100,6 +2098,16 @@ static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
   work_cancel(NETDEV_WORK, &upper->work);
 #endif
 
+#ifdef CONFIG_NETDEV_GSO
+  /* Drop the rest of a GSO packet, TCP will retransmit it */
+
+  if (upper->gso.pkt != NULL)
+    {
+      iob_free_chain(upper->gso.pkt);
+      upper->gso.pkt = NULL;
+    }
+#endif
+
   if (upper->lower->ops->ifdown)
     {
       return upper->lower->ops->ifdown(upper->lower);
@@ -1156,6 +2164,62 @@ static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
     }
 #endif
 
+#if defined(CONFIG_NETDEV_GRO) || defined(CONFIG_NETDEV_CSUM_OFFLOAD)
+  if (cmd == SIOCETHTOOL && arg != 0)
+    {
+      FAR struct ethtool_value *value = (FAR struct ethtool_value *)arg;
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      uint8_t cap;
+#endif
+
+      switch (value->cmd)
+        {
+#ifdef CONFIG_NETDEV_GRO
+          case ETHTOOL_GGRO: /* Get GRO enable */
+            value->data = upper->gro.enabled;
+            return OK;
+
+          case ETHTOOL_SGRO: /* Set GRO enable */
+            upper->gro.enabled = value->data != 0;
+            return OK;
+#endif
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+          case ETHTOOL_GTXCSUM: /* Get TX hw csum enable */
+            value->data = (dev->d_csumcap & NETDEV_CSUM_TX) != 0;
+            return OK;
+
+          case ETHTOOL_GRXCSUM: /* Get RX hw csum enable */
+            value->data = (dev->d_csumcap & NETDEV_CSUM_RX) != 0;
+            return OK;
+
+          case ETHTOOL_STXCSUM: /* Set TX hw csum enable */
+          case ETHTOOL_SRXCSUM: /* Set RX hw csum enable */
+            cap = value->cmd == ETHTOOL_STXCSUM ?
+                  NETDEV_CSUM_TX : NETDEV_CSUM_RX;
+
+            if (value->data == 0)
+              {
+                dev->d_csumcap &= ~cap;
+              }
+            else if ((netdev_upper_csumcap(lower) & cap) != 0)
+              {
+                dev->d_csumcap |= cap;
+              }
+            else
+              {
+                return -EOPNOTSUPP;
+              }
+
+            return OK;
+#endif
+
+          default:
+            break;
+        }
+    }
+#endif
+
   if (lower->ops->ioctl)
     {
       return lower->ops->ioctl(lower, cmd, arg);
@@ -1217,6 +2281,18 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
   dev->netdev.d_ioctl   = netdev_upper_ioctl;
 #endif
   dev->netdev.d_private = upper;
+#ifdef CONFIG_NETDEV_GSO
+  if (dev->netdev.d_gsomax == 0)
+    {
+      dev->netdev.d_gsomax = CONFIG_NETDEV_GSO_MAXSIZE;
+    }
+#endif
+#ifdef CONFIG_NETDEV_GRO
+  upper->gro.enabled    = true;
+#endif
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  dev->netdev.d_csumcap = netdev_upper_csumcap(dev);
+#endif
 
   ret = netdev_register(&dev->netdev, lltype);
   if (ret < 0)
@@ -1292,6 +2368,13 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
   iob_free_queue(&upper->txq);
 #endif
 
+#ifdef CONFIG_NETDEV_GSO
+  if (upper->gso.pkt != NULL)
+    {
+      iob_free_chain(upper->gso.pkt);
+    }
+#endif
+
   kmm_free(upper);
   dev->netdev.d_private = NULL;
 
@@ -1625,3 +2708,56 @@ int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
 
   return i;
 }
+
+/****************************************************************************
+ * Name: netpkt_getcsumstart
+ *
+ * Description:
+ *   Get where the checksum of a packet marked by netpkt_is_csumpartial()
+ *   has to be computed: The sum runs from the returned offset to the end
+ *   of the packet and is stored at *offset bytes after it.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *   offset - Returns the offset of the checksum field from the start
+ *
+ * Returned Value:
+ *   The offset of the TCP or UDP header from the start of the link layer
+ *   header, see netpkt_getdata().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+unsigned int netpkt_getcsumstart(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt,
+                                 FAR unsigned int *offset)
+{
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  unsigned int iphdrlen;
+  uint8_t proto;
+
+#ifdef CONFIG_NET_IPv4
+  if ((*ip & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      iphdrlen = (*ip & IPv4_HLMASK) << 2;
+      proto    = ((FAR struct ipv4_hdr_s *)ip)->proto;
+    }
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv6
+      iphdrlen = IPv6_HDRLEN;
+      proto    = ((FAR struct ipv6_hdr_s *)ip)->proto;
+#else
+      iphdrlen = 0;
+      proto    = 0;
+#endif
+    }
+
+  *offset = proto == IP_PROTO_TCP ? offsetof(struct tcp_hdr_s, tcpchksum) :
+                                    offsetof(struct udp_hdr_s, udpchksum);
+
+  return NET_LL_HDRLEN(&dev->netdev) + iphdrlen;
+}
+#endif
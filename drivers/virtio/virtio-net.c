@@ -33,6 +33,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
 
@@ -44,7 +45,18 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM       0
+#define VIRTIO_NET_F_GUEST_CSUM 1
+#define VIRTIO_NET_F_MAC        5
+#define VIRTIO_NET_F_HOST_TSO4  11
+#define VIRTIO_NET_F_HOST_TSO6  12
+
+/* Virtio net header flags and GSO types */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM 1
+#define VIRTIO_NET_HDR_F_DATA_VALID 2
+#define VIRTIO_NET_HDR_GSO_TCPV4    1
+#define VIRTIO_NET_HDR_GSO_TCPV6    4
 
 /* Virtio net header size and packet buffer size */
 
@@ -63,6 +75,18 @@
 #define VIRTIO_NET_MAX_NIOB \
     ((VIRTIO_NET_MAX_PKT_SIZE + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
 
+/* A TSO packet may span more buffers than a normal packet */
+
+#ifdef CONFIG_NETDEV_GSO
+#  define VIRTIO_NET_MAX_TSO_NIOB \
+     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN + CONFIG_NETDEV_GSO_MAXSIZE + \
+       CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
+#  define VIRTIO_NET_MAX_TX_NIOB \
+     MAX(VIRTIO_NET_MAX_NIOB, VIRTIO_NET_MAX_TSO_NIOB)
+#else
+#  define VIRTIO_NET_MAX_TX_NIOB VIRTIO_NET_MAX_NIOB
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -117,7 +141,15 @@ struct virtio_net_priv_s
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
-  int                       bufnum;    /* TX and RX Buffer number */
+  int                       bufnum;    /* RX Buffer number */
+  int                       txbufnum;  /* TX Buffer number */
+
+  /* TX buffer descriptors, a TSO packet may need too many of them for the
+   * stack.  The transmission is serialized by the upper half.
+   */
+
+  struct virtqueue_buf      txvb[VIRTIO_NET_MAX_TX_NIOB + 1];
+  struct iovec              txiov[VIRTIO_NET_MAX_TX_NIOB];
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -205,6 +237,136 @@ static uint8_t g_netdev_num = 0;
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NETDEV_GSO
+/****************************************************************************
+ * Name: virtio_net_tsohdr
+ *
+ * Description:
+ *   Fill the virtio net header of a TCP packet that the device has to cut
+ *   into segments.  The device also computes the TCP checksum of each
+ *   segment, starting from the pseudo-header sum stored in the packet.
+ *
+ ****************************************************************************/
+
+static void virtio_net_tsohdr(FAR struct netdev_lowerhalf_s *dev,
+                              FAR netpkt_t *pkt,
+                              FAR struct virtio_net_hdr_s *vhdr)
+{
+  FAR uint8_t *ip = netpkt_getdata(dev, pkt) + NET_LL_HDRLEN(&dev->netdev);
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int iphdrlen;
+  uint16_t sum;
+
+#ifdef CONFIG_NET_IPv4
+  if ((*ip & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      iphdrlen       = (ipv4->vhl & IPv4_HLMASK) << 2;
+      vhdr->gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+      sum            = chksum(IP_PROTO_TCP, (FAR uint8_t *)ipv4->srcipaddr,
+                              2 * sizeof(in_addr_t));
+    }
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv6
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      iphdrlen       = IPv6_HDRLEN;
+      vhdr->gso_type = VIRTIO_NET_HDR_GSO_TCPV6;
+      sum            = chksum(IP_PROTO_TCP, (FAR uint8_t *)ipv6->srcipaddr,
+                              2 * sizeof(net_ipv6addr_t));
+#else
+      return;
+#endif
+    }
+
+  /* Replace the checksum with the pseudo-header sum without the length,
+   * the device adds the length and the payload of each segment.
+   */
+
+  tcp            = (FAR struct tcp_hdr_s *)(ip + iphdrlen);
+  tcp->tcpchksum = HTONS(sum);
+
+  vhdr->flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  vhdr->csum_start  = NET_LL_HDRLEN(&dev->netdev) + iphdrlen;
+  vhdr->csum_offset = offsetof(struct tcp_hdr_s, tcpchksum);
+  vhdr->hdr_len     = vhdr->csum_start + ((tcp->tcpoffset >> 4) << 2);
+  vhdr->gso_size    = netpkt_getgsosize(dev, pkt);
+}
+#endif
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+/****************************************************************************
+ * Name: virtio_net_csumhdr
+ *
+ * Description:
+ *   Fill the virtio net header of a TCP or UDP packet whose checksum the
+ *   device has to complete, starting from the pseudo-header sum stored in
+ *   the packet.
+ *
+ ****************************************************************************/
+
+static void virtio_net_csumhdr(FAR struct netdev_lowerhalf_s *dev,
+                               FAR netpkt_t *pkt,
+                               FAR struct virtio_net_hdr_s *vhdr)
+{
+  unsigned int offset;
+
+  vhdr->flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  vhdr->csum_start  = netpkt_getcsumstart(dev, pkt, &offset);
+  vhdr->csum_offset = offset;
+}
+
+/****************************************************************************
+ * Name: virtio_net_rxcsum
+ *
+ * Description:
+ *   Handle the checksum flags of a received packet.  DATA_VALID means the
+ *   device has checked the checksum.  NEEDS_CSUM comes with packets from
+ *   the host or other guests that were never checksummed, complete the
+ *   checksum here so the packet is valid if it is forwarded.
+ *
+ ****************************************************************************/
+
+static void virtio_net_rxcsum(FAR struct netdev_lowerhalf_s *dev,
+                              FAR netpkt_t *pkt,
+                              FAR struct virtio_net_hdr_s *vhdr)
+{
+  unsigned int llhdrlen = NET_LL_HDRLEN(&dev->netdev);
+  uint8_t field[2];
+  uint16_t sum;
+
+  if ((vhdr->flags & VIRTIO_NET_HDR_F_NEEDS_CSUM) != 0)
+    {
+      if (vhdr->csum_start < llhdrlen ||
+          vhdr->csum_start + vhdr->csum_offset + 2 >
+          pkt->io_pktlen + llhdrlen)
+        {
+          return;
+        }
+
+      /* The checksum field may be in any buffer of the chain */
+
+      sum      = ~chksum_iob(0, pkt, vhdr->csum_start - llhdrlen);
+      field[0] = sum >> 8;
+      field[1] = sum & 0xff;
+      if (iob_trycopyin(pkt, field, 2, vhdr->csum_start +
+                        vhdr->csum_offset - llhdrlen, false) != 2)
+        {
+          return;
+        }
+    }
+  else if ((vhdr->flags & VIRTIO_NET_HDR_F_DATA_VALID) == 0)
+    {
+      return;
+    }
+
+  netpkt_setcsumvalid(dev, pkt);
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_addbuffer
  ****************************************************************************/
@@ -215,14 +377,24 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
   FAR struct virtio_net_llhdr_s *hdr;
-  struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
-  struct iovec iov[VIRTIO_NET_MAX_NIOB];
+  struct virtqueue_buf rxvb[VIRTIO_NET_MAX_NIOB + 1];
+  struct iovec rxiov[VIRTIO_NET_MAX_NIOB];
+  FAR struct virtqueue_buf *vb = rxvb;
+  FAR struct iovec *iov = rxiov;
+  int iov_max = VIRTIO_NET_MAX_NIOB;
   int iov_cnt;
   int i;
 
+  if (vq_id == VIRTIO_NET_TX)
+    {
+      vb      = priv->txvb;
+      iov     = priv->txiov;
+      iov_max = VIRTIO_NET_MAX_TX_NIOB;
+    }
+
   /* Convert netpkt to virtqueue_buf */
 
-  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_NIOB);
+  iov_cnt = netpkt_to_iov(dev, pkt, iov, iov_max);
 
   /* Alloc cookie and net header from transport layer */
 
@@ -232,6 +404,21 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
   memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
   hdr->pkt = pkt;
 
+#ifdef CONFIG_NETDEV_GSO
+  if (vq_id == VIRTIO_NET_TX && netpkt_getgsosize(dev, pkt) > 0)
+    {
+      virtio_net_tsohdr(dev, pkt, &hdr->vhdr);
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  if (vq_id == VIRTIO_NET_TX && netpkt_getgsosize(dev, pkt) == 0 &&
+      netpkt_is_csumpartial(dev, pkt))
+    {
+      virtio_net_csumhdr(dev, pkt, &hdr->vhdr);
+    }
+#endif
+
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
 
   if (virtio_has_feature(priv->vdev, VIRTIO_F_ANY_LAYOUT))
@@ -241,7 +428,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       vb[0].buf = &hdr->vhdr;
       vb[0].len = iov[0].iov_len + VIRTIO_NET_HDRSIZE;
 
-#if VIRTIO_NET_MAX_NIOB > 1
+#if VIRTIO_NET_MAX_TX_NIOB > 1
       for (i = 1; i < iov_cnt; i++)
         {
           vb[i].buf = iov[i].iov_base;
@@ -426,7 +613,8 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Check the send length */
 
-  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE)
+  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE &&
+      netpkt_getgsosize(dev, pkt) == 0)
     {
       vrterr("net send buffer too large\n");
       return -EINVAL;
@@ -489,6 +677,10 @@ static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
   /* Set the received pkt length */
 
   netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  virtio_net_rxcsum(dev, hdr->pkt, &hdr->vhdr);
+#endif
+
   vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
   return hdr->pkt;
 }
@@ -560,6 +752,7 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 {
   FAR const char *vqnames[VIRTIO_NET_NUM];
   vq_callback callbacks[VIRTIO_NET_NUM];
+  uint64_t features;
   int ret;
 
   spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
@@ -570,8 +763,18 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
-                                  (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
+  features = (1UL << VIRTIO_NET_F_MAC) | (1UL << VIRTIO_F_ANY_LAYOUT);
+#ifdef CONFIG_NETDEV_GSO
+  features |= (1UL << VIRTIO_NET_F_CSUM) |
+              (1UL << VIRTIO_NET_F_HOST_TSO4) |
+              (1UL << VIRTIO_NET_F_HOST_TSO6);
+#endif
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  features |= (1UL << VIRTIO_NET_F_CSUM) |
+              (1UL << VIRTIO_NET_F_GUEST_CSUM);
+#endif
+
+  virtio_negotiate_features(vdev, features, NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
   vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
@@ -599,8 +802,53 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 #endif
   priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs /
                      (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+  priv->txbufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
+                       (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+
+#ifdef CONFIG_NETDEV_GSO
+  /* A TSO packet takes up to VIRTIO_NET_MAX_TSO_NIOB + 1 descriptors.
+   * Only offload the segmentation if the TX virtqueue still has room for
+   * a couple of them, the upper half segments in software otherwise.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CSUM) &&
+      vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
+      (VIRTIO_NET_MAX_TX_NIOB + 1) >= 2)
+    {
+      FAR struct netdev_lowerhalf_s *netdev =
+        (FAR struct netdev_lowerhalf_s *)priv;
+
+      if (virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO4))
+        {
+          netdev->features |= NETDEV_TX_TSO4;
+        }
+
+      if (virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO6))
+        {
+          netdev->features |= NETDEV_TX_TSO6;
+        }
+
+      if ((netdev->features & (NETDEV_TX_TSO4 | NETDEV_TX_TSO6)) != 0)
+        {
+          priv->txbufnum =
+            MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
+                (VIRTIO_NET_MAX_TX_NIOB + 1), priv->txbufnum);
+        }
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CSUM))
+    {
+      priv->lower.features |= NETDEV_TX_CSUM;
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_GUEST_CSUM))
+    {
+      priv->lower.features |= NETDEV_RX_CSUM;
+    }
+#endif
+
   return OK;
 }
 
@@ -669,7 +917,7 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
   netdev->quota[NETPKT_RX] = priv->bufnum;
-  netdev->quota[NETPKT_TX] = priv->bufnum;
+  netdev->quota[NETPKT_TX] = priv->txbufnum;
   netdev->ops = &g_virtio_net_ops;
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -65,7 +65,9 @@ extern const struct procfs_operations g_iobinfo_operations;
 extern const struct procfs_operations g_irq_operations;
 extern const struct procfs_operations g_meminfo_operations;
 extern const struct procfs_operations g_memdump_operations;
+extern const struct procfs_operations g_memfrag_operations;
 extern const struct procfs_operations g_mempool_operations;
+extern const struct procfs_operations g_memprof_operations;
 extern const struct procfs_operations g_module_operations;
 extern const struct procfs_operations g_pm_operations;
 extern const struct procfs_operations g_proc_operations;
@@ -73,6 +75,7 @@ extern const struct procfs_operations g_tcbinfo_operations;
 extern const struct procfs_operations g_thermal_operations;
 extern const struct procfs_operations g_uptime_operations;
 extern const struct procfs_operations g_version_operations;
+extern const struct procfs_operations g_wqueue_operations;
 extern const struct procfs_operations g_pressure_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
@@ -152,6 +155,9 @@ static const struct procfs_entry_s g_procfs_entries[] =
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
 #  ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMDUMP
   { "memdump",      &g_memdump_operations,  PROCFS_FILE_TYPE   },
+#  endif
+#  ifdef CONFIG_MM_HEAP_FRAGSTATS
+  { "memfrag",      &g_memfrag_operations,  PROCFS_FILE_TYPE   },
 #  endif
   { "meminfo",      &g_meminfo_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -160,6 +166,11 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "mempool",      &g_mempool_operations,  PROCFS_FILE_TYPE   },
 #endif
 
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO) && \
+    defined(CONFIG_MM_MEMPOOL_PROFILE)
+  { "memprof",      &g_memprof_operations,  PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_MODULE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   { "modules",      &g_module_operations,   PROCFS_FILE_TYPE   },
 #endif
@@ -208,6 +219,11 @@ static const struct procfs_entry_s g_procfs_entries[] =
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_VERSION
   { "version",      &g_version_operations,  PROCFS_FILE_TYPE   },
 #endif
+
+#if defined(CONFIG_SCHED_WORKQUEUE_STATS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_WQUEUE)
+  { "wqueue",       &g_wqueue_operations,   PROCFS_FILE_TYPE   },
+#endif
 };
 
 #ifdef CONFIG_FS_PROCFS_REGISTER
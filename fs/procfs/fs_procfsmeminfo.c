@@ -30,6 +30,7 @@
 #include <sys/stat.h>
 
 #include <stdint.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -40,11 +41,13 @@
 #include <debug.h>
 #include <ctype.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/pgalloc.h>
 #include <nuttx/progmem.h>
 #include <nuttx/sched.h>
 #include <nuttx/mm/mm.h>
+#include <nuttx/mm/mempool.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
 
@@ -106,6 +109,18 @@ static ssize_t memdump_read(FAR struct file *filep, FAR char *buffer,
 static ssize_t memdump_write(FAR struct file *filep, FAR const char *buffer,
                              size_t buflen);
 #endif
+#ifdef CONFIG_MM_HEAP_FRAGSTATS
+static ssize_t memfrag_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static ssize_t memfrag_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen);
+#endif
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+static ssize_t memprof_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static ssize_t memprof_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen);
+#endif
 static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
 static int     meminfo_dup(FAR const struct file *oldp,
@@ -153,6 +168,40 @@ const struct procfs_operations g_memdump_operations =
 };
 #endif
 
+#ifdef CONFIG_MM_HEAP_FRAGSTATS
+const struct procfs_operations g_memfrag_operations =
+{
+  meminfo_open,   /* open */
+  meminfo_close,  /* close */
+  memfrag_read,   /* read */
+  memfrag_write,  /* write */
+  NULL,           /* poll */
+  meminfo_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  meminfo_stat    /* stat */
+};
+#endif
+
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+const struct procfs_operations g_memprof_operations =
+{
+  meminfo_open,   /* open */
+  meminfo_close,  /* close */
+  memprof_read,   /* read */
+  memprof_write,  /* write */
+  NULL,           /* poll */
+  meminfo_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  meminfo_stat    /* stat */
+};
+#endif
+
 static FAR struct procfs_meminfo_entry_s *g_procfs_meminfo = NULL;
 
 /****************************************************************************
@@ -645,6 +694,376 @@ dump:
 }
 #endif
 
+/****************************************************************************
+ * Name: memfrag_percentile
+ *
+ * Description:
+ *   Get the upper bound (in nanoseconds) of the given percentile of a
+ *   latency histogram counted in perf counts.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_FRAGSTATS
+static unsigned long memfrag_percentile(FAR const unsigned long *hist,
+                                        unsigned int percent,
+                                        unsigned long freq)
+{
+  uint64_t total = 0;
+  uint64_t count = 0;
+  int i;
+
+  for (i = 0; i < MM_FRAG_NBUCKETS; i++)
+    {
+      total += hist[i];
+    }
+
+  if (total == 0 || freq == 0)
+    {
+      return 0;
+    }
+
+  for (i = 0; i < MM_FRAG_NBUCKETS - 1; i++)
+    {
+      count += hist[i];
+      if (count * 100 >= total * percent)
+        {
+          break;
+        }
+    }
+
+  return (unsigned long)((((uint64_t)1 << i) * NSEC_PER_SEC) / freq);
+}
+#endif
+
+/****************************************************************************
+ * Name: memfrag_copy
+ *
+ * Description:
+ *   Copy the formatted lines to the user buffer and advance it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_FRAGSTATS
+static size_t memfrag_copy(FAR struct meminfo_file_s *procfile,
+                           size_t linesize, FAR char **buffer,
+                           FAR size_t *buflen, FAR off_t *offset)
+{
+  size_t copysize;
+
+  copysize = procfs_memcpy(procfile->line, linesize, *buffer, *buflen,
+                           offset);
+  *buffer += copysize;
+  *buflen -= copysize;
+  return copysize;
+}
+#endif
+
+/****************************************************************************
+ * Name: memfrag_read
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_FRAGSTATS
+static ssize_t memfrag_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR const struct procfs_meminfo_entry_s *entry;
+  FAR struct meminfo_file_s *procfile;
+  FAR struct mm_fraginfo_s *info;
+  size_t totalsize = 0;
+  size_t linesize;
+  off_t offset;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct meminfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* The statistics are too large for the stack */
+
+  info = fs_heap_malloc(sizeof(struct mm_fraginfo_s));
+  if (info == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL && buflen > 0;
+       entry = entry->next)
+    {
+      mm_fraginfo(entry->heap, info);
+
+      /* The summary:  The fragmentation is the share of the free memory
+       * that is not in the largest free chunk.
+       */
+
+      linesize = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                 "%s: %s\n"
+                                 "  free %zu in %zu chunks, largest %zu "
+                                 "(low %zu), frag %u%%, failed %lu\n"
+                                 "  largest trend:",
+                                 entry->name, info->enabled ? "on" : "off",
+                                 info->freesize, info->nfree,
+                                 info->largest, info->minlargest,
+                                 info->freesize == 0 ? 0 :
+                                 (unsigned int)(100 - (uint64_t)100 *
+                                 info->largest / info->freesize),
+                                 info->nfail);
+
+      for (i = 0; i < MM_FRAG_NTREND; i++)
+        {
+          linesize += procfs_snprintf(procfile->line + linesize,
+                                      MEMINFO_LINELEN - linesize,
+                                      " %zu", info->trend[i]);
+        }
+
+      linesize += procfs_snprintf(procfile->line + linesize,
+                                  MEMINFO_LINELEN - linesize,
+                                  "\n  %11s%11s%11s\n",
+                                  "size<", "nalloc", "nfree");
+      totalsize += memfrag_copy(procfile, linesize, &buffer, &buflen,
+                                &offset);
+
+      /* The histograms of the requested and of the free chunk sizes */
+
+      for (i = 0; i < MM_FRAG_NBUCKETS && buflen > 0; i++)
+        {
+          if (info->allochist[i] == 0 && info->freehist[i] == 0)
+            {
+              continue;
+            }
+
+          linesize = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                     "  %11lu%11lu%11lu\n",
+                                     1ul << i, info->allochist[i],
+                                     info->freehist[i]);
+          totalsize += memfrag_copy(procfile, linesize, &buffer, &buflen,
+                                    &offset);
+        }
+
+      /* The latency percentiles */
+
+      linesize = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                 "  %11s%11s%11s%11s\n"
+                                 "  %11s%11lu%11lu%11lu\n"
+                                 "  %11s%11lu%11lu%11lu\n",
+                                 "ns<", "p50", "p90", "p99",
+                                 "malloc",
+                                 memfrag_percentile(info->alloclat, 50,
+                                                    info->perffreq),
+                                 memfrag_percentile(info->alloclat, 90,
+                                                    info->perffreq),
+                                 memfrag_percentile(info->alloclat, 99,
+                                                    info->perffreq),
+                                 "free",
+                                 memfrag_percentile(info->freelat, 50,
+                                                    info->perffreq),
+                                 memfrag_percentile(info->freelat, 90,
+                                                    info->perffreq),
+                                 memfrag_percentile(info->freelat, 99,
+                                                    info->perffreq));
+      totalsize += memfrag_copy(procfile, linesize, &buffer, &buflen,
+                                &offset);
+    }
+
+  fs_heap_free(info);
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: memfrag_write
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_FRAGSTATS
+static ssize_t memfrag_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  FAR struct procfs_meminfo_entry_s *entry;
+  bool enable;
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  /* "on" (re)starts the collection on all heaps, "off" stops it */
+
+  if (strncmp(buffer, "on", 2) == 0)
+    {
+      enable = true;
+    }
+  else if (strncmp(buffer, "off", 3) == 0)
+    {
+      enable = false;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      mm_fragstats_enable(entry->heap, enable);
+    }
+
+  return buflen;
+}
+#endif
+
+/****************************************************************************
+ * Name: memprof_read
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+static ssize_t memprof_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR const struct procfs_meminfo_entry_s *entry;
+  FAR struct mempool_sizeclass_s *classes;
+  FAR struct meminfo_file_s *procfile;
+  struct mempool_profile_s info;
+  size_t totalsize = 0;
+  size_t copysize;
+  size_t linesize;
+  ssize_t nclasses;
+  off_t offset;
+  ssize_t i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct meminfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  for (entry = g_procfs_meminfo; entry != NULL && buflen > 0;
+       entry = entry->next)
+    {
+      /* Suggest as many size classes as the current table has */
+
+      if (entry->mpool == NULL ||
+          mempool_multiple_suggest(entry->mpool, NULL, 0, &info) < 0 ||
+          info.npools == 0)
+        {
+          continue;
+        }
+
+      /* Stop at a complete heap rather than fail a partial read */
+
+      classes = fs_heap_malloc(info.npools * sizeof(*classes));
+      if (classes == NULL)
+        {
+          if (totalsize == 0)
+            {
+              return -ENOMEM;
+            }
+
+          break;
+        }
+
+      nclasses = mempool_multiple_suggest(entry->mpool, classes,
+                                          info.npools, &info);
+      if (nclasses < 0)
+        {
+          fs_heap_free(classes);
+          continue;
+        }
+
+      linesize = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                 "%s: %s, nalloc %lu, nmiss %lu, "
+                                 "granule %zu\n"
+                                 "  waste %" PRIu64 " -> %" PRIu64 ", "
+                                 "expandsize %zu -> %zu\n"
+                                 "  %11s%11s%11s%11s\n",
+                                 entry->name, info.enabled ? "on" : "off",
+                                 info.nalloc, info.nmiss, info.granule,
+                                 info.waste, info.newwaste,
+                                 info.expandsize, info.newexpandsize,
+                                 "bsize", "ninitial", "nalloc", "waste");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      /* The columns bsize and ninitial are the poolsize and ninitial
+       * tables of struct mempool_init_s.
+       */
+
+      for (i = 0; i < nclasses && buflen > 0; i++)
+        {
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "  %11zu%11zu%11lu%11" PRIu64 "\n",
+                                       classes[i].blocksize,
+                                       classes[i].ninitial,
+                                       classes[i].nalloc,
+                                       classes[i].waste);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+          buffer    += copysize;
+          buflen    -= copysize;
+        }
+
+      fs_heap_free(classes);
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: memprof_write
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+static ssize_t memprof_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  FAR struct procfs_meminfo_entry_s *entry;
+  bool enable;
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  /* "on" (re)starts the profile on all heaps, "off" stops it */
+
+  if (strncmp(buffer, "on", 2) == 0)
+    {
+      enable = true;
+    }
+  else if (strncmp(buffer, "off", 3) == 0)
+    {
+      enable = false;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      if (entry->mpool != NULL)
+        {
+          mempool_multiple_profile(entry->mpool, enable);
+        }
+    }
+
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: meminfo_dup
  *
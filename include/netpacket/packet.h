@@ -44,6 +44,38 @@
 #define PACKET_LOOPBACK   5
 #define PACKET_FASTROUTE  6
 
+/* SOL_PACKET socket options */
+
+#define PACKET_RX_RING    5   /* Map received frames, struct tpacket_req */
+#define PACKET_STATISTICS 6   /* Get struct tpacket_stats and reset it */
+#define PACKET_VERSION    10  /* Frame header version, enum tpacket_versions */
+#define PACKET_HDRLEN     11  /* Get the frame header length of a version */
+#define PACKET_TX_RING    13  /* Map frames to send, struct tpacket_req */
+
+/* tp_status of the frames of the RX ring */
+
+#define TP_STATUS_KERNEL       0        /* Owned by the kernel */
+#define TP_STATUS_USER         (1 << 0) /* Holds a frame for the user */
+#define TP_STATUS_COPY         (1 << 1) /* Not used */
+#define TP_STATUS_LOSING       (1 << 2) /* Frames were dropped before */
+
+/* tp_status of the frames of the TX ring */
+
+#define TP_STATUS_AVAILABLE    0        /* Owned by the user */
+#define TP_STATUS_SEND_REQUEST (1 << 0) /* Holds a frame to be sent */
+#define TP_STATUS_SENDING      (1 << 1) /* Being sent */
+#define TP_STATUS_WRONG_FORMAT (1 << 2) /* Not sent, tp_len is invalid */
+
+/* Frames and the data in them are aligned to TPACKET_ALIGNMENT.  The data
+ * of a TX frame starts at TPACKET_ALIGN(sizeof(struct tpacket2_hdr)).
+ */
+
+#define TPACKET_ALIGNMENT 16
+#define TPACKET_ALIGN(x)  (((x) + TPACKET_ALIGNMENT - 1) & \
+                           ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET2_HDRLEN   (TPACKET_ALIGN(sizeof(struct tpacket2_hdr)) + \
+                           sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -59,4 +91,51 @@ struct sockaddr_ll
   unsigned char  sll_addr[8];
 };
 
+/* Frame header versions, only TPACKET_V2 is supported */
+
+enum tpacket_versions
+{
+  TPACKET_V1,
+  TPACKET_V2,
+  TPACKET_V3
+};
+
+/* The header at the start of each frame of a ring.  The struct sockaddr_ll
+ * of an RX frame follows at TPACKET_ALIGN(sizeof(struct tpacket2_hdr)).
+ */
+
+struct tpacket2_hdr
+{
+  uint32_t tp_status;    /* TP_STATUS_* */
+  uint32_t tp_len;       /* Length of the frame */
+  uint32_t tp_snaplen;   /* Length of the frame in the ring */
+  uint16_t tp_mac;       /* Offset of the frame from the header */
+  uint16_t tp_net;       /* Offset of the network header */
+  uint32_t tp_sec;       /* Time of reception */
+  uint32_t tp_nsec;
+  uint16_t tp_vlan_tci;
+  uint16_t tp_vlan_tpid;
+  uint8_t  tp_padding[4];
+};
+
+/* The layout of a ring, see PACKET_RX_RING and PACKET_TX_RING.  A ring has
+ * tp_block_nr blocks of tp_block_size bytes, each holding as many frames
+ * of tp_frame_size bytes as fit into it.  The RX ring and the TX ring are
+ * mapped in this order by one mmap() call on the socket.
+ */
+
+struct tpacket_req
+{
+  unsigned int tp_block_size;  /* Minimal size of contiguous block */
+  unsigned int tp_block_nr;    /* Number of blocks */
+  unsigned int tp_frame_size;  /* Size of frame */
+  unsigned int tp_frame_nr;    /* Total number of frames */
+};
+
+struct tpacket_stats
+{
+  unsigned int tp_packets;     /* Frames received */
+  unsigned int tp_drops;       /* Frames dropped */
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
@@ -0,0 +1,74 @@
+/****************************************************************************
+ * include/nuttx/csum.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CSUM_H
+#define __INCLUDE_NUTTX_CSUM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: csum_partial
+ *
+ * Description:
+ *   Add the 16-bit one's complement sum (RFC 1071) of the 'len' bytes at
+ *   'data' to 'sum'.  The 16-bit words are read in memory byte order, so
+ *   on a little-endian CPU the result is byte-swapped with respect to the
+ *   network order sum.  A trailing odd byte is padded with a zero byte.
+ *
+ *   The generic C version is replaced by an architecture-specific one if
+ *   CONFIG_LIBC_ARCH_CSUM is selected.
+ *
+ * Input Parameters:
+ *   data - Beginning of the data, no alignment is required
+ *   len  - Length of the data in bytes
+ *   sum  - The sum of the previous data, zero for the first call
+ *
+ * Returned Value:
+ *   The folded 16-bit sum, in memory byte order.
+ *
+ ****************************************************************************/
+
+uint16_t csum_partial(FAR const void *data, size_t len, uint16_t sum);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_CSUM_H */
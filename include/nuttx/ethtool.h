@@ -221,4 +221,18 @@ struct ethtool_cmd
   uint32_t reserved[2];
 };
 
+/* struct ethtool_value - generic ethtool structure
+ * cmd: Command number = ETHTOOL_G* or ETHTOOL_S*, e.g. ETHTOOL_GGRO
+ * data: Generic data, e.g. the enable state of a feature
+ *
+ * It is passed through the ifr_data field of struct ifreq with the
+ * SIOCETHTOOL ioctl.
+ **/
+
+struct ethtool_value
+{
+  uint32_t cmd;
+  uint32_t data;
+};
+
 #endif
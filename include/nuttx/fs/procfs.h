@@ -131,11 +131,18 @@ struct procfs_dir_priv_s
 /* An entry for procfs_register_meminfo */
 
 struct mm_heap_s;
+struct mempool_multiple_s;
 struct procfs_meminfo_entry_s
 {
   FAR const char *name;
   FAR struct mm_heap_s *heap;
   FAR struct procfs_meminfo_entry_s *next;
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+
+  /* The multiple mempool of the heap, profiled through /proc/memprof */
+
+  FAR struct mempool_multiple_s *mpool;
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
 
   /* This is dynamic control flag whether to turn on backtrace in the heap,
@@ -87,6 +87,19 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+/* This structure describes the cache of free blocks of one CPU */
+
+struct mempool_cpu_s
+{
+  sq_queue_t    queue;   /* The cached free blocks */
+  size_t        count;   /* The number of cached free blocks */
+  unsigned long nhit;    /* The number of allocations from the cache */
+  unsigned long nrefill; /* The number of batches taken from the pool */
+  unsigned long ndrain;  /* The number of batches returned to the pool */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -110,6 +123,9 @@ struct mempool_s
   size_t     nalloc;  /* The number of used block in mempool */
   spinlock_t lock;    /* The protect lock to mempool */
   sem_t      waitsem; /* The semaphore of waiter get free block */
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  struct mempool_cpu_s percpu[CONFIG_SMP_NCPUS]; /* The per-CPU caches */
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
 #endif
@@ -137,6 +153,12 @@ struct mempoolinfo_s
   unsigned long aordblks; /* This is the number of used blocks */
   unsigned long sizeblks; /* This is the size of a mempool blocks */
   unsigned long nwaiter;  /* This is the number of waiter for mempool */
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  unsigned long ncached;  /* This is the number of free blocks in the CPU caches */
+  unsigned long nhit;     /* This is the number of allocations from the CPU caches */
+  unsigned long nrefill;  /* This is the number of batches moved to the CPU caches */
+  unsigned long ndrain;   /* This is the number of batches moved from the CPU caches */
+#endif
 };
 
 /****************************************************************************
@@ -521,6 +543,74 @@ struct mallinfo_task
 mempool_multiple_info_task(FAR struct mempool_multiple_s *mpool,
                            FAR const struct malltask *task);
 
+/****************************************************************************
+ * Name: mempool_multiple_reserve
+ *
+ * Description:
+ *   Fill the pools of a multiple memory pool with free blocks in advance,
+ *   so that the first allocations don't need to expand the pools.
+ *
+ * Input Parameters:
+ *   mpool    - The handle of multiple memory pool to be used.
+ *   ninitial - The number of blocks to reserve for each pool.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mempool_multiple_reserve(FAR struct mempool_multiple_s *mpool,
+                             FAR const size_t *ninitial);
+
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+
+/****************************************************************************
+ * Name: mempool_multiple_profile
+ *
+ * Description:
+ *   Start or stop recording the sizes requested from a multiple memory
+ *   pool.  Starting the recording clears the previous profile, stopping it
+ *   keeps the profile for mempool_multiple_suggest().
+ *
+ * Input Parameters:
+ *   mpool  - The handle of multiple memory pool to be used.
+ *   enable - Whether to record the requests.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mempool_multiple_profile(FAR struct mempool_multiple_s *mpool,
+                             bool enable);
+
+/****************************************************************************
+ * Name: mempool_multiple_suggest
+ *
+ * Description:
+ *   Compute the table of at most nclasses block sizes that minimizes the
+ *   internal fragmentation of the profiled requests, together with the
+ *   number of blocks to reserve per pool and the expand size.
+ *
+ * Input Parameters:
+ *   mpool    - The handle of multiple memory pool to be used.
+ *   classes  - The location to return the suggested size classes, may be
+ *              NULL if only the summary is needed.
+ *   nclasses - The maximum number of size classes.
+ *   info     - The location to return the summary of the profile.
+ *
+ * Returned Value:
+ *   The number of suggested size classes; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t mempool_multiple_suggest(FAR struct mempool_multiple_s *mpool,
+                                 FAR struct mempool_sizeclass_s *classes,
+                                 size_t nclasses,
+                                 FAR struct mempool_profile_s *info);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
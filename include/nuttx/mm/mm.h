@@ -162,6 +162,13 @@
 #  define MM_ALIGN       CONFIG_MM_DEFAULT_ALIGNMENT
 #endif
 
+/* The number of power of two buckets of the fragmentation histograms and
+ * the number of samples of the largest free chunk kept for its trend.
+ */
+
+#define MM_FRAG_NBUCKETS 24
+#define MM_FRAG_NTREND   8
+
 #define MM_INIT_MAGIC    0xcc
 #define MM_ALLOC_MAGIC   0xaa
 #define MM_FREE_MAGIC    0x55
@@ -180,8 +187,66 @@ struct mempool_init_s
   size_t            chunksize;
   size_t            expandsize;
   size_t            dict_expendsize;
+  FAR const size_t *ninitial; /* Blocks to reserve per pool, may be NULL */
+};
+
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+/* The allocation profile of the multiple mempool of a heap and the size
+ * classes suggested from it, see mempool_multiple_suggest().  The waste is
+ * the internal fragmentation summed over all profiled requests, measured
+ * at the resolution of the profile (granule).
+ */
+
+struct mempool_profile_s
+{
+  bool          enabled;       /* Profiling is active */
+  size_t        npools;        /* Number of pools in the current table */
+  size_t        granule;       /* Size resolution of the profile */
+  unsigned long nalloc;        /* Number of profiled requests */
+  unsigned long nmiss;         /* Requests larger than the largest pool */
+  uint64_t      waste;         /* Waste of the current table */
+  uint64_t      newwaste;      /* Waste of the suggested table */
+  size_t        expandsize;    /* Current expand size */
+  size_t        newexpandsize; /* Suggested expand size */
 };
 
+/* One suggested size class, the blocksize and ninitial columns can be used
+ * as the poolsize and ninitial tables of struct mempool_init_s.
+ */
+
+struct mempool_sizeclass_s
+{
+  size_t        blocksize;     /* Block size of the pool */
+  size_t        ninitial;      /* Blocks to reserve at initialization */
+  unsigned long nalloc;        /* Profiled requests served by the pool */
+  uint64_t      waste;         /* Waste of the pool */
+};
+#endif
+
+#ifdef CONFIG_MM_HEAP_FRAGSTATS
+/* Fragmentation and latency statistics of one heap, see mm_fraginfo().
+ * Bucket n of a histogram counts the values in [2^(n-1), 2^n), the last
+ * bucket also counts all larger values.
+ */
+
+struct mm_fraginfo_s
+{
+  bool          enabled;                      /* Collection is active */
+  unsigned long allochist[MM_FRAG_NBUCKETS];  /* Requested sizes (bytes) */
+  unsigned long alloclat[MM_FRAG_NBUCKETS];   /* malloc() latency (perf) */
+  unsigned long freelat[MM_FRAG_NBUCKETS];    /* free() latency (perf) */
+  unsigned long freehist[MM_FRAG_NBUCKETS];   /* Free chunk sizes (bytes) */
+  unsigned long nfail;                        /* Failed allocations */
+  size_t        nfree;                        /* Number of free chunks */
+  size_t        freesize;                     /* Total free size */
+  size_t        largest;                      /* Largest free chunk */
+  size_t        minlargest;                   /* Low-water mark of largest */
+  size_t        trend[MM_FRAG_NTREND];        /* Samples of largest, oldest
+                                               * first */
+  unsigned long perffreq;                     /* Frequency of perf counts */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -420,6 +485,14 @@ struct mallinfo_task kmm_mallinfo_task(FAR const struct malltask *task);
 #  endif
 #endif
 
+/* Functions contained in mm_fragstats.c ***********************************/
+
+#ifdef CONFIG_MM_HEAP_FRAGSTATS
+void mm_fragstats_enable(FAR struct mm_heap_s *heap, bool enable);
+void mm_fraginfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_fraginfo_s *info);
+#endif
+
 /* Functions contained in mm_memdump.c **************************************/
 
 void mm_memdump(FAR struct mm_heap_s *heap,
@@ -141,6 +141,7 @@ struct file;    /* Forward reference */
 struct stat;    /* Forward reference */
 struct socket;  /* Forward reference */
 struct pollfd;  /* Forward reference */
+struct mm_map_entry_s; /* Forward reference */
 
 struct sock_intf_s
 {
@@ -181,6 +182,22 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+
+  /* Optional, the messages are passed to si_recvmsg and si_sendmsg one by
+   * one if these are NULL or return -ENOSYS.
+   */
+
+  CODE int        (*si_recvmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags, FAR const struct timespec *timeout);
+  CODE int        (*si_sendmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+
+  /* Optional, mmap() fails with ENODEV if this is NULL */
+
+  CODE int        (*si_mmap)(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -234,6 +251,14 @@ struct socket_conn_s
   uint8_t       s_ttl;       /* Default time-to-live */
 #endif
 
+#ifdef CONFIG_NET_CONN_LOCK
+  /* Protects the read-ahead buffers of the connection so that they can be
+   * consumed without holding the network lock.
+   */
+
+  mutex_t       s_lock;
+#endif
+
   /* Connection-specific content may follow */
 };
 
@@ -380,6 +405,33 @@ int net_trylock(void);
 
 void net_unlock(void);
 
+/****************************************************************************
+ * Name: conn_lock_init, conn_lock and conn_unlock
+ *
+ * Description:
+ *   Initialize, take and release the lock of one connection.  The lock
+ *   protects the read-ahead buffers of the connection.  It may be taken
+ *   with or without the network lock held, but the network lock must never
+ *   be taken while holding it.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CONN_LOCK
+void conn_lock_init(FAR struct socket_conn_s *sconn);
+void conn_lock(FAR struct socket_conn_s *sconn);
+void conn_unlock(FAR struct socket_conn_s *sconn);
+#else
+#  define conn_lock_init(s)
+#  define conn_lock(s)
+#  define conn_unlock(s)
+#endif
+
 /****************************************************************************
  * Name: net_sem_timedwait
  *
@@ -928,6 +980,69 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends multiple messages to a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to sendmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send
+ *   vlen      The number of messages in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent, msg_len of each of
+ *   them is set to the number of bytes sent.  If the first message fails,
+ *   a negated errno value is returned (see comments with sendmsg() for a
+ *   list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives multiple messages from a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to recvmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Buffers to receive the messages
+ *   vlen      The number of messages in msgvec
+ *   flags     Receive flags
+ *   timeout   Time limit of the whole call, NULL to wait without limit.
+ *             As on Linux, it is only checked after each message.
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received, msg_len of each
+ *   of them is set to the number of bytes received.  If nothing could be
+ *   received, a negated errno value is returned (see comments with
+ *   recvmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -1330,6 +1445,25 @@ int psock_shutdown(FAR struct socket *psock, int how);
 struct pollfd; /* Forward reference -- see poll.h */
 int psock_poll(FAR struct socket *psock, struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: psock_mmap
+ *
+ * Description:
+ *   The standard mmap() operation redirects operations on socket descriptors
+ *   to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   map   - The mapping requested, see the mmap method of struct
+ *           file_operations.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure.
+ *
+ ****************************************************************************/
+
+int psock_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
 /****************************************************************************
  * Name: psock_dup2
  *
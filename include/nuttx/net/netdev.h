@@ -162,6 +162,13 @@
 #    define NETDEV_RXARP(dev)
 #  endif
 #  define NETDEV_RXDROPPED(dev)   _NETDEV_STATISTIC(dev,rx_dropped)
+#  ifdef CONFIG_NETDEV_GRO
+#    define NETDEV_RXGROMERGED(dev) _NETDEV_STATISTIC(dev,rx_gro_merged)
+#    define NETDEV_RXGROPACKETS(dev) _NETDEV_STATISTIC(dev,rx_gro_packets)
+#  else
+#    define NETDEV_RXGROMERGED(dev)
+#    define NETDEV_RXGROPACKETS(dev)
+#  endif
 
 #  define NETDEV_TXPACKETS(dev) \
     do { \
@@ -183,6 +190,8 @@
 #  define NETDEV_RXIPV6(dev)
 #  define NETDEV_RXARP(dev)
 #  define NETDEV_RXDROPPED(dev)
+#  define NETDEV_RXGROMERGED(dev)
+#  define NETDEV_RXGROPACKETS(dev)
 
 #  define NETDEV_TXPACKETS(dev)
 #  define NETDEV_TXDONE(dev)
@@ -216,6 +225,33 @@
      (netdev_ipv6_lookup(dev, addr, true) != NULL)
 #endif
 
+/* Checksum offload.  d_csumcap holds the NETDEV_CSUM_TX/RX capabilities of
+ * the driver, d_csumstate tells about the TCP/UDP checksum of the packet
+ * in d_iob:
+ *
+ *   NETDEV_CSUM_NONE     - The checksum field holds the full checksum
+ *                          (TX) or has not been verified yet (RX).
+ *   NETDEV_CSUM_PARTIAL  - TX only, the checksum field holds the pseudo
+ *                          header sum, the driver has to complete it.
+ *   NETDEV_CSUM_VERIFIED - RX only, the driver has verified the checksum.
+ */
+
+#define NETDEV_CSUM_TX       (1 << 0)
+#define NETDEV_CSUM_RX       (1 << 1)
+
+#define NETDEV_CSUM_NONE     0
+#define NETDEV_CSUM_PARTIAL  1
+#define NETDEV_CSUM_VERIFIED 2
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define netdev_csum_valid(dev) \
+     ((dev)->d_csumstate == NETDEV_CSUM_VERIFIED)
+#else
+#  define netdev_csum_valid(dev)            false
+#  define netdev_csum_partial(dev,proto,p)  false
+#  define netdev_csum_complete(dev)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -243,6 +279,10 @@ struct netdev_statistics_s
   uint32_t rx_arp;         /* Number of Rx ARP packets received */
 #endif
   uint32_t rx_dropped;     /* Unsupported Rx packets received */
+#ifdef CONFIG_NETDEV_GRO
+  uint32_t rx_gro_merged;  /* Rx segments merged into a previous one */
+  uint32_t rx_gro_packets; /* Rx packets built by merging segments */
+#endif
   uint64_t rx_bytes;       /* Number of bytes received */
 
   /* Tx Status */
@@ -474,6 +514,24 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* Generic segmentation offload.  d_gsomax is the largest packet
+   * (including the link layer header) that the driver accepts for
+   * segmentation, zero if it accepts none.  When the outgoing packet is
+   * larger than d_pktsize, d_gsosize holds the MSS it has to be cut into.
+   */
+
+  uint16_t d_gsomax;
+  uint16_t d_gsosize;
+#endif
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  /* Checksum offload, see NETDEV_CSUM_* above */
+
+  uint8_t d_csumcap;
+  uint8_t d_csumstate;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -1202,6 +1260,54 @@ void netdev_iob_release(FAR struct net_driver_s *dev);
 FAR struct iob_s *netdev_iob_clone(FAR struct net_driver_s *dev,
                                    bool throttled);
 
+/****************************************************************************
+ * Name: netdev_csum_partial
+ *
+ * Description:
+ *   Leave the TCP or UDP checksum of the outgoing packet in d_iob to the
+ *   driver if it is able to compute it.  On success only the pseudo header
+ *   sum is stored in the checksum field and the packet is marked as
+ *   NETDEV_CSUM_PARTIAL.
+ *
+ * Input Parameters:
+ *   dev    - The network device that sends the packet
+ *   proto  - IP_PROTO_TCP or IP_PROTO_UDP
+ *   chksum - The checksum field in the TCP or UDP header
+ *
+ * Returned Value:
+ *   true if the driver completes the checksum, false if the caller has to
+ *   compute it.
+ *
+ * Assumptions:
+ *   The caller has locked the network and the IP header is complete.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+bool netdev_csum_partial(FAR struct net_driver_s *dev, uint8_t proto,
+                         FAR uint16_t *chksum);
+#endif
+
+/****************************************************************************
+ * Name: netdev_csum_complete
+ *
+ * Description:
+ *   Compute the TCP or UDP checksum of a NETDEV_CSUM_PARTIAL packet in
+ *   d_iob in software, for the paths where the packet cannot be handed to
+ *   the driver together with its checksum state.
+ *
+ * Input Parameters:
+ *   dev - The network device that holds the packet
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+void netdev_csum_complete(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: netdev_ipv6_add/del
  *
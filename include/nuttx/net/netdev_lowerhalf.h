@@ -72,6 +72,13 @@
 #define NETPKT_BUFLEN   CONFIG_IOB_BUFSIZE
 #define NETPKT_BUFNUM   CONFIG_IOB_NBUFFERS
 
+/* Offload features of the lower half, see netdev_lowerhalf_s::features */
+
+#define NETDEV_TX_TSO4  (1 << 0) /* Segments TCP over IPv4 packets */
+#define NETDEV_TX_TSO6  (1 << 1) /* Segments TCP over IPv6 packets */
+#define NETDEV_TX_CSUM  (1 << 2) /* Completes TCP/UDP checksums on TX */
+#define NETDEV_RX_CSUM  (1 << 3) /* Verifies TCP/UDP checksums on RX */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -119,6 +126,12 @@ struct netdev_lowerhalf_s
 
   atomic_t quota[NETPKT_TYPENUM];
 
+  /* Offload features supported by the driver, NETDEV_TX_* and
+   * NETDEV_RX_* bits.  Set it before netdev_lower_register.
+   */
+
+  uint32_t features;
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -560,4 +573,98 @@ int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
 
 #define netpkt_free_queue(queue) iob_free_queue(queue)
 
+/****************************************************************************
+ * Name: netpkt_getgsosize
+ *
+ * Description:
+ *   Get the MSS of a GSO packet, i.e. the size of the TCP payload of the
+ *   segments the packet has to be cut into.  Only valid for the packet
+ *   being passed to the transmit() callback.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   pkt - The net packet
+ *
+ * Returned Value:
+ *   The MSS of the segments, or zero if the packet is a normal packet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+#  define netpkt_getgsosize(dev, pkt) ((dev)->netdev.d_gsosize)
+#else
+#  define netpkt_getgsosize(dev, pkt) 0
+#endif
+
+/****************************************************************************
+ * Name: netpkt_is_csumpartial
+ *
+ * Description:
+ *   Check whether the driver has to complete the TCP or UDP checksum of
+ *   the packet.  The checksum field then holds the pseudo header sum, the
+ *   driver adds the sum over the TCP or UDP header and payload to it.
+ *   Only valid for the packet being passed to the transmit() callback.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   pkt - The net packet
+ *
+ * Returned Value:
+ *   True if the checksum is left to the driver.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define netpkt_is_csumpartial(dev, pkt) \
+     ((dev)->netdev.d_csumstate == NETDEV_CSUM_PARTIAL)
+#else
+#  define netpkt_is_csumpartial(dev, pkt) false
+#endif
+
+/****************************************************************************
+ * Name: netpkt_getcsumstart
+ *
+ * Description:
+ *   Get where the checksum of a packet marked by netpkt_is_csumpartial()
+ *   has to be computed: The sum runs from the returned offset to the end
+ *   of the packet and is stored at *offset bytes after it.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *   offset - Returns the offset of the checksum field from the start
+ *
+ * Returned Value:
+ *   The offset of the TCP or UDP header from the start of the link layer
+ *   header, see netpkt_getdata().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+unsigned int netpkt_getcsumstart(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt,
+                                 FAR unsigned int *offset);
+#endif
+
+/****************************************************************************
+ * Name: netpkt_setcsumvalid
+ *
+ * Description:
+ *   Mark that the hardware has verified the TCP or UDP checksum of the
+ *   packet, the network stack then skips the check.  Only valid for the
+ *   packet being returned from the receive() callback.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   pkt - The net packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define netpkt_setcsumvalid(dev, pkt) \
+     ((dev)->netdev.d_csumstate = NETDEV_CSUM_VERIFIED)
+#else
+#  define netpkt_setcsumvalid(dev, pkt)
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_LOWERHALF_H */
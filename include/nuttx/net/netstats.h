@@ -80,6 +80,43 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_LOCK_STATS
+/* Usage and contention of one kind of network lock.  The wait times are
+ * in units of the perf counter.
+ */
+
+struct net_lockstats_s
+{
+  uint32_t acquired;   /* Number of times the lock was taken */
+  uint32_t contended;  /* Number of times the caller had to wait */
+  uint64_t waittime;   /* Accumulated time spent waiting */
+  uint32_t maxwait;    /* Longest single wait */
+};
+
+struct lock_stats_s
+{
+  struct net_lockstats_s netlock;  /* The global network lock */
+#ifdef CONFIG_NET_CONN_LOCK
+  struct net_lockstats_s connlock; /* All per-connection locks */
+#endif
+};
+#endif
+
+#if defined(CONFIG_NET_ARP) || defined(CONFIG_NET_IPv6)
+/* The cost of the lookups in a neighbor cache, i.e. the ARP table or the
+ * IPv6 Neighbor table.  probes / lookups is the average number of entries
+ * compared per lookup.
+ */
+
+struct nbcache_stats_s
+{
+  uint32_t lookups;    /* Number of lookups */
+  uint32_t probes;     /* Number of entries compared in the lookups */
+  uint32_t misses;     /* Number of lookups that found no entry */
+  uint32_t evictions;  /* Number of live entries replaced by new ones */
+};
+#endif
+
 /* The structure holding the networking statistics that are gathered if
  * CONFIG_NET_STATISTICS is defined.
  */
@@ -121,6 +158,18 @@ struct net_stats_s
 #ifdef CONFIG_NET_CAN
   struct can_stats_s  can;      /* CAN statistics */
 #endif
+
+#ifdef CONFIG_NET_ARP
+  struct nbcache_stats_s arp;   /* ARP table statistics */
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  struct nbcache_stats_s nd;    /* IPv6 Neighbor table statistics */
+#endif
+
+#ifdef CONFIG_NET_LOCK_STATS
+  struct lock_stats_s lock;     /* Lock contention statistics */
+#endif
 };
 
 /****************************************************************************
@@ -253,7 +253,33 @@ struct work_s
   clock_t          qtime;  /* Time work queued */
   worker_t         worker; /* Work callback */
   FAR void        *arg;    /* Callback argument */
+#ifdef CONFIG_SCHED_WORKQUEUE_HEAP
+  FAR struct work_s *hchild; /* First child in the pending heap */
+  FAR struct work_s *hnext;  /* Next sibling in the pending heap */
+  FAR struct work_s *hprev;  /* Parent or previous sibling in the heap */
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  FAR struct kwork_wqueue_s *wq; /* The queue the work was last queued to */
+#endif
+};
+
+/* This structure describes the statistics of one kernel work queue.  The
+ * dispatch lag is in clock ticks, the execution times are in the units
+ * returned by perf_gettime().
+ */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+struct work_stats_s
+{
+  size_t   depth;          /* Number of work currently queued */
+  size_t   maxdepth;       /* Peak number of work queued */
+  size_t   ndispatch;      /* Number of work dispatched */
+  clock_t  maxlag;         /* Worst-case dispatch lag */
+  clock_t  maxexec;        /* Worst-case execution time */
+  clock_t  totalexec;      /* Total execution time of all work */
+  worker_t maxworker;      /* The worker with the worst execution time */
 };
+#endif
 
 /* This is an enumeration of the various events that may be
  * notified via work_notifier_signal().
@@ -409,6 +435,40 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
                   FAR struct work_s *work, worker_t worker,
                   FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue work on the per-CPU work queue of the given CPU.  The work is
+ *   performed by a worker thread pinned to that CPU.  If the per-CPU queue
+ *   is not running or already has a backlog of expired work, the work is
+ *   queued on the global work queue instead.
+ *
+ *   Work queued with this function is cancelled with work_cancel() or
+ *   work_cancel_sync() as usual.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   cpu    - The CPU to run the work on, or a negative value to select the
+ *            calling CPU.
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, clock_t delay);
+#endif
+
 /****************************************************************************
  * Name: work_queue_next/work_queue_next_wq
  *
@@ -460,6 +520,51 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
 int work_queue_priority(int qid);
 int work_queue_priority_wq(FAR struct kwork_wqueue_s *wqueue);
 
+/****************************************************************************
+ * Name: work_queue_stats/work_queue_stats_wq
+ *
+ * Description:
+ *   Get a snapshot of the statistics of the work queue.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   stats  - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+int work_queue_stats(int qid, FAR struct work_stats_s *stats);
+int work_queue_stats_wq(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_stats_s *stats);
+#endif
+
+/****************************************************************************
+ * Name: work_queue_stats_cpu
+ *
+ * Description:
+ *   Get a snapshot of the statistics of the per-CPU work queue of the given
+ *   CPU.
+ *
+ * Input Parameters:
+ *   qid   - The work queue ID (must be HPWORK or LPWORK)
+ *   cpu   - The CPU index
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure.  -ENODEV is returned if
+ *   the per-CPU queue is not running.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_WORKQUEUE_STATS) && \
+    defined(CONFIG_SCHED_WORKQUEUE_PERCPU)
+int work_queue_stats_cpu(int qid, int cpu, FAR struct work_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: work_cancel/work_cancel_wq
  *
@@ -0,0 +1,159 @@
+/****************************************************************************
+ * libs/libc/misc/lib_csum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/csum.h>
+
+#ifndef CONFIG_LIBC_ARCH_CSUM
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: csum_fold
+ *
+ * Description:
+ *   Fold a 64-bit one's complement sum into 16 bits.
+ *
+ ****************************************************************************/
+
+static inline uint16_t csum_fold(uint64_t sum)
+{
+  sum = (sum & 0xffffffff) + (sum >> 32);
+  sum = (sum & 0xffffffff) + (sum >> 32);
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+
+  return (uint16_t)sum;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: csum_partial
+ *
+ * Description:
+ *   Add the 16-bit one's complement sum of the 'len' bytes at 'data' to
+ *   'sum', see include/nuttx/csum.h.
+ *
+ *   The data is read 32 bits at a time into a 64-bit accumulator, so the
+ *   carries only need to be folded back once at the end.  The words are
+ *   loaded from aligned addresses, an odd start address is handled by
+ *   summing with the bytes swapped and swapping the result back.
+ *
+ ****************************************************************************/
+
+uint16_t csum_partial(FAR const void *data, size_t len, uint16_t sum)
+{
+  FAR const uint8_t *ptr = data;
+  FAR const uint32_t *ptr32;
+  uint64_t acc = sum;
+  uint16_t tail;
+  bool odd = ((uintptr_t)ptr & 1) != 0;
+
+  if (len == 0)
+    {
+      return sum;
+    }
+
+  if (odd)
+    {
+      /* The first byte is the second byte of a word at the aligned
+       * address before, the sum of the shifted words is the byte-swapped
+       * sum of the words we want.
+       */
+
+      acc  = (uint16_t)((sum << 8) | (sum >> 8));
+      tail = 0;
+      ((FAR uint8_t *)&tail)[1] = *ptr++;
+      acc += tail;
+      len--;
+    }
+
+  if (((uintptr_t)ptr & 2) != 0 && len >= 2)
+    {
+      acc += *(FAR const uint16_t *)ptr;
+      ptr += 2;
+      len -= 2;
+    }
+
+  ptr32 = (FAR const uint32_t *)ptr;
+
+  while (len >= 32)
+    {
+      acc += ptr32[0];
+      acc += ptr32[1];
+      acc += ptr32[2];
+      acc += ptr32[3];
+      acc += ptr32[4];
+      acc += ptr32[5];
+      acc += ptr32[6];
+      acc += ptr32[7];
+      ptr32 += 8;
+      len   -= 32;
+    }
+
+  while (len >= 4)
+    {
+      acc += *ptr32++;
+      len -= 4;
+    }
+
+  ptr = (FAR const uint8_t *)ptr32;
+
+  if (len >= 2)
+    {
+      acc += *(FAR const uint16_t *)ptr;
+      ptr += 2;
+      len -= 2;
+    }
+
+  if (len > 0)
+    {
+      tail = 0;
+      *(FAR uint8_t *)&tail = *ptr;
+      acc += tail;
+    }
+
+  sum = csum_fold(acc);
+  if (odd)
+    {
+      sum = (uint16_t)((sum << 8) | (sum >> 8));
+    }
+
+  return sum;
+}
+
+#endif /* !CONFIG_LIBC_ARCH_CSUM */
@@ -24,12 +24,16 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
+
 #include <assert.h>
 #include <execinfo.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <syslog.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/kasan.h>
 #include <nuttx/mm/mempool.h>
@@ -42,6 +46,15 @@
 
 #define MEMPOOL_HEADER_SIZE (sizeof(sq_entry_t) + CONFIG_MM_NODE_GUARDSIZE)
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+#  define MEMPOOL_PERCPU_BATCH (CONFIG_MM_MEMPOOL_PERCPU_DEPTH / 2)
+
+/* A pool that blocks waiting for free blocks must see all of them */
+
+#  define MEMPOOL_PERCPU_CACHED(pool) \
+     (!(pool)->wait || (pool)->expandsize != 0)
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 #define MEMPOOL_MAGIC_FREE  0x55555555
 #define MEMPOOL_MAGIC_ALLOC 0xAAAAAAAA
@@ -100,6 +113,196 @@ static inline void mempool_add_queue(FAR struct mempool_s *pool,
     }
 }
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+/****************************************************************************
+ * Name: mempool_percpu_alloc
+ *
+ * Description:
+ *   Take a free block from the cache of the current CPU.  If the cache is
+ *   empty, refill it with a batch of blocks from the shared queue first.
+ *
+ * Input Parameters:
+ *   pool - Address of the memory pool to be used.
+ *
+ * Returned Value:
+ *   The free block or NULL if both the cache and the shared queue are
+ *   empty.
+ *
+ ****************************************************************************/
+
+static FAR sq_entry_t *mempool_percpu_alloc(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_cpu_s *cache;
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+  if (!MEMPOOL_PERCPU_CACHED(pool))
+    {
+      return NULL;
+    }
+
+  /* Only this CPU touches its cache, so masking the local interrupts is
+   * enough to protect it.
+   */
+
+  flags = up_irq_save();
+  cache = &pool->percpu[this_cpu()];
+
+  if (cache->count == 0)
+    {
+      /* The blocks moved to the cache count as allocated from the pool */
+
+      spin_lock(&pool->lock);
+      while (cache->count < MEMPOOL_PERCPU_BATCH &&
+             (blk = mempool_remove_queue(pool, &pool->queue)) != NULL)
+        {
+          sq_addfirst(blk, &cache->queue);
+          cache->count++;
+        }
+
+      pool->nalloc += cache->count;
+      spin_unlock(&pool->lock);
+
+      if (cache->count > 0)
+        {
+          cache->nrefill++;
+        }
+    }
+
+  /* Go through mempool_remove_queue() like the shared queue, so the
+   * check hook validates the cached blocks too.
+   */
+
+  blk = mempool_remove_queue(pool, &cache->queue);
+  if (blk != NULL)
+    {
+      cache->count--;
+      cache->nhit++;
+    }
+
+  up_irq_restore(flags);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_percpu_release
+ *
+ * Description:
+ *   Put a free block into the cache of the current CPU.  If the cache is
+ *   full, return a batch of blocks to the shared queue first.
+ *
+ * Input Parameters:
+ *   pool - Address of the memory pool to be used.
+ *   blk  - The pointer of memory block.
+ *
+ * Returned Value:
+ *   true if the block was cached, false if the caller must return it to
+ *   the shared queue.
+ *
+ ****************************************************************************/
+
+static bool mempool_percpu_release(FAR struct mempool_s *pool,
+                                   FAR void *blk)
+{
+  FAR struct mempool_cpu_s *cache;
+  irqstate_t flags;
+  int i;
+
+  /* The blocks of the interrupt pool always go back to their own queue */
+
+  if (!MEMPOOL_PERCPU_CACHED(pool) ||
+      (pool->ibase != NULL && (FAR char *)blk >= pool->ibase &&
+       (FAR char *)blk < pool->ibase + pool->interruptsize))
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  cache = &pool->percpu[this_cpu()];
+
+  if (cache->count >= CONFIG_MM_MEMPOOL_PERCPU_DEPTH)
+    {
+      spin_lock(&pool->lock);
+      for (i = 0; i < MEMPOOL_PERCPU_BATCH; i++)
+        {
+          sq_addlast(mempool_remove_queue(pool, &cache->queue),
+                     &pool->queue);
+        }
+
+      pool->nalloc -= MEMPOOL_PERCPU_BATCH;
+      spin_unlock(&pool->lock);
+
+      cache->count -= MEMPOOL_PERCPU_BATCH;
+      cache->ndrain++;
+    }
+
+  kasan_poison(blk, pool->blocksize);
+  sq_addfirst(blk, &cache->queue);
+  cache->count++;
+
+  up_irq_restore(flags);
+  return true;
+}
+
+/****************************************************************************
+ * Name: mempool_percpu_flush
+ *
+ * Description:
+ *   Return the blocks of all CPU caches to the shared queue.  The caller
+ *   must make sure that the pool is not in use.
+ *
+ * Input Parameters:
+ *   pool - Address of the memory pool to be used.
+ *
+ ****************************************************************************/
+
+static void mempool_percpu_flush(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_cpu_s *cache;
+  irqstate_t flags;
+  int cpu;
+
+  flags = spin_lock_irqsave(&pool->lock);
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &pool->percpu[cpu];
+      sq_cat(&cache->queue, &pool->queue);
+      pool->nalloc -= cache->count;
+      cache->count  = 0;
+    }
+
+  spin_unlock_irqrestore(&pool->lock, flags);
+}
+
+/****************************************************************************
+ * Name: mempool_percpu_count
+ *
+ * Description:
+ *   Get the number of free blocks in all CPU caches.  The result is only a
+ *   snapshot.
+ *
+ * Input Parameters:
+ *   pool - Address of the memory pool to be used.
+ *
+ * Returned Value:
+ *   The number of cached free blocks.
+ *
+ ****************************************************************************/
+
+static size_t mempool_percpu_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += pool->percpu[cpu].count;
+    }
+
+  return count;
+}
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -262,6 +465,9 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
   sq_init(&pool->iqueue);
   sq_init(&pool->equeue);
   pool->nalloc = 0;
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  memset(pool->percpu, 0, sizeof(pool->percpu));
+#endif
   if (pool->interruptsize >= blocksize)
     {
       size_t ninterrupt = pool->interruptsize / blocksize;
@@ -347,6 +553,14 @@ FAR void *mempool_allocate(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  blk = mempool_percpu_alloc(pool);
+  if (blk != NULL)
+    {
+      goto out;
+    }
+#endif
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(pool, &pool->queue);
@@ -401,6 +615,9 @@ retry:
   pool->nalloc++;
   spin_unlock_irqrestore(&pool->lock, flags);
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+out:
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   mempool_add_backtrace(pool, (FAR struct mempool_backtrace_s *)
                               ((FAR char *)blk + pool->blocksize));
@@ -427,8 +644,8 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  irqstate_t flags;
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
@@ -437,15 +654,22 @@ void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 
   DEBUGASSERT(buf->magic == MEMPOOL_MAGIC_ALLOC);
   buf->magic = MEMPOOL_MAGIC_FREE;
-
 #endif
 
-  pool->nalloc--;
-
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   memset(blk, MM_FREE_MAGIC, pool->blocksize);
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  if (mempool_percpu_release(pool, blk))
+    {
+      return;
+    }
+#endif
+
+  flags = spin_lock_irqsave(&pool->lock);
+  pool->nalloc--;
+
   if (pool->interruptsize > blocksize)
     {
       if ((FAR char *)blk >= pool->ibase &&
@@ -495,6 +719,9 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
   irqstate_t flags;
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  int cpu;
+#endif
 
   DEBUGASSERT(pool != NULL && info != NULL);
 
@@ -506,6 +733,28 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
   spin_unlock_irqrestore(&pool->lock, flags);
   info->sizeblks = blocksize;
+
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  /* The blocks in the CPU caches are free, but still counted as allocated
+   * by the pool.
+   */
+
+  info->nhit     = 0;
+  info->nrefill  = 0;
+  info->ndrain   = 0;
+  info->ncached  = mempool_percpu_count(pool);
+  info->ordblks += info->ncached;
+  info->aordblks = info->aordblks > info->ncached ?
+                   info->aordblks - info->ncached : 0;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      info->nhit    += pool->percpu[cpu].nhit;
+      info->nrefill += pool->percpu[cpu].nrefill;
+      info->ndrain  += pool->percpu[cpu].ndrain;
+    }
+#endif
+
   if (pool->wait && pool->expandsize == 0)
     {
       int semcount;
@@ -542,13 +791,21 @@ mempool_info_task(FAR struct mempool_s *pool,
                      sq_count(&pool->iqueue);
 
       spin_unlock_irqrestore(&pool->lock, flags);
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+      count += mempool_percpu_count(pool);
+#endif
       info.aordblks += count;
       info.uordblks += count * blocksize;
     }
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      size_t count = pool->nalloc;
+
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+      count -= MIN(count, mempool_percpu_count(pool));
+#endif
+      info.aordblks += count;
+      info.uordblks += count * blocksize;
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -618,6 +875,10 @@ int mempool_deinit(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   size_t count = 0;
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  mempool_percpu_flush(pool);
+#endif
+
   if (pool->nalloc != 0)
     {
       return -EBUSY;
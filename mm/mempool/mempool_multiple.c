@@ -35,6 +35,39 @@
 #include <nuttx/mm/mempool.h>
 #include <nuttx/mm/kasan.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+/* The maximum number of size steps of the allocation profile */
+
+#  define MPOOL_PROFILE_MAXBINS 1024
+
+/* The fixed point scale used to split the peak usage of a pool */
+
+#  define MPOOL_PROFILE_SCALE   256
+
+/* The number of expand sizes tried by mempool_multiple_suggest() */
+
+#  define MPOOL_PROFILE_NEXPAND 4
+
+/* The size of a block and the overhead of an expansion in struct
+ * mempool_s, see mempool.c
+ */
+
+#  if CONFIG_MM_BACKTRACE >= 0
+#    define MPOOL_REALBLOCKSIZE(size) \
+            ALIGN_UP((size) + sizeof(struct mempool_backtrace_s), MM_ALIGN)
+#  else
+#    define MPOOL_REALBLOCKSIZE(size) (size)
+#  endif
+
+#  define MPOOL_EXPAND_HEADER (sizeof(sq_entry_t) + CONFIG_MM_NODE_GUARDSIZE)
+#else
+#  define mempool_multiple_record(mpool, size, pool)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -55,6 +88,19 @@ struct mpool_chunk_s
   size_t used;
 };
 
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+struct mpool_profile_s
+{
+  bool               enabled; /* Recording is active */
+  size_t             granule; /* The size step of the histogram */
+  size_t             nbins;   /* The number of histogram bins */
+  size_t             maxsize; /* The block size of the largest pool */
+  unsigned long      nmiss;   /* Requests larger than the largest pool */
+  FAR unsigned long *hist;    /* The number of requests per size step */
+  FAR size_t        *peak;    /* The peak number of used blocks per pool */
+};
+#endif
+
 struct mempool_multiple_s
 {
   FAR struct mempool_s         *pools;       /* The memory pool array */
@@ -93,6 +139,9 @@ struct mempool_multiple_s
   size_t                        dict_col_num_log2;
   size_t                        dict_row_num;
   FAR struct mpool_dict_s     **dict;
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+  FAR struct mpool_profile_s   *profile;     /* The allocation profile */
+#endif
 };
 
 /****************************************************************************
@@ -358,6 +407,127 @@ static void mempool_multiple_check(FAR struct mempool_s *pool,
   assert(mempool_multiple_get_dict(pool->priv, blk));
 }
 
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+
+/****************************************************************************
+ * Name: mempool_multiple_record
+ *
+ * Description:
+ *   Account one request in the allocation profile.
+ *
+ * Input Parameters:
+ *   mpool - The handle of the multiple memory pool to be used.
+ *   size  - The requested size.
+ *   pool  - The pool that served the request or NULL.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_record(FAR struct mempool_multiple_s *mpool,
+                                    size_t size, FAR struct mempool_s *pool)
+{
+  FAR struct mpool_profile_s *profile;
+  size_t ndx;
+
+  if (mpool == NULL || mpool->profile == NULL || !mpool->profile->enabled)
+    {
+      return;
+    }
+
+  profile = mpool->profile;
+  if (size > profile->maxsize)
+    {
+      profile->nmiss++;
+      return;
+    }
+
+  profile->hist[size != 0 ? (size - 1) / profile->granule : 0]++;
+
+  if (pool != NULL)
+    {
+      ndx = pool - mpool->pools;
+      if (pool->nalloc > profile->peak[ndx])
+        {
+          profile->peak[ndx] = pool->nalloc;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_binsize
+ *
+ * Description:
+ *   Get the largest request size counted by a bin of the profile.
+ *
+ ****************************************************************************/
+
+static size_t mempool_multiple_binsize(FAR struct mpool_profile_s *profile,
+                                       size_t bin)
+{
+  return MIN((bin + 1) * profile->granule, profile->maxsize);
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_segcost
+ *
+ * Description:
+ *   Get the waste of serving the requests of the bins first to last with
+ *   one size class, given the prefix sums of the histogram.
+ *
+ ****************************************************************************/
+
+static uint64_t mempool_multiple_segcost(FAR struct mpool_profile_s *profile,
+                                         FAR const uint64_t *count,
+                                         FAR const uint64_t *bytes,
+                                         size_t first, size_t last)
+{
+  return (uint64_t)mempool_multiple_binsize(profile, last) *
+         (count[last + 1] - count[first]) -
+         (bytes[last + 1] - bytes[first]);
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_expandwaste
+ *
+ * Description:
+ *   Get the memory that would be expanded but not used if every size class
+ *   held exactly its initial number of blocks.
+ *
+ ****************************************************************************/
+
+static uint64_t
+mempool_multiple_expandwaste(FAR struct mempool_sizeclass_s *classes,
+                             size_t nclasses, size_t expandsize)
+{
+  uint64_t waste = 0;
+  size_t blocksize;
+  size_t nblks;
+  size_t nexps;
+  size_t i;
+
+  for (i = 0; i < nclasses; i++)
+    {
+      /* Each expansion also holds the smallest block size as its header,
+       * see mempool_multiple_alloc_callback().
+       */
+
+      blocksize = MPOOL_REALBLOCKSIZE(classes[i].blocksize);
+      if (expandsize < classes[0].blocksize + MPOOL_EXPAND_HEADER +
+                       blocksize)
+        {
+          return UINT64_MAX;
+        }
+
+      nblks  = (expandsize - classes[0].blocksize - MPOOL_EXPAND_HEADER) /
+               blocksize;
+      nexps  = (MAX(classes[i].ninitial, 1) + nblks - 1) / nblks;
+      waste += (uint64_t)nexps * expandsize -
+               (uint64_t)classes[i].ninitial * blocksize;
+    }
+
+  return waste;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -452,6 +622,9 @@ mempool_multiple_init(FAR const char *name,
   mpool->npools = npools;
   mpool->minpoolsize = minpoolsize;
   mpool->delta = 0;
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+  mpool->profile = NULL;
+#endif
 
   for (i = 0; i < npools; i++)
     {
@@ -541,6 +714,7 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
   pool = mempool_multiple_find(mpool, size);
   if (pool == NULL)
     {
+      mempool_multiple_record(mpool, size, NULL);
       return NULL;
     }
 
@@ -551,11 +725,13 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
 
       if (blk)
         {
+          mempool_multiple_record(mpool, size, pool);
           return blk;
         }
     }
   while (++pool < end);
 
+  mempool_multiple_record(mpool, size, NULL);
   return NULL;
 }
 
@@ -889,6 +1065,444 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
 
   mempool_multiple_free_chunk(mpool, mpool->dict);
   mpool->dict = NULL;
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+  if (mpool->profile != NULL)
+    {
+      mpool->free(mpool->arg, mpool->profile);
+    }
+#endif
+
   nxrmutex_destroy(&mpool->lock);
   mpool->free(mpool->arg, mpool);
 }
+
+/****************************************************************************
+ * Name: mempool_multiple_reserve
+ *
+ * Description:
+ *   Fill the pools of a multiple memory pool with free blocks in advance,
+ *   so that the first allocations don't need to expand the pools.
+ *
+ * Input Parameters:
+ *   mpool    - The handle of multiple memory pool to be used.
+ *   ninitial - The number of blocks to reserve for each pool.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mempool_multiple_reserve(FAR struct mempool_multiple_s *mpool,
+                             FAR const size_t *ninitial)
+{
+  FAR sq_entry_t *blk;
+  sq_queue_t queue;
+  int ret = OK;
+  size_t i;
+  size_t j;
+
+  if (mpool == NULL || ninitial == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* The pools never give their expansions back, so allocating the blocks
+   * and releasing them again leaves them in the free queues.
+   */
+
+  for (i = 0; i < mpool->npools && ret == OK; i++)
+    {
+      sq_init(&queue);
+      for (j = 0; j < ninitial[i]; j++)
+        {
+          blk = mempool_allocate(mpool->pools + i);
+          if (blk == NULL)
+            {
+              ret = -ENOMEM;
+              break;
+            }
+
+          sq_addlast(blk, &queue);
+        }
+
+      while ((blk = sq_remfirst(&queue)) != NULL)
+        {
+          mempool_release(mpool->pools + i, blk);
+        }
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+
+/****************************************************************************
+ * Name: mempool_multiple_profile
+ *
+ * Description:
+ *   Start or stop recording the sizes requested from a multiple memory
+ *   pool.  Starting the recording clears the previous profile, stopping it
+ *   keeps the profile for mempool_multiple_suggest().
+ *
+ * Input Parameters:
+ *   mpool  - The handle of multiple memory pool to be used.
+ *   enable - Whether to record the requests.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mempool_multiple_profile(FAR struct mempool_multiple_s *mpool,
+                             bool enable)
+{
+  FAR struct mpool_profile_s *profile;
+  size_t granule = 0;
+  size_t maxsize = 0;
+  size_t nbins;
+  size_t size;
+  size_t tmp;
+  size_t i;
+
+  if (mpool == NULL)
+    {
+      return -EINVAL;
+    }
+
+  nxrmutex_lock(&mpool->lock);
+
+  /* The profile is allocated on first use and kept until the pool is
+   * deinitialized, so the allocation path never sees it disappear.
+   */
+
+  profile = mpool->profile;
+  if (profile == NULL && enable)
+    {
+      /* The size step is the greatest common divisor of the block sizes,
+       * so that every block size of the current table is resolved.
+       */
+
+      for (i = 0; i < mpool->npools; i++)
+        {
+          size = mpool->pools[i].blocksize;
+          maxsize = MAX(maxsize, size);
+          while (size != 0)
+            {
+              tmp     = granule % size;
+              granule = size;
+              size    = tmp;
+            }
+        }
+
+      granule = ALIGN_UP(granule, sizeof(uintptr_t));
+      while ((maxsize + granule - 1) / granule > MPOOL_PROFILE_MAXBINS)
+        {
+          granule <<= 1;
+        }
+
+      nbins   = (maxsize + granule - 1) / granule;
+      profile = mpool->alloc(mpool->arg, sizeof(uintptr_t),
+                             sizeof(struct mpool_profile_s) +
+                             nbins * sizeof(unsigned long) +
+                             mpool->npools * sizeof(size_t));
+      if (profile == NULL)
+        {
+          nxrmutex_unlock(&mpool->lock);
+          return -ENOMEM;
+        }
+
+      profile->enabled = false;
+      profile->granule = granule;
+      profile->nbins   = nbins;
+      profile->maxsize = maxsize;
+      profile->hist    = (FAR unsigned long *)(profile + 1);
+      profile->peak    = (FAR size_t *)(profile->hist + nbins);
+      mpool->profile   = profile;
+    }
+
+  if (profile != NULL)
+    {
+      if (enable)
+        {
+          profile->enabled = false;
+          profile->nmiss   = 0;
+          memset(profile->hist, 0, profile->nbins * sizeof(unsigned long));
+          memset(profile->peak, 0, mpool->npools * sizeof(size_t));
+        }
+
+      profile->enabled = enable;
+    }
+
+  nxrmutex_unlock(&mpool->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_suggest
+ *
+ * Description:
+ *   Compute the table of at most nclasses block sizes that minimizes the
+ *   internal fragmentation of the profiled requests, together with the
+ *   number of blocks to reserve per pool and the expand size.
+ *
+ *   The block sizes are chosen by dynamic programming over the histogram
+ *   of the requests.  The blocks to reserve split the peak usage of each
+ *   current pool between the new size classes in proportion to the
+ *   requests.  The expand size is the power of two near the current one
+ *   that wastes the least memory when the reserved blocks are expanded.
+ *
+ * Input Parameters:
+ *   mpool    - The handle of multiple memory pool to be used.
+ *   classes  - The location to return the suggested size classes, may be
+ *              NULL if only the summary is needed.
+ *   nclasses - The maximum number of size classes.
+ *   info     - The location to return the summary of the profile.
+ *
+ * Returned Value:
+ *   The number of suggested size classes; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t mempool_multiple_suggest(FAR struct mempool_multiple_s *mpool,
+                                 FAR struct mempool_sizeclass_s *classes,
+                                 size_t nclasses,
+                                 FAR struct mempool_profile_s *info)
+{
+  FAR struct mpool_profile_s *profile;
+  FAR struct mempool_s *pool;
+  FAR uint64_t *hist;
+  FAR uint64_t *peak;
+  FAR uint64_t *count;
+  FAR uint64_t *bytes;
+  FAR uint64_t *poolreq;
+  FAR uint64_t *cost;
+  FAR uint64_t *next;
+  FAR uint64_t *swap;
+  FAR uint16_t *ends;
+  FAR uint16_t *back;
+  FAR void *buf;
+  uint64_t share;
+  uint64_t best;
+  uint64_t seg;
+  size_t nends = 0;
+  size_t first;
+  size_t size;
+  size_t b;
+  size_t k;
+  size_t m;
+  size_t n;
+
+  if (mpool == NULL || info == NULL)
+    {
+      return -EINVAL;
+    }
+
+  memset(info, 0, sizeof(*info));
+  info->npools        = mpool->npools;
+  info->expandsize    = mpool->expandsize;
+  info->newexpandsize = mpool->expandsize;
+
+  /* The profile is kept until the pool is deinitialized and its layout
+   * does not change, only the counters need the lock.
+   */
+
+  nxrmutex_lock(&mpool->lock);
+  profile = mpool->profile;
+  nxrmutex_unlock(&mpool->lock);
+
+  if (profile == NULL)
+    {
+      return 0;
+    }
+
+  if (classes == NULL)
+    {
+      nclasses = 0;
+    }
+
+  /* Allocate the snapshot of the profile, the prefix sums of the
+   * histogram, the requests per current pool, the candidate class ends
+   * and the tables of the dynamic program.
+   */
+
+  n   = profile->nbins;
+  nclasses = MIN(nclasses, n);
+  buf = mpool->alloc(mpool->arg, sizeof(uint64_t),
+                     (3 * n + 2 * (n + 1) + 2 * mpool->npools) *
+                     sizeof(uint64_t) +
+                     (n + nclasses * n) * sizeof(uint16_t));
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hist    = buf;
+  peak    = hist + n;
+  count   = peak + mpool->npools;
+  bytes   = count + n + 1;
+  poolreq = bytes + n + 1;
+  cost    = poolreq + mpool->npools;
+  next    = cost + n;
+  ends    = (FAR uint16_t *)(next + n);
+  back    = ends + n;
+
+  /* Take a snapshot of the counters, so that the allocations and frees
+   * of the pool are not held up by the computation below.
+   */
+
+  nxrmutex_lock(&mpool->lock);
+
+  info->enabled = profile->enabled;
+  info->granule = profile->granule;
+  info->nmiss   = profile->nmiss;
+
+  for (b = 0; b < n; b++)
+    {
+      hist[b] = profile->hist[b];
+    }
+
+  for (b = 0; b < mpool->npools; b++)
+    {
+      peak[b] = profile->peak[b];
+    }
+
+  nxrmutex_unlock(&mpool->lock);
+
+  /* A size class only needs to end at a size that was requested, and the
+   * last one must cover the largest pool.  Also compute the waste of the
+   * current table while at it.
+   */
+
+  count[0] = 0;
+  bytes[0] = 0;
+  memset(poolreq, 0, mpool->npools * sizeof(uint64_t));
+
+  for (b = 0; b < n; b++)
+    {
+      size         = mempool_multiple_binsize(profile, b);
+      count[b + 1] = count[b] + hist[b];
+      bytes[b + 1] = bytes[b] + hist[b] * size;
+
+      pool = mempool_multiple_find(mpool, size);
+      if (pool != NULL && hist[b] != 0)
+        {
+          poolreq[pool - mpool->pools] += hist[b];
+          info->waste += hist[b] * (pool->blocksize - size);
+        }
+
+      if (hist[b] != 0 || b == n - 1)
+        {
+          ends[nends++] = b;
+        }
+    }
+
+  info->nalloc = count[n];
+  nclasses     = MIN(nclasses, nends);
+
+  if (nclasses == 0)
+    {
+      goto out;
+    }
+
+  /* cost[m] is the least waste of covering the sizes up to ends[m] with
+   * k + 1 size classes, back[] remembers where the last class started.
+   */
+
+  for (m = 0; m < nends; m++)
+    {
+      cost[m] = mempool_multiple_segcost(profile, count, bytes, 0,
+                                         ends[m]);
+    }
+
+  for (k = 1; k < nclasses; k++)
+    {
+      for (m = 0; m < nends; m++)
+        {
+          next[m] = UINT64_MAX;
+          for (first = k - 1; first < m; first++)
+            {
+              if (cost[first] == UINT64_MAX)
+                {
+                  continue;
+                }
+
+              seg = cost[first] +
+                    mempool_multiple_segcost(profile, count, bytes,
+                                             ends[first] + 1, ends[m]);
+              if (seg < next[m])
+                {
+                  next[m] = seg;
+                  back[k * n + m] = first;
+                }
+            }
+        }
+
+      swap = cost;
+      cost = next;
+      next = swap;
+    }
+
+  info->newwaste = cost[nends - 1];
+
+  /* Walk back from the largest class */
+
+  m = nends - 1;
+  for (k = nclasses; k-- > 0; )
+    {
+      first = k > 0 ? ends[back[k * n + m]] + 1 : 0;
+
+      classes[k].blocksize = mempool_multiple_binsize(profile, ends[m]);
+      classes[k].nalloc    = count[ends[m] + 1] - count[first];
+      classes[k].waste     = mempool_multiple_segcost(profile, count, bytes,
+                                                     first, ends[m]);
+
+      /* Split the peak usage of the current pools */
+
+      share = 0;
+      for (b = first; b <= ends[m]; b++)
+        {
+          pool = mempool_multiple_find(mpool,
+                                       mempool_multiple_binsize(profile, b));
+          if (pool != NULL && hist[b] != 0)
+            {
+              share += peak[pool - mpool->pools] * hist[b] *
+                       MPOOL_PROFILE_SCALE / poolreq[pool - mpool->pools];
+            }
+        }
+
+      classes[k].ninitial = (share + MPOOL_PROFILE_SCALE - 1) /
+                            MPOOL_PROFILE_SCALE;
+
+      if (k > 0)
+        {
+          m = back[k * n + m];
+        }
+    }
+
+  /* Pick the expand size from the powers of two around the current one,
+   * from a half of it to four times it.
+   */
+
+  best = UINT64_MAX;
+  for (b = 0; b < MPOOL_PROFILE_NEXPAND; b++)
+    {
+      size = (mpool->expandsize / 2) << b;
+      if (size == 0)
+        {
+          continue;
+        }
+
+      seg = mempool_multiple_expandwaste(classes, nclasses, size);
+      if (seg < best)
+        {
+          best = seg;
+          info->newexpandsize = size;
+        }
+    }
+
+out:
+  mpool->free(mpool->arg, buf);
+  return nclasses;
+}
+#endif
@@ -42,7 +42,7 @@
  * to handle the longest line generated by this logic.
  */
 
-#define MEMPOOLINFO_LINELEN 80
+#define MEMPOOLINFO_LINELEN 128
 
 /****************************************************************************
  * Private Types
@@ -142,9 +142,17 @@ static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
   offset    = filep->f_pos;
   procfile  = filep->f_priv;
   linesize  = procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
-                              "%13s%11s%9s%9s%9s%9s%9s\n", "", "total",
+                              "%13s%11s%9s%9s%9s%9s%9s"
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+                              "%9s%11s%9s%9s"
+#endif
+                              "\n", "", "total",
                               "bsize", "nused", "nfree", "nifree",
-                              "nwaiter");
+                              "nwaiter"
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+                              , "ncached", "nhit", "nrefill", "ndrain"
+#endif
+                              );
 
   copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
                             &offset);
@@ -163,11 +171,20 @@ static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
 
           mempool_info(pool, &minfo);
           linesize   = procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
-                                       "%12s:%11lu%9lu%9lu%9lu%9lu%9lu\n",
+                                       "%12s:%11lu%9lu%9lu%9lu%9lu%9lu"
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+                                       "%9lu%11lu%9lu%9lu"
+#endif
+                                       "\n",
                                        entry->name, minfo.arena,
                                        minfo.sizeblks, minfo.aordblks,
                                        minfo.ordblks, minfo.iordblks,
-                                       minfo.nwaiter);
+                                       minfo.nwaiter
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+                                       , minfo.ncached, minfo.nhit,
+                                       minfo.nrefill, minfo.ndrain
+#endif
+                                       );
           copysize   = procfs_memcpy(procfile->line, linesize, buffer,
                                      buflen, &offset);
           totalsize += copysize;
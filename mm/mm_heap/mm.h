@@ -31,6 +31,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/lib/math32.h>
 #include <nuttx/mm/mempool.h>
@@ -40,6 +41,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 
 /****************************************************************************
@@ -109,11 +111,33 @@
 #  define MM_ADD_BACKTRACE(heap, ptr)
 #endif
 
+/* The statistics need the perf counter and the system timer, so they are
+ * not collected for the user heap of a protected or kernel build.
+ */
+
+#if defined(CONFIG_MM_HEAP_FRAGSTATS) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HAVE_FRAGSTATS 1
+#endif
+
 /* All other definitions derive from these two */
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
-#define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+
+/* With the segregated-fit lists, each power of two (first level) is split
+ * into MM_SLI_COUNT bins (second level).  The last first level only holds
+ * the bin of the chunks larger than MM_MAX_CHUNK.
+ */
+
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+#  define MM_SLI_SHIFT   CONFIG_MM_HEAP_SEGREGATED_SHIFT
+#  define MM_SLI_COUNT   (1 << MM_SLI_SHIFT)
+#  define MM_FLI_COUNT   (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+#  define MM_NNODES      (((MM_FLI_COUNT - 1) << MM_SLI_SHIFT) + 1)
+#else
+#  define MM_NNODES      (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+#endif
 
 #define MM_GRAN_MASK     (MM_ALIGN - 1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
@@ -214,6 +238,38 @@ struct mm_delaynode_s
   FAR struct mm_delaynode_s *flink;
 };
 
+/* This describes the per-CPU cache of small, free chunks.  The chunks are
+ * kept in one list per size class, linked through their user memory.
+ */
+
+#ifdef CONFIG_MM_HEAP_MAGAZINE
+#  define MM_MAGAZINE_NCLASSES (CONFIG_MM_HEAP_MAGAZINE_MAXSIZE / MM_ALIGN)
+
+struct mm_magazine_s
+{
+  spinlock_t lock;                                    /* Protects the lists */
+  uint8_t count[MM_MAGAZINE_NCLASSES];                /* Chunks per class */
+  FAR struct mm_delaynode_s *head[MM_MAGAZINE_NCLASSES];
+};
+#endif
+
+#ifdef CONFIG_MM_HEAP_FRAGSTATS
+/* Fragmentation and latency statistics collected by malloc() and free() */
+
+struct mm_fragstats_s
+{
+  bool          enabled;                      /* Collection is active */
+  uint8_t       trendhead;                    /* Next slot of trend[] */
+  unsigned long allochist[MM_FRAG_NBUCKETS];  /* Requested sizes */
+  unsigned long alloclat[MM_FRAG_NBUCKETS];   /* malloc() latency */
+  unsigned long freelat[MM_FRAG_NBUCKETS];    /* free() latency */
+  unsigned long nfail;                        /* Failed allocations */
+  size_t        minlargest;                   /* Low-water mark of largest */
+  size_t        trend[MM_FRAG_NTREND];        /* Samples of largest */
+  clock_t       lastsample;                   /* Time of the last sample */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -250,6 +306,13 @@ struct mm_heap_s
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
 
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+  /* Bitmaps of the non-empty first level and second level bins */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_FLI_COUNT];
+#endif
+
   /* Free delay list, as sometimes we can't do free immdiately. */
 
   FAR struct mm_delaynode_s *mm_delaylist[CONFIG_SMP_NCPUS];
@@ -258,6 +321,16 @@ struct mm_heap_s
   size_t mm_delaycount[CONFIG_SMP_NCPUS];
 #endif
 
+  /* Per-CPU caches of small chunks, used without taking mm_lock */
+
+#ifdef CONFIG_MM_HEAP_MAGAZINE
+  struct mm_magazine_s mm_magazine[CONFIG_SMP_NCPUS];
+#endif
+
+#ifdef CONFIG_MM_HEAP_FRAGSTATS
+  struct mm_fragstats_s mm_fragstats;
+#endif
+
   /* The is a multiple mempool of the heap */
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
@@ -300,21 +373,98 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
 
+/* Functions contained in mm_magazine.c *************************************/
+
+#if defined(CONFIG_MM_HEAP_MAGAZINE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+FAR void *mm_magazine_alloc(FAR struct mm_heap_s *heap, size_t alignsize);
+bool mm_magazine_free(FAR struct mm_heap_s *heap, FAR void *mem);
+bool mm_magazine_flush(FAR struct mm_heap_s *heap);
+size_t mm_magazine_cached(FAR struct mm_heap_s *heap,
+                          FAR size_t *nblocks);
+#else
+#  define mm_magazine_alloc(heap, alignsize) NULL
+#  define mm_magazine_free(heap, mem)        false
+#  define mm_magazine_flush(heap)            false
+#  define mm_magazine_cached(heap, nblocks)  0
+#endif
+
+/* Functions contained in mm_fragstats.c ***********************************/
+
+#ifdef MM_HAVE_FRAGSTATS
+void mm_fragstats_alloc(FAR struct mm_heap_s *heap, size_t size,
+                        FAR void *mem, clock_t start);
+void mm_fragstats_free(FAR struct mm_heap_s *heap, clock_t start);
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
 
 static inline_function int mm_size2ndx(size_t size)
 {
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+  int fl;
+  int sl;
+#endif
+
   DEBUGASSERT(size >= MM_MIN_CHUNK);
   if (size >= MM_MAX_CHUNK)
     {
       return MM_NNODES - 1;
     }
 
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+  /* The first level is the power of two of the size, the second level is
+   * taken from the bits just below the most significant one.
+   */
+
+  fl = flsl(size) - 1;
+  if (fl >= MM_SLI_SHIFT)
+    {
+      sl = (size >> (fl - MM_SLI_SHIFT)) & (MM_SLI_COUNT - 1);
+    }
+  else
+    {
+      sl = (size << (MM_SLI_SHIFT - fl)) & (MM_SLI_COUNT - 1);
+    }
+
+  return ((fl - MM_MIN_SHIFT) << MM_SLI_SHIFT) + sl;
+#else
   size >>= MM_MIN_SHIFT;
   return flsl(size) - 1;
+#endif
+}
+
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+/* Find the first non-empty bin with an index not less than ndx, or return
+ * -1 if there is none.
+ */
+
+static inline_function int mm_findbin(FAR struct mm_heap_s *heap, int ndx)
+{
+  int fl = ndx >> MM_SLI_SHIFT;
+  int sl = ndx & (MM_SLI_COUNT - 1);
+  uint32_t map;
+
+  map = heap->mm_slbitmap[fl] & (UINT32_MAX << sl);
+  if (map == 0)
+    {
+      /* Nothing left in this first level, try the next non-empty one */
+
+      map = heap->mm_flbitmap & (UINT32_MAX << fl << 1);
+      if (map == 0)
+        {
+          return -1;
+        }
+
+      fl  = ffs(map) - 1;
+      map = heap->mm_slbitmap[fl];
+    }
+
+  return (fl << MM_SLI_SHIFT) + ffs(map) - 1;
 }
+#endif
 
 static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
                                             FAR struct mm_freenode_s *node)
@@ -350,6 +500,48 @@ static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
 
       next->blink = node;
     }
+
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+  heap->mm_slbitmap[ndx >> MM_SLI_SHIFT] |= 1u << (ndx & (MM_SLI_COUNT - 1));
+  heap->mm_flbitmap |= 1u << (ndx >> MM_SLI_SHIFT);
+#endif
+}
+
+static inline_function void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                                            FAR struct mm_freenode_s *node)
+{
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+  int ndx;
+#endif
+
+  /* Remove the node.  There must be a predecessor, but there may not be
+   * a successor node.
+   */
+
+  DEBUGASSERT(node->blink);
+  node->blink->flink = node->flink;
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+  /* The bin is empty if the node was between two list heads (they are the
+   * only nodes of size zero).
+   */
+
+  if (node->blink->size == 0 && (node->flink == NULL ||
+                                 node->flink->size == 0))
+    {
+      ndx = mm_size2ndx(MM_SIZEOF_NODE(node));
+      heap->mm_slbitmap[ndx >> MM_SLI_SHIFT] &=
+        ~(1u << (ndx & (MM_SLI_COUNT - 1)));
+      if (heap->mm_slbitmap[ndx >> MM_SLI_SHIFT] == 0)
+        {
+          heap->mm_flbitmap &= ~(1u << (ndx >> MM_SLI_SHIFT));
+        }
+    }
+#endif
 }
 
 #endif /* __MM_MM_HEAP_MM_H */
@@ -0,0 +1,263 @@
+/****************************************************************************
+ * mm/mm_heap/mm_fragstats.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <string.h>
+#include <strings.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef MM_HAVE_FRAGSTATS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FRAGSTATS_INTERVAL MSEC2TICK(CONFIG_MM_HEAP_FRAGSTATS_INTERVAL)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fragstats_bucket
+ *
+ * Description:
+ *   Map a value to its power of two histogram bucket.
+ *
+ ****************************************************************************/
+
+static int fragstats_bucket(size_t value)
+{
+  int ndx = value != 0 ? flsl(value) : 0;
+
+  return ndx < MM_FRAG_NBUCKETS ? ndx : MM_FRAG_NBUCKETS - 1;
+}
+
+/****************************************************************************
+ * Name: fragstats_sample
+ *
+ * Description:
+ *   Record the current size of the largest free chunk.
+ *
+ ****************************************************************************/
+
+static void fragstats_sample(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_fragstats_s *stats = &heap->mm_fragstats;
+  size_t largest;
+
+  if (mm_lock(heap) < 0)
+    {
+      return;
+    }
+
+  largest = mm_heapfree_largest(heap);
+  mm_unlock(heap);
+
+  if (largest < stats->minlargest)
+    {
+      stats->minlargest = largest;
+    }
+
+  stats->trend[stats->trendhead] = largest;
+  stats->trendhead = (stats->trendhead + 1) % MM_FRAG_NTREND;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_fragstats_alloc
+ *
+ * Description:
+ *   Account one allocation request.  Called by mm_malloc() if the
+ *   collection is enabled.
+ *
+ * Input Parameters:
+ *   heap  - The heap
+ *   size  - The requested size
+ *   mem   - The allocated memory or NULL if the allocation failed
+ *   start - The perf counter when the request was made
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_fragstats_alloc(FAR struct mm_heap_s *heap, size_t size,
+                        FAR void *mem, clock_t start)
+{
+  FAR struct mm_fragstats_s *stats = &heap->mm_fragstats;
+  clock_t now;
+
+  stats->alloclat[fragstats_bucket(perf_gettime() - start)]++;
+  stats->allochist[fragstats_bucket(size)]++;
+
+  /* Sample the largest free chunk periodically and on every failure */
+
+  now = clock_systime_ticks();
+  if (mem == NULL)
+    {
+      stats->nfail++;
+    }
+  else if (now - stats->lastsample < FRAGSTATS_INTERVAL)
+    {
+      return;
+    }
+
+  stats->lastsample = now;
+  fragstats_sample(heap);
+}
+
+/****************************************************************************
+ * Name: mm_fragstats_free
+ *
+ * Description:
+ *   Account one free request.  Called by mm_free() if the collection is
+ *   enabled.
+ *
+ * Input Parameters:
+ *   heap  - The heap
+ *   start - The perf counter when the request was made
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_fragstats_free(FAR struct mm_heap_s *heap, clock_t start)
+{
+  heap->mm_fragstats.freelat[fragstats_bucket(perf_gettime() - start)]++;
+}
+
+/****************************************************************************
+ * Name: mm_fragstats_enable
+ *
+ * Description:
+ *   Start or stop collecting the fragmentation statistics of the heap.
+ *   Starting the collection clears the previous statistics, stopping it
+ *   keeps them for mm_fraginfo().
+ *
+ * Input Parameters:
+ *   heap   - The heap
+ *   enable - Whether to collect the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_fragstats_enable(FAR struct mm_heap_s *heap, bool enable)
+{
+  FAR struct mm_fragstats_s *stats = &heap->mm_fragstats;
+
+  if (enable)
+    {
+      memset(stats, 0, sizeof(*stats));
+      stats->minlargest = SIZE_MAX;
+      stats->lastsample = clock_systime_ticks();
+      fragstats_sample(heap);
+    }
+
+  stats->enabled = enable;
+}
+
+/****************************************************************************
+ * Name: mm_fraginfo
+ *
+ * Description:
+ *   Get the fragmentation statistics of the heap together with a snapshot
+ *   of the free chunk size distribution.
+ *
+ * Input Parameters:
+ *   heap - The heap
+ *   info - The location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_fraginfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_fraginfo_s *info)
+{
+  FAR struct mm_fragstats_s *stats = &heap->mm_fragstats;
+  FAR struct mm_freenode_s *node;
+  size_t nodesize;
+  int i;
+
+  DEBUGASSERT(info != NULL);
+  memset(info, 0, sizeof(*info));
+
+  info->enabled = stats->enabled;
+  info->nfail   = stats->nfail;
+  memcpy(info->allochist, stats->allochist, sizeof(info->allochist));
+  memcpy(info->alloclat, stats->alloclat, sizeof(info->alloclat));
+  memcpy(info->freelat, stats->freelat, sizeof(info->freelat));
+
+  /* Report the samples of the largest free chunk oldest first */
+
+  for (i = 0; i < MM_FRAG_NTREND; i++)
+    {
+      info->trend[i] = stats->trend[(stats->trendhead + i) %
+                                    MM_FRAG_NTREND];
+    }
+
+  info->perffreq = perf_getfreq();
+
+  /* Walk the free list, the size 0 nodes are the list heads */
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  for (node = heap->mm_nodelist[0].flink; node != NULL; node = node->flink)
+    {
+      nodesize = MM_SIZEOF_NODE(node);
+      if (nodesize != 0)
+        {
+          info->freehist[fragstats_bucket(nodesize)]++;
+          info->freesize += nodesize;
+          info->nfree++;
+          if (nodesize > info->largest)
+            {
+              info->largest = nodesize;
+            }
+        }
+    }
+
+  mm_unlock(heap);
+
+  info->minlargest = stats->minlargest < info->largest ?
+                     stats->minlargest : info->largest;
+}
+
+#endif /* MM_HAVE_FRAGSTATS */
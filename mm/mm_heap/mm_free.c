@@ -30,6 +30,7 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/sched.h>
 #include <nuttx/mm/mm.h>
 #include <nuttx/mm/kasan.h>
@@ -160,16 +161,9 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
       DEBUGASSERT(MM_PREVNODE_IS_FREE(andbeyond) &&
                   andbeyond->preceding == nextsize);
 
-      /* Remove the next node.  There must be a predecessor,
-       * but there may not be a successor node.
-       */
+      /* Remove the next node from the free list */
 
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_delfreechunk(heap, next);
 
       /* Then merge the two chunks */
 
@@ -195,16 +189,9 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
       prevsize = MM_SIZEOF_NODE(prev);
       DEBUGASSERT(MM_NODE_IS_FREE(prev) && node->preceding == prevsize);
 
-      /* Remove the node.  There must be a predecessor, but there may
-       * not be a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
+      mm_delfreechunk(heap, prev);
 
       /* Then merge the two chunks */
 
@@ -221,7 +208,7 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
 }
 
 /****************************************************************************
- * Name: mm_free
+ * Name: free_internal
  *
  * Description:
  *   Returns a chunk of memory to the list of free nodes,  merging with
@@ -229,7 +216,7 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
  *
  ****************************************************************************/
 
-void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+static void free_internal(FAR struct mm_heap_s *heap, FAR void *mem)
 {
   minfo("Freeing %p\n", mem);
 
@@ -252,5 +239,39 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
     }
 #endif
 
+#ifdef CONFIG_MM_HEAP_MAGAZINE
+  /* Keep small chunks in the magazine of this CPU for quick reuse */
+
+  if (mm_magazine_free(heap, mem))
+    {
+      return;
+    }
+#endif
+
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
 }
+
+/****************************************************************************
+ * Name: mm_free
+ *
+ * Description:
+ *   Returns a chunk of memory to the list of free nodes,  merging with
+ *   adjacent free chunks if possible.
+ *
+ ****************************************************************************/
+
+void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#ifdef MM_HAVE_FRAGSTATS
+  if (heap->mm_fragstats.enabled && mem != NULL)
+    {
+      clock_t start = perf_gettime();
+
+      free_internal(heap, mem);
+      mm_fragstats_free(heap, start);
+      return;
+    }
+#endif
+
+  free_internal(heap, mem);
+}
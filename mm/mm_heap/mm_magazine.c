@@ -0,0 +1,370 @@
+/****************************************************************************
+ * mm/mm_heap/mm_magazine.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/sched_note.h>
+
+#include "mm_heap/mm.h"
+
+/* The magazines can only be used where interrupts can be disabled, i.e. not
+ * for the user heap of a protected or kernel build.
+ */
+
+#if defined(CONFIG_MM_HEAP_MAGAZINE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Map a chunk size to its size class */
+
+#define MM_MAGAZINE_CLASS(size) ((size) / MM_ALIGN - 1)
+
+/* Marks the user memory of a cached chunk, see mm_magazine_iscached() */
+
+#define MM_MAGAZINE_MAGIC       ((uintptr_t)0x4d41475a)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A chunk cached in a magazine.  It is still allocated from the heap's
+ * point of view, so the magic in its user memory is what tells a second
+ * free of it apart.  Every chunk has room for the two words.
+ */
+
+struct mm_magnode_s
+{
+  struct mm_delaynode_s node;
+  uintptr_t             magic;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_magazine_iscached
+ *
+ * Description:
+ *   Check if a chunk is already cached in the magazine of any CPU.  Only
+ *   chunks that carry the magic are looked up, the magazines are short.
+ *
+ ****************************************************************************/
+
+static bool mm_magazine_iscached(FAR struct mm_heap_s *heap, int ndx,
+                                 FAR struct mm_magnode_s *mem)
+{
+  FAR struct mm_magazine_s *mag;
+  FAR struct mm_delaynode_s *tmp;
+  irqstate_t flags;
+  bool found = false;
+  int cpu;
+
+  if (mem->magic != MM_MAGAZINE_MAGIC)
+    {
+      return false;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && !found; cpu++)
+    {
+      mag   = &heap->mm_magazine[cpu];
+      flags = spin_lock_irqsave_notrace(&mag->lock);
+
+      for (tmp = mag->head[ndx]; tmp != NULL; tmp = tmp->flink)
+        {
+          if (tmp == &mem->node)
+            {
+              found = true;
+              break;
+            }
+        }
+
+      spin_unlock_irqrestore_notrace(&mag->lock, flags);
+    }
+
+  return found;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_magazine_alloc
+ *
+ * Description:
+ *   Take a chunk of exactly the given size from the magazine of the
+ *   current CPU.  This does not take the heap mutex.
+ *
+ * Input Parameters:
+ *   heap      - The heap
+ *   alignsize - The chunk size, including the allocation node overhead
+ *
+ * Returned Value:
+ *   The user memory of the chunk or NULL if the magazine is empty.
+ *
+ ****************************************************************************/
+
+FAR void *mm_magazine_alloc(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  FAR struct mm_magazine_s *mag;
+  FAR struct mm_delaynode_s *mem;
+  FAR struct mm_allocnode_s *node;
+  irqstate_t flags;
+  int ndx;
+
+  if (alignsize > CONFIG_MM_HEAP_MAGAZINE_MAXSIZE)
+    {
+      return NULL;
+    }
+
+  ndx   = MM_MAGAZINE_CLASS(alignsize);
+  flags = up_irq_save();
+  mag   = &heap->mm_magazine[this_cpu()];
+
+  spin_lock_notrace(&mag->lock);
+  mem = mag->head[ndx];
+  if (mem != NULL)
+    {
+      mag->head[ndx] = mem->flink;
+      mag->count[ndx]--;
+    }
+
+  spin_unlock_notrace(&mag->lock);
+  up_irq_restore(flags);
+
+  if (mem == NULL)
+    {
+      return NULL;
+    }
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem -
+                                       MM_SIZEOF_ALLOCNODE);
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node) &&
+              MM_SIZEOF_NODE(node) == alignsize);
+
+  ((FAR struct mm_magnode_s *)mem)->magic = 0;
+
+  MM_ADD_BACKTRACE(heap, node);
+  sched_note_heap(NOTE_HEAP_ALLOC, heap, mem, alignsize, heap->mm_curused);
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(mem, MM_ALLOC_MAGIC, alignsize - MM_ALLOCNODE_OVERHEAD);
+#endif
+
+  return mem;
+}
+
+/****************************************************************************
+ * Name: mm_magazine_free
+ *
+ * Description:
+ *   Put a small chunk into the magazine of the current CPU instead of
+ *   returning it to the heap.  The chunk stays allocated from the heap's
+ *   point of view.  This does not take the heap mutex.
+ *
+ * Input Parameters:
+ *   heap - The heap
+ *   mem  - The user memory of the chunk
+ *
+ * Returned Value:
+ *   true if the chunk was cached, false if the caller must free it.
+ *
+ ****************************************************************************/
+
+bool mm_magazine_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_magazine_s *mag;
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_magnode_s *tmp = mem;
+  irqstate_t flags;
+  size_t nodesize;
+  bool ret = false;
+  int ndx;
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem -
+                                       MM_SIZEOF_ALLOCNODE);
+  nodesize = MM_SIZEOF_NODE(node);
+
+  /* Sanity check against double-frees */
+
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node));
+
+  if (nodesize > CONFIG_MM_HEAP_MAGAZINE_MAXSIZE)
+    {
+      return false;
+    }
+
+  ndx = MM_MAGAZINE_CLASS(nodesize);
+
+  /* The chunk header cannot tell a cached chunk, catch a double-free
+   * here, it would hand out the chunk twice otherwise.
+   */
+
+  if (mm_magazine_iscached(heap, ndx, tmp))
+    {
+      DEBUGPANIC();
+      return true;
+    }
+
+  flags = up_irq_save();
+  mag   = &heap->mm_magazine[this_cpu()];
+
+  spin_lock_notrace(&mag->lock);
+  if (mag->count[ndx] < CONFIG_MM_HEAP_MAGAZINE_DEPTH)
+    {
+      tmp->node.flink = mag->head[ndx];
+      tmp->magic      = MM_MAGAZINE_MAGIC;
+      mag->head[ndx]  = &tmp->node;
+      mag->count[ndx]++;
+      ret = true;
+    }
+
+  spin_unlock_notrace(&mag->lock);
+  up_irq_restore(flags);
+
+  if (ret)
+    {
+#if CONFIG_MM_BACKTRACE >= 0
+      /* Don't report the cached chunk as a leak of the last owner */
+
+      node->pid = PID_MM_MEMPOOL;
+#endif
+
+      sched_note_heap(NOTE_HEAP_FREE, heap, mem, nodesize,
+                      heap->mm_curused);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_magazine_flush
+ *
+ * Description:
+ *   Return all chunks cached in the magazines of all CPUs to the heap.
+ *
+ * Input Parameters:
+ *   heap - The heap
+ *
+ * Returned Value:
+ *   true if any chunk was returned to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_magazine_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_magazine_s *mag;
+  FAR struct mm_delaynode_s *mem;
+  FAR struct mm_delaynode_s *next;
+  irqstate_t flags;
+  bool ret = false;
+  int cpu;
+  int ndx;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      mag = &heap->mm_magazine[cpu];
+
+      for (ndx = 0; ndx < MM_MAGAZINE_NCLASSES; ndx++)
+        {
+          /* Detach the whole class, then free it without the lock held */
+
+          flags = spin_lock_irqsave_notrace(&mag->lock);
+          mem = mag->head[ndx];
+          mag->head[ndx]  = NULL;
+          mag->count[ndx] = 0;
+          spin_unlock_irqrestore_notrace(&mag->lock, flags);
+
+          for (; mem != NULL; mem = next)
+            {
+              next = mem->flink;
+              ((FAR struct mm_magnode_s *)mem)->magic = 0;
+              mm_delayfree(heap, mem, false);
+              ret = true;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_magazine_cached
+ *
+ * Description:
+ *   Get the amount of memory cached in the magazines of all CPUs.  The
+ *   result is a snapshot used for the heap statistics.
+ *
+ * Input Parameters:
+ *   heap    - The heap
+ *   nblocks - The location to return the number of cached chunks, may be
+ *             NULL.
+ *
+ * Returned Value:
+ *   The number of bytes cached.
+ *
+ ****************************************************************************/
+
+size_t mm_magazine_cached(FAR struct mm_heap_s *heap,
+                          FAR size_t *nblocks)
+{
+  FAR struct mm_magazine_s *mag;
+  size_t cached = 0;
+  size_t count = 0;
+  int cpu;
+  int ndx;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      mag = &heap->mm_magazine[cpu];
+
+      for (ndx = 0; ndx < MM_MAGAZINE_NCLASSES; ndx++)
+        {
+          count  += mag->count[ndx];
+          cached += (size_t)mag->count[ndx] * (ndx + 1) * MM_ALIGN;
+        }
+    }
+
+  if (nblocks != NULL)
+    {
+      *nblocks = count;
+    }
+
+  return cached;
+}
+
+#endif /* CONFIG_MM_HEAP_MAGAZINE && (CONFIG_BUILD_FLAT || __KERNEL__) */
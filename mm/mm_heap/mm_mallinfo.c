@@ -131,6 +131,10 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   struct mallinfo poolinfo;
 #endif
+#ifdef CONFIG_MM_HEAP_MAGAZINE
+  size_t nblocks = 0;
+  size_t cached;
+#endif
 
   memset(&info, 0, sizeof(info));
   mm_foreach(heap, mallinfo_handler, &info);
@@ -146,6 +150,19 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
   info.fordblks += poolinfo.fordblks;
 #endif
 
+#ifdef CONFIG_MM_HEAP_MAGAZINE
+  /* The chunks cached in the magazines are allocated from the heap's
+   * point of view, but they are free for the user.
+   */
+
+  cached = mm_magazine_cached(heap, &nblocks);
+
+  info.aordblks -= nblocks;
+  info.uordblks -= cached;
+  info.ordblks  += nblocks;
+  info.fordblks += cached;
+#endif
+
   DEBUGASSERT(info.uordblks + info.fordblks == info.arena);
 
   return info;
@@ -190,7 +207,12 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 
 size_t mm_heapfree(FAR struct mm_heap_s *heap)
 {
+#ifdef CONFIG_MM_HEAP_MAGAZINE
+  return heap->mm_heapsize - heap->mm_curused +
+         mm_magazine_cached(heap, NULL);
+#else
   return heap->mm_heapsize - heap->mm_curused;
+#endif
 }
 
 /****************************************************************************
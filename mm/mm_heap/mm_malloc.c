@@ -31,6 +31,7 @@
 #include <string.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/mm/mm.h>
 #include <nuttx/mm/kasan.h>
 #include <nuttx/sched.h>
@@ -157,17 +158,15 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap)
 }
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: malloc_internal
  *
  * Description:
  *  Find the smallest chunk that satisfies the request. Take the memory from
  *  that chunk, save the remaining, smaller chunk (if any).
  *
- *  8-byte alignment of the allocated data is assured.
- *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+static FAR void *malloc_internal(FAR struct mm_heap_s *heap, size_t size)
 {
   FAR struct mm_freenode_s *node;
   size_t alignsize;
@@ -210,6 +209,16 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   DEBUGASSERT(alignsize >= MM_ALIGN);
 
+#ifdef CONFIG_MM_HEAP_MAGAZINE
+  /* Try the magazine of this CPU first, it doesn't need the MM mutex */
+
+  ret = mm_magazine_alloc(heap, alignsize);
+  if (ret != NULL)
+    {
+      return ret;
+    }
+#endif
+
   /* We need to hold the MM mutex while we muck with the nodelist. */
 
   DEBUGVERIFY(mm_lock(heap));
@@ -223,7 +232,27 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
    * other mm_nodelist[] entries.
    */
 
-  for (node = heap->mm_nodelist[ndx].flink; node; node = node->flink)
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+  /* Only the bin of the request size may hold chunks that are too small.
+   * Its last chunk is the one just before the head of the next bin.  If
+   * even that one is too small, take the smallest chunk of the next
+   * non-empty bin, which is found with the bitmaps.  The chunks of the
+   * last bin are not bounded in size, so that one is always searched.
+   */
+
+  if (ndx < MM_NNODES - 1 &&
+      MM_SIZEOF_NODE(heap->mm_nodelist[ndx + 1].blink) < alignsize)
+    {
+      ndx  = mm_findbin(heap, ndx + 1);
+      node = ndx < 0 ? NULL : heap->mm_nodelist[ndx].flink;
+    }
+  else
+#endif
+    {
+      node = heap->mm_nodelist[ndx].flink;
+    }
+
+  for (; node; node = node->flink)
     {
       DEBUGASSERT(node->blink->flink == node);
       nodesize = MM_SIZEOF_NODE(node);
@@ -244,16 +273,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Get a pointer to the next node in physical memory */
 
@@ -342,12 +364,21 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 #endif
     }
 
+#ifdef CONFIG_MM_HEAP_MAGAZINE
+  /* Try again after returning the cached chunks to the heap */
+
+  else if (mm_magazine_flush(heap))
+    {
+      return malloc_internal(heap, size);
+    }
+#endif
+
 #if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
   /* Try again after free delay list */
 
   else if (free_delaylist(heap, true))
     {
-      return mm_malloc(heap, size);
+      return malloc_internal(heap, size);
     }
 #endif
 
@@ -411,3 +442,30 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   DEBUGASSERT(ret == NULL || ((uintptr_t)ret) % MM_ALIGN == 0);
   return ret;
 }
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+#ifdef MM_HAVE_FRAGSTATS
+  if (heap->mm_fragstats.enabled)
+    {
+      clock_t start = perf_gettime();
+      FAR void *ret = malloc_internal(heap, size);
+
+      mm_fragstats_alloc(heap, size, ret, start);
+      return ret;
+    }
+#endif
+
+  return malloc_internal(heap, size);
+}
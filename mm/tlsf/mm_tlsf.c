@@ -1072,6 +1072,7 @@ mm_initialize_pool(FAR const char *name,
       def.chunksize       = CONFIG_MM_HEAP_MEMPOOL_CHUNK_SIZE;
       def.expandsize      = CONFIG_MM_HEAP_MEMPOOL_EXPAND_SIZE;
       def.dict_expendsize = CONFIG_MM_HEAP_MEMPOOL_DICTIONARY_EXPAND_SIZE;
+      def.ninitial        = NULL;
 
       init = &def;
     }
@@ -1091,6 +1092,25 @@ mm_initialize_pool(FAR const char *name,
                                (mempool_multiple_free_t)mm_free, heap,
                                init->chunksize, init->expandsize,
                                init->dict_expendsize);
+
+      /* Reserve the blocks of a table generated from a profile, the heap
+       * still works without them.
+       */
+
+      if (heap->mm_mpool != NULL && init->ninitial != NULL)
+        {
+          int ret = mempool_multiple_reserve(heap->mm_mpool,
+                                             init->ninitial);
+          if (ret < 0)
+            {
+              mwarn("WARNING: Failed to reserve the pool blocks: %d\n",
+                    ret);
+            }
+        }
+
+#ifdef CONFIG_MM_MEMPOOL_PROFILE
+      heap->mm_procfs.mpool = heap->mm_mpool;
+#endif
     }
 
   return heap;
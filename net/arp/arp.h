@@ -46,6 +46,7 @@
 #include <netinet/in.h>
 
 #include <nuttx/net/netdev.h>
+#include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 
 #include "devif/devif.h"
@@ -68,6 +69,18 @@
 #  define CONFIG_ARP_SEND_DELAYMSEC 20
 #endif
 
+#ifndef CONFIG_NET_ARP_ALLOC_ENTRIES
+#  define CONFIG_NET_ARP_ALLOC_ENTRIES 0
+#endif
+
+/* The maximum number of entries in the ARP table */
+
+#if CONFIG_NET_ARP_ALLOC_ENTRIES > 0
+#  define ARP_TABLE_SIZE CONFIG_NET_ARP_MAX_ENTRIES
+#else
+#  define ARP_TABLE_SIZE CONFIG_NET_ARPTAB_SIZE
+#endif
+
 /* ARP Definitions **********************************************************/
 
 #define ARP_REQUEST    1
@@ -161,6 +174,8 @@ struct arp_notify_s
 
 struct arp_entry_s
 {
+  dq_entry_t               at_hash;     /* Link in its hash bucket */
+  dq_entry_t               at_lru;      /* Link in the list by at_time */
   in_addr_t                at_ipaddr;   /* IP address */
   struct ether_addr        at_ethaddr;  /* Hardware address */
   clock_t                  at_time;     /* Time of last usage */
@@ -59,10 +59,12 @@
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/ip.h>
 
 #include "netdev/netdev.h"
 #include "netlink/netlink.h"
+#include "utils/utils.h"
 #include "arp/arp.h"
 
 #ifdef CONFIG_NET_ARP
@@ -73,6 +75,26 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+#ifndef CONFIG_NET_ARP_MAX_ENTRIES
+#  define CONFIG_NET_ARP_MAX_ENTRIES 0
+#endif
+
+#if (CONFIG_NET_ARP_HASHSIZE & (CONFIG_NET_ARP_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_ARP_HASHSIZE must be a power of two
+#endif
+
+/* Map an IP address to a bucket of the hash table.  The address is hashed
+ * in host order, so that the host part of a subnet changes the low bits of
+ * the key.  The bucket is taken from the top bits of the product
+ * (Fibonacci hashing), which all the bits of the key contribute to.
+ */
+
+#define ARP_HASH_BUCKET(ipaddr) \
+        ((uint32_t)(((uint64_t)(uint32_t)(NTOHL(ipaddr) * 2654435761u) * \
+                     CONFIG_NET_ARP_HASHSIZE) >> 32))
+
+#define ARP_HASH(ipaddr) (&g_arp_hash[ARP_HASH_BUCKET(ipaddr)])
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -87,9 +109,22 @@ struct arp_table_info_s
  * Private Data
  ****************************************************************************/
 
-/* The table of known address mappings */
+/* The entries of the table of known address mappings */
+
+NET_BUFPOOL_DECLARE(g_arp_entries, sizeof(struct arp_entry_s),
+                    CONFIG_NET_ARPTAB_SIZE, CONFIG_NET_ARP_ALLOC_ENTRIES,
+                    CONFIG_NET_ARP_MAX_ENTRIES);
+
+/* The entries in use, hashed by their IP address */
 
-static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static dq_queue_t g_arp_hash[CONFIG_NET_ARP_HASHSIZE];
+
+/* The entries in use in the order of their last update, the least recently
+ * updated one first.  As all entries have the same lifetime, the expired
+ * entries are always at the head of this list.
+ */
+
+static dq_queue_t g_arp_lru;
 
 static const struct ether_addr g_zero_ethaddr =
 {
@@ -149,32 +184,79 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_entry
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Get the ARP table entry from one of its list links.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static inline FAR struct arp_entry_s *arp_entry(FAR dq_entry_t *node,
+                                                bool lru)
 {
-  if (e1->at_ipaddr == 0)
-    {
-      return e1;
-    }
-  else if (e2->at_ipaddr == 0)
+  if (node == NULL)
     {
-      return e2;
+      return NULL;
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
-    {
-      return e1;
-    }
-  else
+
+  return lru ? container_of(node, struct arp_entry_s, at_lru) :
+               container_of(node, struct arp_entry_s, at_hash);
+}
+
+/****************************************************************************
+ * Name: arp_expired
+ ****************************************************************************/
+
+static inline bool arp_expired(FAR struct arp_entry_s *tabptr, clock_t now)
+{
+  return now - tabptr->at_time > ARP_MAXAGE_TICK;
+}
+
+/****************************************************************************
+ * Name: arp_search
+ *
+ * Description:
+ *   Find the ARP entry corresponding to this IP address in the ARP table,
+ *   expired or not.
+ *
+ * Input Parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *   dev    - Device structure
+ *
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_search(in_addr_t ipaddr,
+                                          FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+  FAR dq_entry_t *node;
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.arp.lookups++;
+#endif
+
+  for (node = dq_peek(ARP_HASH(ipaddr)); node != NULL; node = dq_next(node))
     {
-      return e2;
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.arp.probes++;
+#endif
+
+      tabptr = arp_entry(node, false);
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
     }
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.arp.misses++;
+#endif
+
+  return NULL;
 }
 
 /****************************************************************************
@@ -197,19 +279,13 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_search(ipaddr, dev);
+  if (tabptr != NULL && !arp_expired(tabptr, clock_systime_ticks()))
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-        {
-          return tabptr;
-        }
+      return tabptr;
     }
 
   /* Not found */
@@ -217,6 +293,21 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: arp_free
+ *
+ * Description:
+ *   Remove an entry from the ARP table and return it to the pool.
+ *
+ ****************************************************************************/
+
+static void arp_free(FAR struct arp_entry_s *tabptr)
+{
+  dq_rem(&tabptr->at_hash, ARP_HASH(tabptr->at_ipaddr));
+  dq_rem(&tabptr->at_lru, &g_arp_lru);
+  NET_BUFPOOL_FREE(g_arp_entries, tabptr);
+}
+
 /****************************************************************************
  * Name: arp_get_arpreq
  *
@@ -247,6 +338,72 @@ static void arp_get_arpreq(FAR struct arpreq *output,
 }
 #endif
 
+/****************************************************************************
+ * Name: arp_alloc
+ *
+ * Description:
+ *   Get an unused entry for a new IP/HW address mapping.  The expired
+ *   entries are released first.  If the table is full, the least recently
+ *   updated entry is replaced.
+ *
+ * Returned Value:
+ *   The new entry, not linked to any list.  NULL is returned if no entry
+ *   is available.
+ *
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_alloc(void)
+{
+  FAR struct arp_entry_s *tabptr;
+  clock_t now = clock_systime_ticks();
+  bool evict = false;
+#ifdef CONFIG_NETLINK_ROUTE
+  struct arpreq arp_notify;
+#endif
+
+  for (; ; )
+    {
+      tabptr = arp_entry(dq_peek(&g_arp_lru), true);
+      if (tabptr == NULL || !arp_expired(tabptr, now))
+        {
+          /* Try to get a free entry from the pool, the least recently
+           * updated one has to go if there is none.
+           */
+
+          FAR struct arp_entry_s *newptr =
+                                     NET_BUFPOOL_TRYALLOC(g_arp_entries);
+          if (newptr != NULL || tabptr == NULL)
+            {
+              return newptr;
+            }
+
+          evict = true;
+        }
+
+      /* When removing an old entry, notify RTM_DELNEIGH */
+
+#ifdef CONFIG_NETLINK_ROUTE
+      arp_get_arpreq(&arp_notify, tabptr);
+      netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
+#endif
+
+      if (evict)
+        {
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.arp.evictions++;
+#endif
+          dq_rem(&tabptr->at_hash, ARP_HASH(tabptr->at_ipaddr));
+          dq_rem(&tabptr->at_lru, &g_arp_lru);
+          return tabptr;
+        }
+
+      arp_free(tabptr);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -275,73 +432,59 @@ static void arp_get_arpreq(FAR struct arpreq *output,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr;
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
-  bool found = false;
   bool new_entry;
 #endif
-  int i;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  if (ethaddr == NULL)
+    {
+      ethaddr = g_zero_ethaddr.ether_addr_octet;
+    }
+
+  /* Try to find an entry to update.  If none is found, the IP -> MAC
+   * address mapping is inserted in the ARP table.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_search(ipaddr, dev);
+  if (tabptr != NULL)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
+      /* Need to notify when the entry changes */
 
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
 #ifdef CONFIG_NETLINK_ROUTE
-          found = true;
+      new_entry = memcmp(tabptr->at_ethaddr.ether_addr_octet,
+                         ethaddr, ETHER_ADDR_LEN) != 0;
 #endif
-          break;
-        }
-      else
-        {
-          /* Record the oldest entry. */
 
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
-    }
+      /* Make it the most recently updated entry */
 
-  if (ethaddr == NULL)
-    {
-      ethaddr = g_zero_ethaddr.ether_addr_octet;
+      dq_rem(&tabptr->at_lru, &g_arp_lru);
     }
-
-  /* When overwrite old entry, notify old entry RTM_DELNEIGH */
-
-#ifdef CONFIG_NETLINK_ROUTE
-  if (!found && tabptr->at_ipaddr != 0)
+  else
     {
-      arp_get_arpreq(&arp_notify, tabptr);
-      netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
-    }
-
-  /* Need to notify when entry is not found or changes in table */
+      tabptr = arp_alloc();
+      if (tabptr == NULL)
+        {
+          return -ENOMEM;
+        }
 
-  new_entry = !found || memcmp(tabptr->at_ethaddr.ether_addr_octet,
-                               ethaddr, ETHER_ADDR_LEN) != 0;
+#ifdef CONFIG_NETLINK_ROUTE
+      new_entry = true;
 #endif
 
+      tabptr->at_ipaddr = ipaddr;
+      tabptr->at_dev    = dev;
+      dq_addlast(&tabptr->at_hash, ARP_HASH(ipaddr));
+    }
+
   /* Now, tabptr is the ARP table entry which we will fill with the new
    * information.
    */
 
-  tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-  tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
+  dq_addlast(&tabptr->at_lru, &g_arp_lru);
 
   /* Notify the new entry */
 
@@ -495,9 +638,9 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
       netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
 #endif
 
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. Remove it from the table */
 
-      tabptr->at_ipaddr = 0;
+      arp_free(tabptr);
       return OK;
     }
 
@@ -520,13 +663,18 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
 void arp_cleanup(FAR struct net_driver_s *dev)
 {
-  int i;
+  FAR struct arp_entry_s *tabptr;
+  FAR dq_entry_t *next;
+  FAR dq_entry_t *node;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (node = dq_peek(&g_arp_lru); node != NULL; node = next)
     {
-      if (dev == g_arptable[i].at_dev)
+      next   = dq_next(node);
+      tabptr = arp_entry(node, true);
+
+      if (dev == tabptr->at_dev)
         {
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          arp_free(tabptr);
         }
     }
 }
@@ -556,19 +704,18 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
                           unsigned int nentries)
 {
   FAR struct arp_entry_s *tabptr;
+  FAR dq_entry_t *node;
   clock_t now;
   unsigned int ncopied;
-  int i;
 
-  /* Copy all non-empty, non-expired entries in the ARP table. */
+  /* Copy all non-expired entries in the ARP table. */
 
-  for (i = 0, now = clock_systime_ticks(), ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
-       i++)
+  for (node = dq_peek(&g_arp_lru), now = clock_systime_ticks(), ncopied = 0;
+       nentries > ncopied && node != NULL;
+       node = dq_next(node))
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_ipaddr != 0 &&
-          now - tabptr->at_time <= ARP_MAXAGE_TICK)
+      tabptr = arp_entry(node, true);
+      if (!arp_expired(tabptr, now))
         {
           arp_get_arpreq(&snapshot[ncopied], tabptr);
           ncopied++;
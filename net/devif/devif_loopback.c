@@ -29,10 +29,223 @@
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/pkt.h>
 #include <nuttx/net/netdev.h>
 
+#include "netdev/netdev.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOOPBACK_DELAY) && CONFIG_NET_LOOPBACK_DELAY > 0
+#  define LOOPBACK_DELAY
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef LOOPBACK_DELAY
+/* A packet on its way through the delayed loopback device */
+
+struct devif_lo_pkt_s
+{
+  FAR struct net_driver_s *dev;   /* The loopback device */
+  FAR struct iob_s *iob;          /* The packet */
+  uint16_t len;                   /* Length of the packet */
+  clock_t due;                    /* Time of delivery */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void devif_loopback_work(FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The packets in flight, in the order of their delivery time */
+
+static struct devif_lo_pkt_s g_lo_queue[CONFIG_NET_LOOPBACK_DELAY_QLEN];
+static unsigned int g_lo_head;
+static unsigned int g_lo_count;
+static struct work_s g_lo_work;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_loopback_input
+ *
+ * Description:
+ *   Feed the packet in the device buffer to the input of the network.  A
+ *   response is left in the device buffer.
+ *
+ ****************************************************************************/
+
+static void devif_loopback_input(FAR struct net_driver_s *dev)
+{
+  NETDEV_TXPACKETS(dev);
+  NETDEV_RXPACKETS(dev);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  /* We only accept IP packets of the configured type */
+
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      ninfo("IPv4 frame\n");
+
+      NETDEV_RXIPV4(dev);
+      ipv4_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      ninfo("IPv6 frame\n");
+
+      NETDEV_RXIPV6(dev);
+      ipv6_input(dev);
+    }
+  else
+#endif
+    {
+      nwarn("WARNING: Unrecognized IP version\n");
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+    }
+
+  NETDEV_TXDONE(dev);
+}
+
+#ifdef LOOPBACK_DELAY
+/****************************************************************************
+ * Name: devif_loopback_queue
+ *
+ * Description:
+ *   Take the packet out of the device buffer and queue it for delivery
+ *   after CONFIG_NET_LOOPBACK_DELAY milliseconds.  The packet is dropped if
+ *   the queue is full.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void devif_loopback_queue(FAR struct net_driver_s *dev)
+{
+  FAR struct devif_lo_pkt_s *pkt;
+
+  if (g_lo_count >= CONFIG_NET_LOOPBACK_DELAY_QLEN)
+    {
+      ninfo("Loopback queue full, drop\n");
+      NETDEV_TXPACKETS(dev);
+      NETDEV_TXERRORS(dev);
+      netdev_iob_release(dev);
+      dev->d_len = 0;
+      return;
+    }
+
+  pkt = &g_lo_queue[(g_lo_head + g_lo_count) %
+                    CONFIG_NET_LOOPBACK_DELAY_QLEN];
+  pkt->dev = dev;
+  pkt->iob = dev->d_iob;
+  pkt->len = dev->d_len;
+  pkt->due = clock_systime_ticks() + MSEC2TICK(CONFIG_NET_LOOPBACK_DELAY);
+
+  netdev_iob_clear(dev);
+
+  if (g_lo_count++ == 0)
+    {
+      work_queue(LPWORK, &g_lo_work, devif_loopback_work, NULL,
+                 MSEC2TICK(CONFIG_NET_LOOPBACK_DELAY));
+    }
+}
+
+/****************************************************************************
+ * Name: devif_loopback_work
+ *
+ * Description:
+ *   Deliver the packets of the delayed loopback device that are due, and
+ *   queue their responses.
+ *
+ ****************************************************************************/
+
+static void devif_loopback_work(FAR void *arg)
+{
+  FAR struct devif_lo_pkt_s *pkt;
+  FAR struct net_driver_s *dev;
+  FAR struct iob_s *iob;
+  clock_t now;
+  uint16_t len;
+
+  net_lock();
+
+  now = clock_systime_ticks();
+  while (g_lo_count > 0)
+    {
+      pkt = &g_lo_queue[g_lo_head];
+      if ((sclock_t)(pkt->due - now) > 0)
+        {
+          work_queue(LPWORK, &g_lo_work, devif_loopback_work, NULL,
+                     pkt->due - now);
+          break;
+        }
+
+      g_lo_head = (g_lo_head + 1) % CONFIG_NET_LOOPBACK_DELAY_QLEN;
+      g_lo_count--;
+
+      /* Borrow the device buffer, the device might be in the middle of a
+       * poll.
+       */
+
+      dev        = pkt->dev;
+      iob        = dev->d_iob;
+      len        = dev->d_len;
+      dev->d_iob = pkt->iob;
+      dev->d_buf = NETLLBUF;
+      dev->d_len = pkt->len;
+
+      devif_loopback_input(dev);
+
+      if (dev->d_len > 0)
+        {
+          devif_loopback_queue(dev);
+        }
+      else
+        {
+          netdev_iob_release(dev);
+        }
+
+      dev->d_iob = iob;
+      dev->d_buf = iob != NULL ? NETLLBUF : NULL;
+      dev->d_len = len;
+
+      /* The input may have opened the window for more data */
+
+      netdev_txnotify_dev(dev);
+    }
+
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -96,50 +309,21 @@ int devif_loopback(FAR struct net_driver_s *dev)
       return 0;
     }
 
+#ifdef LOOPBACK_DELAY
+  if (dev->d_lltype == NET_LL_LOOPBACK)
+    {
+      devif_loopback_queue(dev);
+      return 1;
+    }
+#endif
+
   /* Loop while if there is data "sent" to ourself.
    * Sending, of course, just means relaying back through the network.
    */
 
   do
     {
-       NETDEV_TXPACKETS(dev);
-       NETDEV_RXPACKETS(dev);
-
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
-
-       pkt_input(dev);
-#endif
-
-      /* We only accept IP packets of the configured type */
-
-#ifdef CONFIG_NET_IPv4
-      if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
-        {
-          ninfo("IPv4 frame\n");
-
-          NETDEV_RXIPV4(dev);
-          ipv4_input(dev);
-        }
-      else
-#endif
-#ifdef CONFIG_NET_IPv6
-      if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
-        {
-          ninfo("IPv6 frame\n");
-
-          NETDEV_RXIPV6(dev);
-          ipv6_input(dev);
-        }
-      else
-#endif
-        {
-          nwarn("WARNING: Unrecognized IP version\n");
-          NETDEV_RXDROPPED(dev);
-          dev->d_len = 0;
-        }
-
-      NETDEV_TXDONE(dev);
+      devif_loopback_input(dev);
     }
   while (dev->d_len > 0);
 
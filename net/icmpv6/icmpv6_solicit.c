@@ -126,6 +126,12 @@ void icmpv6_solicit(FAR struct net_driver_s *dev,
 
   iob_update_pktlen(dev->d_iob, IPv6_HDRLEN + l3size, false);
 
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  /* The solicitation replaces the packet that was in d_iob */
+
+  dev->d_csumstate = NETDEV_CSUM_NONE;
+#endif
+
   /* Calculate the checksum over both the ICMP header and payload */
 
   sol->chksum   = 0;
@@ -114,6 +114,15 @@ static ssize_t    inet_sendfile(FAR struct socket *psock,
                                 FAR struct file *infile, FAR off_t *offset,
                                 size_t count);
 #endif
+#ifdef NET_UDP_HAVE_STACK
+static int        inet_recvmmsg(FAR struct socket *psock,
+                                FAR struct mmsghdr *msgvec,
+                                unsigned int vlen, int flags,
+                                FAR const struct timespec *timeout);
+static int        inet_sendmmsg(FAR struct socket *psock,
+                                FAR struct mmsghdr *msgvec,
+                                unsigned int vlen, int flags);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -144,6 +153,10 @@ static const struct sock_intf_s g_inet_sockif =
 #ifdef CONFIG_NET_SENDFILE
   , inet_sendfile   /* si_sendfile */
 #endif
+#ifdef NET_UDP_HAVE_STACK
+  , inet_recvmmsg   /* si_recvmmsg */
+  , inet_sendmmsg   /* si_sendmmsg */
+#endif
 };
 
 /****************************************************************************
@@ -1212,7 +1225,7 @@ static int inet_listen(FAR struct socket *psock, int backlog)
 
           conn->lport = tcp_selectport(PF_INET,
                                 (FAR const union ip_addr_u *)
-                                &conn->u.ipv4.laddr, 0);
+                                &conn->u.ipv4.laddr, 0, 0);
         }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -1227,7 +1240,7 @@ static int inet_listen(FAR struct socket *psock, int backlog)
 
           conn->lport = tcp_selectport(PF_INET6,
                                 (FAR const union ip_addr_u *)
-                                conn->u.ipv6.laddr, 0);
+                                conn->u.ipv6.laddr, 0, 0);
         }
 #endif /* CONFIG_NET_IPv6 */
     }
@@ -2362,6 +2375,164 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
   return ret;
 }
 
+/****************************************************************************
+ * Name: inet_addrlen
+ *
+ * Description:
+ *   Get the size of the socket address of an address family, zero if the
+ *   family is not supported.
+ *
+ ****************************************************************************/
+
+#ifdef NET_UDP_HAVE_STACK
+static socklen_t inet_addrlen(sa_family_t family)
+{
+  switch (family)
+    {
+#ifdef CONFIG_NET_IPv4
+      case AF_INET:
+        return sizeof(struct sockaddr_in);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      case AF_INET6:
+        return sizeof(struct sockaddr_in6);
+#endif
+
+      default:
+        return 0;
+    }
+}
+
+/****************************************************************************
+ * Name: inet_recvmmsg
+ *
+ * Description:
+ *   Implements the recvmmsg() operation for UDP sockets of the AF_INET and
+ *   AF_INET6 address families.  Other socket types return -ENOSYS and are
+ *   served message by message.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - Buffers to receive the messages
+ *   vlen    - The number of entries in msgvec
+ *   flags   - Receive flags
+ *   timeout - Time limit of the whole call, NULL to wait without limit
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  Otherwise, a
+ *   negated errno value is returned (see recvmsg() for the list of
+ *   appropriate error values).
+ *
+ ****************************************************************************/
+
+static int inet_recvmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec, unsigned int vlen,
+                         int flags, FAR const struct timespec *timeout)
+{
+  socklen_t minlen = inet_addrlen(psock->s_domain);
+  FAR struct msghdr *msg;
+  unsigned int i;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return -ENOSYS;
+    }
+
+  /* Verify that each 'from' address is large enough */
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg = &msgvec[i].msg_hdr;
+      if (msg->msg_name != NULL && msg->msg_namelen < minlen)
+        {
+          return -EINVAL;
+        }
+    }
+
+  return psock_udp_recvmmsg(psock, msgvec, vlen, flags, timeout);
+}
+
+/****************************************************************************
+ * Name: inet_sendmmsg
+ *
+ * Description:
+ *   Implements the sendmmsg() operation for buffered UDP sockets of the
+ *   AF_INET and AF_INET6 address families.  Other sockets return -ENOSYS
+ *   and are served message by message.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - The messages to send
+ *   vlen    - The number of entries in msgvec
+ *   flags   - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  Otherwise, a negated
+ *   errno value is returned (see sendmsg() for the list of appropriate
+ *   error values).
+ *
+ ****************************************************************************/
+
+static int inet_sendmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec, unsigned int vlen,
+                         int flags)
+{
+#if defined(CONFIG_NET_UDP_WRITE_BUFFERS) && !defined(CONFIG_NET_6LOWPAN)
+  FAR const struct sockaddr *to;
+  socklen_t minlen;
+  unsigned int i;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return -ENOSYS;
+    }
+
+  /* Send the messages up to the first one with an invalid address, that
+   * one fails in the next call then.
+   */
+
+  for (i = 0; i < vlen; i++)
+    {
+      to = msgvec[i].msg_hdr.msg_name;
+      if (to == NULL)
+        {
+          continue;
+        }
+
+      minlen = inet_addrlen(to->sa_family);
+      if (minlen == 0)
+        {
+          if (i == 0)
+            {
+              nerr("ERROR: Unrecognized address family: %d\n",
+                   to->sa_family);
+              return -EAFNOSUPPORT;
+            }
+
+          break;
+        }
+
+      if (msgvec[i].msg_hdr.msg_namelen < minlen)
+        {
+          if (i == 0)
+            {
+              nerr("ERROR: Invalid address length: %d < %d\n",
+                   msgvec[i].msg_hdr.msg_namelen, minlen);
+              return -EBADF;
+            }
+
+          break;
+        }
+    }
+
+  return psock_udp_sendmmsg(psock, msgvec, i, flags);
+#else
+  return -ENOSYS;
+#endif
+}
+#endif /* NET_UDP_HAVE_STACK */
+
 #endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
 
 /****************************************************************************
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
@@ -65,15 +66,94 @@
 #define IPv6_L4HDR(ipv6, proto) \
   ((FAR void *)(net_ipv6_payload((FAR struct ipv6_hdr_s *)(ipv6), &(proto))))
 
+#ifdef CONFIG_NET_IPFILTER_INDEX
+/* A rule is indexed under one or more keys, a packet is looked up with
+ * the keys of its protocol and destination port, of its protocol alone
+ * and of the leading part of its destination and source address.  The
+ * candidates are the rules under these keys and the rules that cannot be
+ * indexed.  Keys that collide in the hash table only add candidates.
+ */
+
+#define IPFILTER_NKEYS          4
+#define IPFILTER_NLISTS         (IPFILTER_NKEYS + 1)
+
+/* Rules matching up to this number of destination ports are indexed under
+ * each port.
+ */
+
+#define IPFILTER_PORT_SPAN      16
+
+#define IPFILTER_MIN_BUCKETS    8
+#define IPFILTER_MAX_BUCKETS    4096
+
+#define IPFILTER_PORT_KEY(proto, port) \
+  (0x01000000u | (uint32_t)(proto) << 16 | (port))
+#define IPFILTER_PROTO_KEY(proto) \
+  (0x02000000u | (proto))
+#define IPFILTER_DST_KEY(net)   (net)
+#define IPFILTER_SRC_KEY(net)   (~(net))
+
+/* The bucket is taken from the top bits of the product (Fibonacci
+ * hashing), which all the bits of the key contribute to.  The bits of
+ * the addresses that vary the most may lie anywhere in the key.
+ */
+
+#define IPFILTER_BUCKET(index, key) \
+  ((uint32_t)(((uint64_t)(uint32_t)((key) * 2654435761u) * \
+               (index)->nbuckets) >> 32))
+
+/* The leading part of the addresses in the key, /24 and /64 */
+
+#define IPv4_KEYMASK            HTONL(0xffffff00)
+#define IPv6_KEYWORDS           4
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+/* The index of the rules of a chain.  It holds one sorted list of rule
+ * numbers for each bucket of the hash table and one for the rules that
+ * cannot be indexed, the list of bucket b being idx[start[b]] up to
+ * idx[start[b + 1]].
+ */
+
+struct ipfilter_index_s
+{
+  uint16_t nbuckets;                    /* Number of buckets, a power of 2 */
+  FAR struct ipfilter_entry_s **rules;  /* The rules in chain order */
+  FAR uint16_t *start;                  /* nbuckets + 2 list offsets */
+  FAR uint16_t *idx;                    /* The lists of rule numbers */
+};
+
+/* The state of a lookup: the lists of the keys of the packet and the
+ * number of the last rule tried.
+ */
+
+struct ipfilter_cursor_s
+{
+  FAR const uint16_t *pos[IPFILTER_NLISTS];
+  FAR const uint16_t *end[IPFILTER_NLISTS];
+  int last;
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
 static sq_queue_t g_ipv4_filters[IPFILTER_CHAIN_MAX];
+#  ifdef CONFIG_NET_IPFILTER_INDEX
+static FAR struct ipfilter_index_s *g_ipv4_index[IPFILTER_CHAIN_MAX];
+#  endif
 #endif
 #ifdef CONFIG_NET_IPv6
 static sq_queue_t g_ipv6_filters[IPFILTER_CHAIN_MAX];
+#  ifdef CONFIG_NET_IPFILTER_INDEX
+static FAR struct ipfilter_index_s *g_ipv6_index[IPFILTER_CHAIN_MAX];
+#  endif
 #endif
 
 /****************************************************************************
@@ -188,6 +268,447 @@ static bool ipfilter_match_proto(FAR const struct ipfilter_entry_s *entry,
     }
 }
 
+/****************************************************************************
+ * Name: ipfilter_queue
+ *
+ * Description:
+ *   Get the list of the filter entries of a chain.
+ *
+ ****************************************************************************/
+
+static FAR sq_queue_t *ipfilter_queue(sa_family_t family,
+                                      enum ipfilter_chain_e chain)
+{
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      return &g_ipv4_filters[chain];
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      return &g_ipv6_filters[chain];
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ipfilter_hit
+ *
+ * Description:
+ *   Count a packet of 'len' bytes matched by a filter entry and return the
+ *   target action of the entry.
+ *
+ ****************************************************************************/
+
+static int ipfilter_hit(FAR struct ipfilter_entry_s *entry, uint16_t len)
+{
+  entry->hits++;
+  entry->bytes += len;
+  return entry->target;
+}
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+
+/****************************************************************************
+ * Name: ipfilter_index_slot
+ *
+ * Description:
+ *   Get the location of the index of a chain.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfilter_index_s **
+ipfilter_index_slot(sa_family_t family, enum ipfilter_chain_e chain)
+{
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      return &g_ipv4_index[chain];
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      return &g_ipv6_index[chain];
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_drop
+ *
+ * Description:
+ *   Free the index of a chain, the chain is then searched linearly.
+ *
+ ****************************************************************************/
+
+static void ipfilter_index_drop(sa_family_t family,
+                                enum ipfilter_chain_e chain)
+{
+  FAR struct ipfilter_index_s **slot = ipfilter_index_slot(family, chain);
+
+  if (slot != NULL && *slot != NULL)
+    {
+      kmm_free(*slot);
+      *slot = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: ipv6_netkey
+ *
+ * Description:
+ *   Fold the leading IPv6_KEYWORDS words of an IPv6 address into a key.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static uint32_t ipv6_netkey(FAR const uint16_t *addr)
+{
+  return ((uint32_t)addr[0] << 16 | addr[1]) ^
+         ((uint32_t)addr[2] << 16 | addr[3]);
+}
+
+static bool ipv6_keymask(FAR const uint16_t *mask)
+{
+  int i;
+
+  for (i = 0; i < IPv6_KEYWORDS; i++)
+    {
+      if (mask[i] != 0xffff)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_rule_keys
+ *
+ * Description:
+ *   Get the keys to index a filter entry under.  Any packet matched by the
+ *   entry has one of these keys.
+ *
+ * Input Parameters:
+ *   entry  - The filter entry
+ *   family - The address family of the filter entry
+ *   keys   - Location to return up to IPFILTER_PORT_SPAN keys
+ *
+ * Returned Value:
+ *   The number of keys, zero if the entry cannot be indexed.
+ *
+ ****************************************************************************/
+
+static int ipfilter_rule_keys(FAR const struct ipfilter_entry_s *entry,
+                              sa_family_t family, FAR uint32_t *keys)
+{
+  uint32_t port;
+  int nkeys = 0;
+
+  /* TCP and UDP rules for a few destination ports */
+
+  if ((entry->proto == IP_PROTO_TCP || entry->proto == IP_PROTO_UDP) &&
+      !entry->inv_proto && entry->match_tcpudp && !entry->inv_dport &&
+      entry->match.tcpudp.dports[0] <= entry->match.tcpudp.dports[1] &&
+      entry->match.tcpudp.dports[1] - entry->match.tcpudp.dports[0] <
+      IPFILTER_PORT_SPAN)
+    {
+      for (port = entry->match.tcpudp.dports[0];
+           port <= entry->match.tcpudp.dports[1]; port++)
+        {
+          keys[nkeys++] = IPFILTER_PORT_KEY(entry->proto, port);
+        }
+
+      return nkeys;
+    }
+
+  /* Rules for a long enough destination or source prefix */
+
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      FAR const struct ipv4_filter_entry_s *filter =
+        (FAR const struct ipv4_filter_entry_s *)entry;
+
+      if (!entry->inv_dstip &&
+          (filter->dmsk & IPv4_KEYMASK) == IPv4_KEYMASK)
+        {
+          keys[0] = IPFILTER_DST_KEY(filter->dip & IPv4_KEYMASK);
+          return 1;
+        }
+
+      if (!entry->inv_srcip &&
+          (filter->smsk & IPv4_KEYMASK) == IPv4_KEYMASK)
+        {
+          keys[0] = IPFILTER_SRC_KEY(filter->sip & IPv4_KEYMASK);
+          return 1;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      FAR const struct ipv6_filter_entry_s *filter =
+        (FAR const struct ipv6_filter_entry_s *)entry;
+
+      if (!entry->inv_dstip && ipv6_keymask(filter->dmsk))
+        {
+          keys[0] = IPFILTER_DST_KEY(ipv6_netkey(filter->dip));
+          return 1;
+        }
+
+      if (!entry->inv_srcip && ipv6_keymask(filter->smsk))
+        {
+          keys[0] = IPFILTER_SRC_KEY(ipv6_netkey(filter->sip));
+          return 1;
+        }
+    }
+#endif
+
+  /* Rules for one protocol */
+
+  if (entry->proto != 0 && !entry->inv_proto)
+    {
+      keys[0] = IPFILTER_PROTO_KEY(entry->proto);
+      return 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ipfilter_packet_keys
+ *
+ * Description:
+ *   Get the keys to look up a packet with.
+ *
+ * Input Parameters:
+ *   keys   - Location to return up to IPFILTER_NKEYS keys
+ *   proto  - The protocol of the packet
+ *   l4hdr  - The L4 header of the packet
+ *   dstnet - The leading part of the destination address
+ *   srcnet - The leading part of the source address
+ *
+ * Returned Value:
+ *   The number of keys.
+ *
+ ****************************************************************************/
+
+static int ipfilter_packet_keys(FAR uint32_t *keys, uint8_t proto,
+                                FAR const void *l4hdr, uint32_t dstnet,
+                                uint32_t srcnet)
+{
+  int nkeys = 0;
+
+  if (proto == IP_PROTO_TCP || proto == IP_PROTO_UDP)
+    {
+      /* Ports in TCP & UDP headers have same offset. */
+
+      FAR const struct udp_hdr_s *udp = l4hdr;
+      keys[nkeys++] = IPFILTER_PORT_KEY(proto, NTOHS(udp->destport));
+    }
+
+  keys[nkeys++] = IPFILTER_PROTO_KEY(proto);
+  keys[nkeys++] = IPFILTER_DST_KEY(dstnet);
+  keys[nkeys++] = IPFILTER_SRC_KEY(srcnet);
+
+  return nkeys;
+}
+
+/****************************************************************************
+ * Name: ipfilter_cursor_init
+ *
+ * Description:
+ *   Start a lookup of the rules under some keys in the index.
+ *
+ ****************************************************************************/
+
+static void ipfilter_cursor_init(FAR const struct ipfilter_index_s *index,
+                                 FAR struct ipfilter_cursor_s *cur,
+                                 FAR const uint32_t *keys, int nkeys)
+{
+  uint32_t bucket;
+  int i;
+
+  for (i = 0; i < nkeys; i++)
+    {
+      bucket      = IPFILTER_BUCKET(index, keys[i]);
+      cur->pos[i] = &index->idx[index->start[bucket]];
+      cur->end[i] = &index->idx[index->start[bucket + 1]];
+    }
+
+  /* The rules that are not indexed are candidates for every packet */
+
+  cur->pos[i] = &index->idx[index->start[index->nbuckets]];
+  cur->end[i] = &index->idx[index->start[index->nbuckets + 1]];
+
+  for (i++; i < IPFILTER_NLISTS; i++)
+    {
+      cur->pos[i] = NULL;
+      cur->end[i] = NULL;
+    }
+
+  cur->last = -1;
+}
+
+/****************************************************************************
+ * Name: ipfilter_cursor_next
+ *
+ * Description:
+ *   Get the next candidate rule of a lookup in chain order.
+ *
+ * Returned Value:
+ *   The next candidate rule, NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfilter_entry_s *
+ipfilter_cursor_next(FAR const struct ipfilter_index_s *index,
+                     FAR struct ipfilter_cursor_s *cur)
+{
+  int next = -1;
+  int i;
+
+  for (i = 0; i < IPFILTER_NLISTS; i++)
+    {
+      /* Skip the rules already tried, a rule may be in several lists */
+
+      while (cur->pos[i] < cur->end[i] && *cur->pos[i] <= cur->last)
+        {
+          cur->pos[i]++;
+        }
+
+      if (cur->pos[i] < cur->end[i] && (next < 0 || *cur->pos[i] < next))
+        {
+          next = *cur->pos[i];
+        }
+    }
+
+  if (next < 0)
+    {
+      return NULL;
+    }
+
+  cur->last = next;
+  return index->rules[next];
+}
+#endif /* CONFIG_NET_IPFILTER_INDEX */
+
+/****************************************************************************
+ * Name: ipv4_filter_match_entry / ipv6_filter_match_entry
+ *
+ * Description:
+ *   Match the packet with one filter entry.
+ *
+ * Input Parameters:
+ *   filter    - The filter entry to match
+ *   indev     - The network device that the packet comes from
+ *   outdev    - The network device that the packet goes to
+ *   ipv4/ipv6 - The IPv4/IPv6 header
+ *   l4hdr     - The L4 header
+ *   proto     - The protocol of the L4 header (IPv6 only)
+ *
+ * Returned Value:
+ *   true  - The input packet is matched
+ *   false - The input packet is not matched
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static bool
+ipv4_filter_match_entry(FAR const struct ipv4_filter_entry_s *filter,
+                        FAR const struct net_driver_s *indev,
+                        FAR const struct net_driver_s *outdev,
+                        FAR const struct ipv4_hdr_s *ipv4,
+                        FAR const void *l4hdr)
+{
+  in_addr_t ipaddr;
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
+  matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static bool
+ipv6_filter_match_entry(FAR const struct ipv6_filter_entry_s *filter,
+                        FAR const struct net_driver_s *indev,
+                        FAR const struct net_driver_s *outdev,
+                        FAR const struct ipv6_hdr_s *ipv6,
+                        FAR const void *l4hdr, uint8_t proto)
+{
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
+                                 filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
+                                 filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, l4hdr, proto);
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_filter_match / ipv6_filter_match
  *
@@ -213,12 +734,17 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
                              FAR const struct ipv4_hdr_s *ipv4,
                              enum ipfilter_chain_e chain)
 {
-  FAR const struct ipv4_filter_entry_s *filter;
+  FAR struct ipv4_filter_entry_s *filter;
   FAR const sq_queue_t *queue = &g_ipv4_filters[chain];
-  FAR const sq_entry_t *entry;
+  FAR sq_entry_t *entry;
   FAR const void *l4hdr;
-  in_addr_t ipaddr;
-  bool matched;
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  FAR const struct ipfilter_index_s *index = g_ipv4_index[chain];
+  struct ipfilter_cursor_s cur;
+  uint32_t keys[IPFILTER_NKEYS];
+  int nkeys;
+#endif
+  uint16_t len;
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -228,46 +754,40 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
     }
 
   l4hdr = IPv4_L4HDR(ipv4);
+  len   = ((uint16_t)ipv4->len[0] << 8) + ipv4->len[1];
 
-  sq_for_every(queue, entry)
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  if (index != NULL)
     {
-      filter = (FAR struct ipv4_filter_entry_s *)entry;
-
-      /* Match device */
-
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
-        {
-          continue;
-        }
+      /* Only try the rules that can match the packet */
 
-      /* Match addresses */
+      nkeys = ipfilter_packet_keys(keys, ipv4->proto, l4hdr,
+                net_ip4addr_conv32(ipv4->destipaddr) & IPv4_KEYMASK,
+                net_ip4addr_conv32(ipv4->srcipaddr) & IPv4_KEYMASK);
 
-      ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
-      matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
+      ipfilter_cursor_init(index, &cur, keys, nkeys);
+      while ((filter = (FAR struct ipv4_filter_entry_s *)
+                       ipfilter_cursor_next(index, &cur)) != NULL)
         {
-          continue;
+          if (ipv4_filter_match_entry(filter, indev, outdev, ipv4, l4hdr))
+            {
+              return ipfilter_hit(&filter->common, len);
+            }
         }
-
-      ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
-      matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
+    }
+  else
+#endif
+    {
+      sq_for_every(queue, entry)
         {
-          continue;
-        }
-
-      /* Match protocol */
+          filter = (FAR struct ipv4_filter_entry_s *)entry;
+          if (ipv4_filter_match_entry(filter, indev, outdev, ipv4, l4hdr))
+            {
+              /* Return the target action if matched. */
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto))
-        {
-          continue;
+              return ipfilter_hit(&filter->common, len);
+            }
         }
-
-      /* Return the target action if matched. */
-
-      return filter->common.target;
     }
 
   /* Normally there should be a default rule in chain, won't reach here. */
@@ -283,12 +803,18 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
                              FAR const struct ipv6_hdr_s *ipv6,
                              enum ipfilter_chain_e chain)
 {
-  FAR const struct ipv6_filter_entry_s *filter;
+  FAR struct ipv6_filter_entry_s *filter;
   FAR const sq_queue_t *queue = &g_ipv6_filters[chain];
-  FAR const sq_entry_t *entry;
+  FAR sq_entry_t *entry;
   FAR const void *l4hdr;
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  FAR const struct ipfilter_index_s *index = g_ipv6_index[chain];
+  struct ipfilter_cursor_s cur;
+  uint32_t keys[IPFILTER_NKEYS];
+  int nkeys;
+#endif
+  uint16_t len;
   uint8_t proto;
-  bool matched;
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -298,46 +824,42 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
     }
 
   l4hdr = IPv6_L4HDR(ipv6, proto);
+  len   = ((uint16_t)ipv6->len[0] << 8) + ipv6->len[1] + IPv6_HDRLEN;
 
-  sq_for_every(queue, entry)
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  if (index != NULL)
     {
-      filter = (FAR struct ipv6_filter_entry_s *)entry;
+      /* Only try the rules that can match the packet */
 
-      /* Match device */
+      nkeys = ipfilter_packet_keys(keys, proto, l4hdr,
+                                   ipv6_netkey(ipv6->destipaddr),
+                                   ipv6_netkey(ipv6->srcipaddr));
 
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
+      ipfilter_cursor_init(index, &cur, keys, nkeys);
+      while ((filter = (FAR struct ipv6_filter_entry_s *)
+                       ipfilter_cursor_next(index, &cur)) != NULL)
         {
-          continue;
+          if (ipv6_filter_match_entry(filter, indev, outdev, ipv6, l4hdr,
+                                      proto))
+            {
+              return ipfilter_hit(&filter->common, len);
+            }
         }
-
-      /* Match addresses */
-
-      matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
-                                     filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
-
-      matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
-                                     filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
-        {
-          continue;
-        }
-
-      /* Match protocol */
-
-      if (!ipfilter_match_proto(&filter->common, l4hdr, proto))
+    }
+  else
+#endif
+    {
+      sq_for_every(queue, entry)
         {
-          continue;
+          filter = (FAR struct ipv6_filter_entry_s *)entry;
+          if (ipv6_filter_match_entry(filter, indev, outdev, ipv6, l4hdr,
+                                      proto))
+            {
+              /* Return the target action if matched. */
+
+              return ipfilter_hit(&filter->common, len);
+            }
         }
-
-      /* Return the target action if matched. */
-
-      return filter->common.target;
     }
 
   /* Normally there should be a default rule in chain, won't reach here. */
@@ -407,6 +929,10 @@ FAR struct ipfilter_entry_s *ipfilter_cfg_alloc(sa_family_t family)
 void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
                       sa_family_t family, enum ipfilter_chain_e chain)
 {
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  ipfilter_index_drop(family, chain);
+#endif
+
 #ifdef CONFIG_NET_IPv4
   if (family == PF_INET)
     {
@@ -440,6 +966,10 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
 
 void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
 {
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  ipfilter_index_drop(family, chain);
+#endif
+
 #ifdef CONFIG_NET_IPv4
   if (family == PF_INET)
     {
@@ -463,6 +993,168 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
 #endif
 }
 
+/****************************************************************************
+ * Name: ipfilter_cfg_compile
+ *
+ * Description:
+ *   Build the index of the filter configuration entries of the specified
+ *   chain, which speeds up the lookup of the first matching entry.  The
+ *   function should be called once all entries of the chain are added.
+ *   Adding or clearing entries drops the index again.
+ *
+ * Input Parameters:
+ *   family - The address family of the filter entries
+ *   chain  - The chain to build the index of
+ *
+ * Returned Value:
+ *   None.  The entries are searched linearly if the index cannot be built.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+void ipfilter_cfg_compile(sa_family_t family, enum ipfilter_chain_e chain)
+{
+  FAR struct ipfilter_index_s **slot = ipfilter_index_slot(family, chain);
+  FAR sq_queue_t *queue = ipfilter_queue(family, chain);
+  FAR struct ipfilter_index_s *index;
+  FAR sq_entry_t *node;
+  uint32_t keys[IPFILTER_PORT_SPAN];
+  size_t nbuckets;
+  size_t nrules = 0;
+  size_t nidx = 0;
+  size_t i;
+  uint32_t bucket;
+  uint16_t sum;
+  int nkeys;
+  int j;
+
+  if (slot == NULL)
+    {
+      return;
+    }
+
+  ipfilter_index_drop(family, chain);
+
+  /* Find the size of the index, the rule numbers must fit in 16 bits */
+
+  sq_for_every(queue, node)
+    {
+      nkeys = ipfilter_rule_keys((FAR struct ipfilter_entry_s *)node,
+                                 family, keys);
+      nidx += nkeys > 0 ? nkeys : 1;
+      nrules++;
+    }
+
+  if (nrules == 0 || nidx > UINT16_MAX)
+    {
+      return;
+    }
+
+  nbuckets = IPFILTER_MIN_BUCKETS;
+  while (nbuckets < nrules && nbuckets < IPFILTER_MAX_BUCKETS)
+    {
+      nbuckets <<= 1;
+    }
+
+  index = kmm_zalloc(sizeof(*index) +
+                     nrules * sizeof(FAR struct ipfilter_entry_s *) +
+                     (nbuckets + 2 + nidx) * sizeof(uint16_t));
+  if (index == NULL)
+    {
+      nwarn("WARNING: Failed to allocate the index of %zu rules\n", nrules);
+      return;
+    }
+
+  index->nbuckets = nbuckets;
+  index->rules    = (FAR struct ipfilter_entry_s **)(index + 1);
+  index->start    = (FAR uint16_t *)(index->rules + nrules);
+  index->idx      = index->start + nbuckets + 2;
+
+  /* Count the rules in each list, the last list holds the rules that
+   * cannot be indexed.
+   */
+
+  i = 0;
+  sq_for_every(queue, node)
+    {
+      index->rules[i++] = (FAR struct ipfilter_entry_s *)node;
+
+      nkeys = ipfilter_rule_keys((FAR struct ipfilter_entry_s *)node,
+                                 family, keys);
+      if (nkeys == 0)
+        {
+          index->start[nbuckets]++;
+        }
+
+      for (j = 0; j < nkeys; j++)
+        {
+          index->start[IPFILTER_BUCKET(index, keys[j])]++;
+        }
+    }
+
+  /* Turn the counts into the ends of the lists */
+
+  for (sum = 0, bucket = 0; bucket <= nbuckets; bucket++)
+    {
+      sum += index->start[bucket];
+      index->start[bucket] = sum;
+    }
+
+  index->start[nbuckets + 1] = sum;
+
+  /* Fill the lists backwards, so that they are sorted by rule number and
+   * the start of each list is left behind.
+   */
+
+  for (i = nrules; i-- > 0; )
+    {
+      nkeys = ipfilter_rule_keys(index->rules[i], family, keys);
+      if (nkeys == 0)
+        {
+          index->idx[--index->start[nbuckets]] = i;
+        }
+
+      for (j = 0; j < nkeys; j++)
+        {
+          bucket = IPFILTER_BUCKET(index, keys[j]);
+          index->idx[--index->start[bucket]] = i;
+        }
+    }
+
+  ninfo("Indexed %zu rules in %zu buckets\n", nrules, nbuckets);
+  *slot = index;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_cfg_first
+ *
+ * Description:
+ *   Get the first filter configuration entry of the specified chain, the
+ *   others follow through the flink field.
+ *
+ * Input Parameters:
+ *   family - The address family of the filter entries
+ *   chain  - The chain of interest
+ *
+ * Returned Value:
+ *   The first entry, NULL if the chain is empty.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_entry_s *ipfilter_cfg_first(sa_family_t family,
+                                                enum ipfilter_chain_e chain)
+{
+  FAR sq_queue_t *queue = ipfilter_queue(family, chain);
+
+  if (queue == NULL)
+    {
+      return NULL;
+    }
+
+  return (FAR struct ipfilter_entry_s *)sq_peek(queue);
+}
+
 /****************************************************************************
  * Name: ipv4_filter_in / ipv6_filter_in
  *
@@ -82,6 +82,17 @@ struct ipfilter_entry_s
   uint8_t proto;          /* Protocol to match, 0 = ALL (Same as Linux) */
   int8_t  target;
 
+  /* Packet and byte counters of the matched packets */
+
+  uint64_t hits;
+  uint64_t bytes;
+
+  /* The position of the rule in the entries of its iptables hook, entries
+   * that could not be converted have no rule.
+   */
+
+  uint32_t entryno;
+
   /* Match flags, whether we need to match protocol in detail */
 
   uint8_t match_tcpudp : 1; /* Match TCP/UDP */
@@ -182,6 +193,49 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
 
 void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain);
 
+/****************************************************************************
+ * Name: ipfilter_cfg_compile
+ *
+ * Description:
+ *   Build the index of the filter configuration entries of the specified
+ *   chain, which speeds up the lookup of the first matching entry.  The
+ *   function should be called once all entries of the chain are added.
+ *   Adding or clearing entries drops the index again.
+ *
+ * Input Parameters:
+ *   family - The address family of the filter entries
+ *   chain  - The chain to build the index of
+ *
+ * Returned Value:
+ *   None.  The entries are searched linearly if the index cannot be built.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+void ipfilter_cfg_compile(sa_family_t family, enum ipfilter_chain_e chain);
+#else
+#  define ipfilter_cfg_compile(f,c)
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_cfg_first
+ *
+ * Description:
+ *   Get the first filter configuration entry of the specified chain, the
+ *   others follow through the flink field.
+ *
+ * Input Parameters:
+ *   family - The address family of the filter entries
+ *   chain  - The chain of interest
+ *
+ * Returned Value:
+ *   The first entry, NULL if the chain is empty.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_entry_s *ipfilter_cfg_first(sa_family_t family,
+                                                enum ipfilter_chain_e chain);
+
 /****************************************************************************
  * Name: ipv4_filter_in / ipv6_filter_in
  *
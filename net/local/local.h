@@ -109,6 +109,9 @@ enum local_state_s
  */
 
 struct devif_callback_s;       /* Forward reference */
+#ifdef CONFIG_NET_LOCAL_RING
+struct local_ring_s;           /* Forward reference */
+#endif
 
 struct local_conn_s
 {
@@ -126,6 +129,11 @@ struct local_conn_s
   uint8_t lc_state;              /* See enum local_state_e */
   struct file lc_infile;         /* File for read-only FIFO (peers) */
   struct file lc_outfile;        /* File descriptor of write-only FIFO (peers) */
+#ifdef CONFIG_NET_LOCAL_RING
+  FAR struct local_ring_s *lc_cs; /* Client-to-server ring (server owned) */
+  FAR struct local_ring_s *lc_sc; /* Server-to-client ring (server owned) */
+  FAR struct local_ring_s *lc_hd; /* Half duplex ring (receiver owned) */
+#endif
   char lc_path[UNIX_PATH_MAX];   /* Path assigned by bind() */
   int32_t lc_instance_id;        /* Connection instance ID for stream
                                   * server<->client connection pair */
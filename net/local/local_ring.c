@@ -0,0 +1,1113 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <sys/param.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/circbuf.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/net/net.h>
+
+#include "local/local.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Both ends of a ring may be polled by the waiters of their connection */
+
+#define LOCAL_RING_NPOLLWAITERS (2 * LOCAL_NPOLLWAITERS)
+
+/* All user buffers are in one address space unless this is a kernel build.
+ * A writer can then copy the data straight to the buffer of a reader that
+ * waits for data, instead of through the ring.
+ */
+
+#ifndef CONFIG_BUILD_KERNEL
+#  define LOCAL_RING_HANDOFF 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A reader that waits on an empty ring */
+
+struct local_reader_s
+{
+  FAR uint8_t *buf;                /* The buffer of the reader */
+  size_t len;                      /* The size of the buffer */
+  size_t nread;                    /* Bytes copied to it by a writer */
+};
+
+/* One direction of a connection.  The ring is owned by a connection and
+ * opened as the struct file of the peers, like a FIFO, but without a node
+ * in the pseudo-filesystem.
+ */
+
+struct local_ring_s
+{
+  mutex_t lr_lock;                 /* Serializes access to the ring */
+  sem_t lr_rdsem;                  /* Readers wait for data */
+  sem_t lr_wrsem;                  /* Writers wait for room */
+  struct circbuf_s lr_buffer;      /* The data in the ring */
+  size_t lr_pollinthrd;            /* Buffer threshold for POLLIN */
+  size_t lr_polloutthrd;           /* Buffer threshold for POLLOUT */
+  uint8_t lr_crefs;                /* The owner and the open files */
+  uint8_t lr_nreaders;             /* Files open for reading */
+  uint8_t lr_nwriters;             /* Files open for writing */
+  uint8_t lr_policy;               /* See PIPEIOC_POLICY */
+#ifdef LOCAL_RING_HANDOFF
+  FAR struct local_reader_s *lr_reader; /* A reader waiting for data */
+#endif
+
+  FAR struct pollfd *lr_fds[LOCAL_RING_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     local_ring_close(FAR struct file *filep);
+static ssize_t local_ring_read(FAR struct file *filep, FAR char *buffer,
+                               size_t len);
+static ssize_t local_ring_write(FAR struct file *filep,
+                                FAR const char *buffer, size_t len);
+static int     local_ring_ioctl(FAR struct file *filep, int cmd,
+                                unsigned long arg);
+static int     local_ring_poll(FAR struct file *filep,
+                               FAR struct pollfd *fds, bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_local_ring_fops =
+{
+  NULL,                 /* open */
+  local_ring_close,     /* close */
+  local_ring_read,      /* read */
+  local_ring_write,     /* write */
+  NULL,                 /* seek */
+  local_ring_ioctl,     /* ioctl */
+  NULL,                 /* mmap */
+  NULL,                 /* truncate */
+  local_ring_poll       /* poll */
+};
+
+static struct inode g_local_ring_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_local_ring_fops    /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_lock
+ *
+ * Description:
+ *   Lock a ring, not giving up on signals, e.g. on closing a file.  Only
+ *   -ECANCELED is returned, if the thread is canceled while waiting, and
+ *   the caller must propagate it.
+ *
+ ****************************************************************************/
+
+static int local_ring_lock(FAR struct local_ring_s *ring)
+{
+  int ret;
+
+  do
+    {
+      ret = nxmutex_lock(&ring->lr_lock);
+    }
+  while (ret == -EINTR);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on a semaphore of the ring.  A count is
+ *   left even if no one waits yet, like in pipecommon_wakeup(): a reader
+ *   or writer that has unlocked the ring but not reached nxsem_wait() yet
+ *   would miss the wakeup otherwise.  The waiters recheck their condition
+ *   under the lock, so a stale count only costs one more loop.
+ *
+ ****************************************************************************/
+
+static void local_ring_wakeup(FAR sem_t *sem)
+{
+  int sval;
+
+  if (nxsem_get_value(sem, &sval) >= 0)
+    {
+      while (sval++ <= 0)
+        {
+          nxsem_post(sem);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Allocate a ring of 'size' bytes, with one reference for its owner.
+ *
+ ****************************************************************************/
+
+static FAR struct local_ring_s *local_ring_alloc(size_t size)
+{
+  FAR struct local_ring_s *ring;
+
+  ring = kmm_zalloc(sizeof(*ring));
+  if (ring == NULL)
+    {
+      return NULL;
+    }
+
+  if (circbuf_init(&ring->lr_buffer, NULL, size) < 0)
+    {
+      kmm_free(ring);
+      return NULL;
+    }
+
+  nxmutex_init(&ring->lr_lock);
+  nxsem_init(&ring->lr_rdsem, 0, 0);
+  nxsem_init(&ring->lr_wrsem, 0, 0);
+  ring->lr_crefs = 1;
+
+  return ring;
+}
+
+/****************************************************************************
+ * Name: local_ring_put
+ *
+ * Description:
+ *   Drop a reference to a locked ring and unlock it.  The ring is freed
+ *   with the last reference.
+ *
+ ****************************************************************************/
+
+static void local_ring_put(FAR struct local_ring_s *ring)
+{
+  bool last;
+
+  DEBUGASSERT(ring->lr_crefs > 0);
+
+  last = --ring->lr_crefs == 0;
+  nxmutex_unlock(&ring->lr_lock);
+
+  if (last)
+    {
+      circbuf_uninit(&ring->lr_buffer);
+      nxsem_destroy(&ring->lr_rdsem);
+      nxsem_destroy(&ring->lr_wrsem);
+      nxmutex_destroy(&ring->lr_lock);
+      kmm_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Drop the reference of the owner to a ring, if there is one.
+ *
+ ****************************************************************************/
+
+static int local_ring_release(FAR struct local_ring_s **ring)
+{
+  int ret = OK;
+
+  if (*ring != NULL)
+    {
+      /* The reference is kept if the task was canceled */
+
+      ret = local_ring_lock(*ring);
+      if (ret >= 0)
+        {
+          local_ring_put(*ring);
+          *ring = NULL;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_open
+ *
+ * Description:
+ *   Open a ring for read-only or write-only access.
+ *
+ ****************************************************************************/
+
+static int local_ring_open(FAR struct local_ring_s *ring,
+                           FAR struct file *filep, int oflags,
+                           bool nonblock)
+{
+  int ret;
+
+  if (ring == NULL)
+    {
+      /* Consistent with the error of connect() for a missing FIFO */
+
+      return -EFAULT;
+    }
+
+  ret = local_ring_lock(ring);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  DEBUGASSERT(ring->lr_crefs < UINT8_MAX);
+  ring->lr_crefs++;
+
+  if ((oflags & O_RDOK) != 0)
+    {
+      ring->lr_nreaders++;
+    }
+
+  if ((oflags & O_WROK) != 0)
+    {
+      ring->lr_nwriters++;
+    }
+
+  nxmutex_unlock(&ring->lr_lock);
+
+  /* The inode is shared by all rings, take a reference like
+   * inode_addref() for the inode_release() in file_close().
+   */
+
+  atomic_fetch_add(&g_local_ring_inode.i_crefs, 1);
+
+  memset(filep, 0, sizeof(*filep));
+  filep->f_oflags = oflags | O_CLOEXEC | (nonblock ? O_NONBLOCK : 0);
+  filep->f_inode  = &g_local_ring_inode;
+  filep->f_priv   = ring;
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_close
+ ****************************************************************************/
+
+static int local_ring_close(FAR struct file *filep)
+{
+  FAR struct local_ring_s *ring = filep->f_priv;
+  int ret;
+
+  DEBUGASSERT(ring != NULL);
+
+  ret = local_ring_lock(ring);
+  if (ret < 0)
+    {
+      /* The close will not be performed if the task was canceled */
+
+      return ret;
+    }
+
+  /* If there are no longer any writers, then notify all of the waiting
+   * readers that they must return end-of-file.
+   */
+
+  if ((filep->f_oflags & O_WROK) != 0 && --ring->lr_nwriters == 0)
+    {
+      poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLHUP);
+      local_ring_wakeup(&ring->lr_rdsem);
+    }
+
+  /* And the writers that there is no one to read their data */
+
+  if ((filep->f_oflags & O_RDOK) != 0 && --ring->lr_nreaders == 0 &&
+      ring->lr_policy == 0)
+    {
+      poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLERR);
+      local_ring_wakeup(&ring->lr_wrsem);
+    }
+
+  local_ring_put(ring);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_read
+ ****************************************************************************/
+
+static ssize_t local_ring_read(FAR struct file *filep, FAR char *buffer,
+                               size_t len)
+{
+  FAR struct local_ring_s *ring = filep->f_priv;
+#ifdef LOCAL_RING_HANDOFF
+  struct local_reader_s reader;
+  int lret;
+#endif
+  ssize_t nread;
+  int ret;
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  ret = nxmutex_lock(&ring->lr_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#ifdef LOCAL_RING_HANDOFF
+  reader.buf   = (FAR uint8_t *)buffer;
+  reader.len   = len;
+  reader.nread = 0;
+#endif
+
+  /* If the ring is empty, then wait for something to be written to it */
+
+  while (circbuf_is_empty(&ring->lr_buffer))
+    {
+      /* If there are no writers, then return end of file */
+
+      if (ring->lr_nwriters == 0 && ring->lr_policy == 0)
+        {
+          nxmutex_unlock(&ring->lr_lock);
+          return 0;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          nxmutex_unlock(&ring->lr_lock);
+          return -EAGAIN;
+        }
+
+#ifdef LOCAL_RING_HANDOFF
+      /* Let the next writer copy its data to our buffer */
+
+      if (ring->lr_reader == NULL)
+        {
+          ring->lr_reader = &reader;
+        }
+#endif
+
+      nxmutex_unlock(&ring->lr_lock);
+      ret = nxsem_wait(&ring->lr_rdsem);
+
+#ifdef LOCAL_RING_HANDOFF
+      /* The writers must forget our buffer before we return, and a writer
+       * may still be copying to it, so the lock cannot be given up here.
+       * A cancellation interrupts the wait only once per request.
+       */
+
+      do
+        {
+          lret = nxmutex_lock(&ring->lr_lock);
+        }
+      while (lret < 0);
+
+      if (ring->lr_reader == &reader)
+        {
+          ring->lr_reader = NULL;
+        }
+
+      if (reader.nread > 0)
+        {
+          nxmutex_unlock(&ring->lr_lock);
+          return reader.nread;
+        }
+
+      if (ret < 0)
+        {
+          nxmutex_unlock(&ring->lr_lock);
+          return ret;
+        }
+#else
+      if (ret < 0 || (ret = nxmutex_lock(&ring->lr_lock)) < 0)
+        {
+          return ret;
+        }
+#endif
+    }
+
+  /* Then return whatever is available in the ring */
+
+  nread = circbuf_read(&ring->lr_buffer, buffer, len);
+
+  /* Notify the poll waiters that they can write once the ring can accept
+   * more than lr_polloutthrd bytes, and the blocked writers anyway.
+   */
+
+  if (circbuf_space(&ring->lr_buffer) >= ring->lr_polloutthrd)
+    {
+      poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLOUT);
+    }
+
+  local_ring_wakeup(&ring->lr_wrsem);
+
+  nxmutex_unlock(&ring->lr_lock);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: local_ring_write
+ ****************************************************************************/
+
+static ssize_t local_ring_write(FAR struct file *filep,
+                                FAR const char *buffer, size_t len)
+{
+  FAR struct local_ring_s *ring = filep->f_priv;
+#ifdef LOCAL_RING_HANDOFF
+  FAR struct local_reader_s *reader;
+  size_t ncopy;
+#endif
+  ssize_t nwritten = 0;
+  ssize_t last = 0;
+  int ret;
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  ret = nxmutex_lock(&ring->lr_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      if (ring->lr_nreaders == 0 && ring->lr_policy == 0)
+        {
+          nxmutex_unlock(&ring->lr_lock);
+          return nwritten == 0 ? -EPIPE : nwritten;
+        }
+
+#ifdef LOCAL_RING_HANDOFF
+      /* Copy straight to a waiting reader if no data is queued before */
+
+      reader = ring->lr_reader;
+      if (reader != NULL && circbuf_is_empty(&ring->lr_buffer))
+        {
+          ncopy = MIN(len - nwritten, reader->len);
+          memcpy(reader->buf, buffer + nwritten, ncopy);
+
+          reader->nread   = ncopy;
+          ring->lr_reader = NULL;
+          nwritten       += ncopy;
+
+          local_ring_wakeup(&ring->lr_rdsem);
+        }
+#endif
+
+      nwritten += circbuf_write(&ring->lr_buffer, buffer + nwritten,
+                                len - nwritten);
+      if (nwritten == len)
+        {
+          /* Notify the poll waiters that they can read once the ring
+           * holds more than lr_pollinthrd bytes.
+           */
+
+          if (circbuf_used(&ring->lr_buffer) > ring->lr_pollinthrd)
+            {
+              poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLIN);
+            }
+
+          local_ring_wakeup(&ring->lr_rdsem);
+
+          nxmutex_unlock(&ring->lr_lock);
+          return len;
+        }
+
+      /* The ring is full.  Was anything written in this pass? */
+
+      if (last < nwritten)
+        {
+          poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLIN);
+          local_ring_wakeup(&ring->lr_rdsem);
+        }
+
+      last = nwritten;
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          nxmutex_unlock(&ring->lr_lock);
+          return nwritten == 0 ? -EAGAIN : nwritten;
+        }
+
+      /* Wait for data to be removed from the ring */
+
+      nxmutex_unlock(&ring->lr_lock);
+      ret = nxsem_wait(&ring->lr_wrsem);
+      if (ret < 0 || (ret = nxmutex_lock(&ring->lr_lock)) < 0)
+        {
+          return nwritten == 0 ? (ssize_t)ret : nwritten;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_ioctl
+ *
+ * Description:
+ *   Support the FIFO ioctl commands used on the files of a connection.
+ *
+ ****************************************************************************/
+
+static int local_ring_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg)
+{
+  FAR struct local_ring_s *ring = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&ring->lr_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case PIPEIOC_POLICY:
+        ring->lr_policy = arg != 0;
+        break;
+
+      case PIPEIOC_POLLINTHRD:
+      case PIPEIOC_POLLOUTTHRD:
+        if (arg >= circbuf_size(&ring->lr_buffer))
+          {
+            ret = -EINVAL;
+          }
+        else if (cmd == PIPEIOC_POLLINTHRD)
+          {
+            ring->lr_pollinthrd = arg;
+          }
+        else
+          {
+            ring->lr_polloutthrd = arg;
+          }
+        break;
+
+      case PIPEIOC_PEEK:
+        {
+          FAR struct pipe_peek_s *peek =
+            (FAR struct pipe_peek_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(peek != NULL && peek->buf != NULL);
+
+          ret = circbuf_peekat(&ring->lr_buffer,
+                               ring->lr_buffer.tail + peek->offset,
+                               peek->buf, peek->size);
+        }
+        break;
+
+      case PIPEIOC_SETSIZE:
+        if (arg == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            ret = circbuf_resize(&ring->lr_buffer,
+                                 MIN(arg, CONFIG_DEV_PIPE_MAXSIZE));
+          }
+        break;
+
+      case PIPEIOC_GETSIZE:
+        ret = circbuf_size(&ring->lr_buffer);
+        break;
+
+      case FIONWRITE:
+      case FIONREAD:
+        *(FAR int *)((uintptr_t)arg) = circbuf_used(&ring->lr_buffer);
+        break;
+
+      case FIONSPACE:
+        *(FAR int *)((uintptr_t)arg) = circbuf_space(&ring->lr_buffer);
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&ring->lr_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_poll
+ ****************************************************************************/
+
+static int local_ring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup)
+{
+  FAR struct local_ring_s *ring = filep->f_priv;
+  pollevent_t eventset;
+  size_t nbytes;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&ring->lr_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+        {
+          if (ring->lr_fds[i] == NULL)
+            {
+              ring->lr_fds[i] = fds;
+              fds->priv       = &ring->lr_fds[i];
+              break;
+            }
+        }
+
+      if (i >= LOCAL_RING_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          nxmutex_unlock(&ring->lr_lock);
+          return -EBUSY;
+        }
+
+      /* Report the events that are already there, as a FIFO does */
+
+      nbytes   = circbuf_used(&ring->lr_buffer);
+      eventset = 0;
+
+      if ((filep->f_oflags & O_WROK) != 0 &&
+          circbuf_space(&ring->lr_buffer) > ring->lr_polloutthrd)
+        {
+          eventset |= POLLOUT;
+          if (ring->lr_nreaders == 0 && ring->lr_policy == 0)
+            {
+              eventset |= POLLERR;
+            }
+        }
+
+      if ((filep->f_oflags & O_RDOK) != 0 && nbytes > ring->lr_pollinthrd)
+        {
+          eventset |= POLLIN;
+        }
+
+      if (nbytes == 0 && ring->lr_nwriters == 0)
+        {
+          eventset |= POLLHUP;
+        }
+
+      poll_notify(&fds, 1, eventset);
+    }
+  else
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+    }
+
+  nxmutex_unlock(&ring->lr_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_create
+ *
+ * Description:
+ *   Create the ring of a connection if it does not exist yet.
+ *
+ ****************************************************************************/
+
+static int local_ring_create(FAR struct local_ring_s **ring, size_t size)
+{
+  if (*ring == NULL)
+    {
+      *ring = local_ring_alloc(size);
+      if (*ring == NULL)
+        {
+          nerr("ERROR: Failed to allocate a ring of %zu bytes\n", size);
+          return -ENOMEM;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_hd_conn
+ *
+ * Description:
+ *   Find the datagram socket bound to 'path', which owns the half duplex
+ *   ring to that path.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+static FAR struct local_conn_s *
+local_hd_conn(FAR struct local_conn_s *conn, FAR const char *path)
+{
+  FAR struct local_conn_s *receiver = NULL;
+
+  /* An abstract name starts with a NUL, which is not in lc_path */
+
+  if (path[0] == '\0')
+    {
+      path++;
+    }
+
+  if (strncmp(conn->lc_path, path, UNIX_PATH_MAX - 1) == 0)
+    {
+      return conn;
+    }
+
+  while ((receiver = local_nextconn(receiver)) != NULL)
+    {
+      if (receiver->lc_proto == SOCK_DGRAM &&
+          receiver->lc_type != LOCAL_TYPE_UNNAMED &&
+          strncmp(receiver->lc_path, path, UNIX_PATH_MAX - 1) == 0)
+        {
+          return receiver;
+        }
+    }
+
+  return NULL;
+}
+#endif /* CONFIG_NET_LOCAL_DGRAM */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_set_pollthreshold
+ *
+ * Description:
+ *   Set the local pollin and pollout threshold:
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+int local_set_pollthreshold(FAR struct local_conn_s *conn,
+                            unsigned long threshold)
+{
+  int ret;
+
+  ret = file_ioctl(&conn->lc_infile, PIPEIOC_POLLINTHRD, threshold);
+  if (ret >= 0)
+    {
+      ret = file_ioctl(&conn->lc_outfile, PIPEIOC_POLLOUTTHRD, threshold);
+    }
+
+  return ret;
+}
+#endif /* CONFIG_NET_LOCAL_DGRAM */
+
+/****************************************************************************
+ * Name: local_create_fifos
+ *
+ * Description:
+ *   Create the ring pair needed for a SOCK_STREAM connection.  The rings
+ *   are owned by the connection that later opens them as server.
+ *
+ ****************************************************************************/
+
+int local_create_fifos(FAR struct local_conn_s *conn,
+                       uint32_t cssize, uint32_t scsize)
+{
+  int ret;
+
+  ret = local_ring_create(&conn->lc_cs, cssize);
+  if (ret >= 0)
+    {
+      ret = local_ring_create(&conn->lc_sc, scsize);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_create_halfduplex
+ *
+ * Description:
+ *   Create the half-duplex ring needed for SOCK_DGRAM communication.  The
+ *   ring is owned by the socket bound to 'path'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+int local_create_halfduplex(FAR struct local_conn_s *conn,
+                            FAR const char *path, uint32_t bufsize)
+{
+  FAR struct local_conn_s *receiver;
+  int ret;
+
+  net_lock();
+
+  receiver = local_hd_conn(conn, path);
+  if (receiver == NULL)
+    {
+      ret = -ENOENT;
+    }
+  else if (receiver->lc_hd != NULL)
+    {
+      ret = OK;
+    }
+  else
+    {
+      ret = local_ring_create(&receiver->lc_hd, bufsize);
+      if (ret >= 0)
+        {
+          /* Policy: Keep the data without readers, like the FIFO.  Poll
+           * only once more than the preamble length can be transferred,
+           * the reader would fail with -EAGAIN in the middle of a packet
+           * otherwise.
+           */
+
+          receiver->lc_hd->lr_policy      = 1;
+          receiver->lc_hd->lr_pollinthrd  = 2 * sizeof(lc_size_t);
+          receiver->lc_hd->lr_polloutthrd = 2 * sizeof(lc_size_t);
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif /* CONFIG_NET_LOCAL_DGRAM */
+
+/****************************************************************************
+ * Name: local_release_fifos
+ *
+ * Description:
+ *   Release the references of a connection to the rings that it owns.  The
+ *   rings are freed once their peers have closed them as well.
+ *
+ ****************************************************************************/
+
+int local_release_fifos(FAR struct local_conn_s *conn)
+{
+  int ret;
+
+  net_lock();
+
+  ret = local_ring_release(&conn->lc_cs);
+  if (ret >= 0)
+    {
+      ret = local_ring_release(&conn->lc_sc);
+    }
+
+  if (ret >= 0)
+    {
+      ret = local_ring_release(&conn->lc_hd);
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_release_halfduplex
+ *
+ * Description:
+ *   Release a reference to the ring used for SOCK_DGRAM communication.  The
+ *   ring stays with its owner until that is released, so that packets are
+ *   not lost between the receive calls.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+int local_release_halfduplex(FAR struct local_conn_s *conn)
+{
+  return OK;
+}
+#endif /* CONFIG_NET_LOCAL_DGRAM */
+
+/****************************************************************************
+ * Name: local_open_client_rx
+ *
+ * Description:
+ *   Open the client-side of the server-to-client ring.
+ *
+ ****************************************************************************/
+
+int local_open_client_rx(FAR struct local_conn_s *client,
+                         FAR struct local_conn_s *server, bool nonblock)
+{
+  return local_ring_open(server->lc_sc, &client->lc_infile, O_RDONLY,
+                         nonblock);
+}
+
+/****************************************************************************
+ * Name: local_open_client_tx
+ *
+ * Description:
+ *   Open the client-side of the client-to-server ring.
+ *
+ ****************************************************************************/
+
+int local_open_client_tx(FAR struct local_conn_s *client,
+                         FAR struct local_conn_s *server, bool nonblock)
+{
+  return local_ring_open(server->lc_cs, &client->lc_outfile, O_WRONLY,
+                         nonblock);
+}
+
+/****************************************************************************
+ * Name: local_open_server_rx
+ *
+ * Description:
+ *   Open the server-side of the client-to-server ring.
+ *
+ ****************************************************************************/
+
+int local_open_server_rx(FAR struct local_conn_s *server, bool nonblock)
+{
+  return local_ring_open(server->lc_cs, &server->lc_infile, O_RDONLY,
+                         nonblock);
+}
+
+/****************************************************************************
+ * Name: local_open_server_tx
+ *
+ * Description:
+ *   Open the server-side of the server-to-client ring.
+ *
+ ****************************************************************************/
+
+int local_open_server_tx(FAR struct local_conn_s *server, bool nonblock)
+{
+  return local_ring_open(server->lc_sc, &server->lc_outfile, O_WRONLY,
+                         nonblock);
+}
+
+/****************************************************************************
+ * Name: local_open_receiver
+ *
+ * Description:
+ *   Open the receiving side of the half duplex ring.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+int local_open_receiver(FAR struct local_conn_s *conn, bool nonblock)
+{
+  int ret;
+
+  net_lock();
+  ret = local_ring_open(conn->lc_hd, &conn->lc_infile, O_RDONLY, nonblock);
+  net_unlock();
+
+  return ret;
+}
+#endif /* CONFIG_NET_LOCAL_DGRAM */
+
+/****************************************************************************
+ * Name: local_open_sender
+ *
+ * Description:
+ *   Open the sending side of the half duplex ring.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
+                      bool nonblock)
+{
+  FAR struct local_conn_s *receiver;
+  int ret = -EFAULT;
+
+  net_lock();
+
+  receiver = local_hd_conn(conn, path);
+  if (receiver != NULL)
+    {
+      ret = local_ring_open(receiver->lc_hd, &conn->lc_outfile, O_WRONLY,
+                            nonblock);
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif /* CONFIG_NET_LOCAL_DGRAM */
+
+/****************************************************************************
+ * Name: local_set_nonblocking
+ *
+ * Description:
+ *   Set the local conntion to nonblocking mode
+ *
+ ****************************************************************************/
+
+int local_set_nonblocking(FAR struct local_conn_s *conn)
+{
+  int nonblock = 1;
+  int ret;
+
+  ret  = file_ioctl(&conn->lc_infile, FIONBIO, &nonblock);
+  ret |= file_ioctl(&conn->lc_outfile, FIONBIO, &nonblock);
+
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to set the conn to nonblocking mode: %d\n", ret);
+    }
+
+  return ret;
+}
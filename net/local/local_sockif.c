@@ -1053,9 +1053,11 @@ static int local_socketpair(FAR struct socket *psocks[2])
                            = -1;
 #endif
 
-  /* Create the FIFOs needed for the connection */
+  /* Create the FIFOs needed for the connection.  They are opened as the
+   * ones of the server, conns[1].
+   */
 
-  ret = local_create_fifos(conns[0], conns[0]->lc_rcvsize,
+  ret = local_create_fifos(conns[1], conns[0]->lc_rcvsize,
                            conns[1]->lc_rcvsize);
   if (ret < 0)
     {
@@ -1116,7 +1118,7 @@ static int local_socketpair(FAR struct socket *psocks[2])
   return OK;
 
 errout:
-  local_release_fifos(conns[0]);
+  local_release_fifos(conns[1]);
   return ret;
 }
 
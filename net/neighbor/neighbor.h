@@ -35,18 +35,64 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
 #include <nuttx/net/neighbor.h>
+#include <nuttx/queue.h>
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_IPv6_NCONF_ALLOC
+#  define CONFIG_NET_IPv6_NCONF_ALLOC 0
+#endif
+
+#ifndef CONFIG_NET_IPv6_NCONF_MAX
+#  define CONFIG_NET_IPv6_NCONF_MAX 0
+#endif
+
+#ifndef CONFIG_NET_IPv6_NCONF_HASHSIZE
+#  define CONFIG_NET_IPv6_NCONF_HASHSIZE 8
+#endif
+
+/* The maximum number of entries in the Neighbor table */
+
+#if CONFIG_NET_IPv6_NCONF_ALLOC > 0
+#  define NEIGHBOR_TABLE_SIZE CONFIG_NET_IPv6_NCONF_MAX
+#else
+#  define NEIGHBOR_TABLE_SIZE CONFIG_NET_IPv6_NCONF_ENTRIES
+#endif
+
+/* Get the node of the Neighbor table that holds an entry */
+
+#define NEIGHBOR_NODE(e) container_of(e, struct neighbor_node_s, nn_entry)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One node of the Neighbor table.  The entry is kept apart from the links
+ * because neighbor_snapshot() copies it out as it is.
+ */
+
+struct neighbor_node_s
+{
+  dq_entry_t              nn_hash;   /* Link in its hash bucket */
+  dq_entry_t              nn_lru;    /* Link in the list by ne_time */
+  struct neighbor_entry_s nn_entry;  /* The entry */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* This is the Neighbor table.  The network should be locked when accessing
- * this table.
+/* This is the Neighbor table.  The entries in use are hashed by their IPv6
+ * address and linked in the order of their last use, the least recently
+ * used one first.  The network should be locked when accessing this table.
  */
 
-extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern dq_queue_t g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+extern dq_queue_t g_neighbor_lru;
 
 /****************************************************************************
  * Public Function Prototypes
@@ -54,6 +100,23 @@ extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
 struct net_driver_s; /* Forward reference */
 
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Get the bucket of the hash table of the Neighbor Table that holds the
+ *   entries of an IPv6 address.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address
+ *
+ * Returned Value:
+ *   The hash bucket.
+ *
+ ****************************************************************************/
+
+FAR dq_queue_t *neighbor_hash(const net_ipv6addr_t ipaddr);
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -36,11 +36,98 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/neighbor.h>
+#include <nuttx/net/netstats.h>
 
 #include "netdev/netdev.h"
 #include "netlink/netlink.h"
+#include "utils/utils.h"
 #include "neighbor/neighbor.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The nodes of the Neighbor table */
+
+NET_BUFPOOL_DECLARE(g_neighbor_nodes, sizeof(struct neighbor_node_s),
+                    CONFIG_NET_IPv6_NCONF_ENTRIES,
+                    CONFIG_NET_IPv6_NCONF_ALLOC, CONFIG_NET_IPv6_NCONF_MAX);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_find
+ *
+ * Description:
+ *   Find the entry of an IPv6 address on a link layer type.
+ *
+ ****************************************************************************/
+
+static FAR struct neighbor_node_s *neighbor_find(FAR net_ipv6addr_t ipaddr,
+                                                 uint8_t lltype)
+{
+  FAR struct neighbor_node_s *nn;
+  FAR dq_entry_t *node;
+
+  for (node = dq_peek(neighbor_hash(ipaddr)); node != NULL;
+       node = dq_next(node))
+    {
+      nn = container_of(node, struct neighbor_node_s, nn_hash);
+      if (nn->nn_entry.ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(nn->nn_entry.ne_ipaddr, ipaddr))
+        {
+          return nn;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Get an unused node for a new entry.  If the table is full, the least
+ *   recently used entry is replaced.
+ *
+ * Returned Value:
+ *   The new node, not linked to any list.  NULL is returned if no node is
+ *   available.
+ *
+ ****************************************************************************/
+
+static FAR struct neighbor_node_s *neighbor_alloc(void)
+{
+  FAR struct neighbor_node_s *nn;
+  FAR dq_entry_t *node;
+
+  nn = NET_BUFPOOL_TRYALLOC(g_neighbor_nodes);
+  if (nn != NULL)
+    {
+      return nn;
+    }
+
+  node = dq_remfirst(&g_neighbor_lru);
+  if (node == NULL)
+    {
+      return NULL;
+    }
+
+  nn = container_of(node, struct neighbor_node_s, nn_lru);
+  dq_rem(&nn->nn_hash, neighbor_hash(nn->nn_entry.ne_ipaddr));
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.nd.evictions++;
+#endif
+
+  /* When overwriting an old entry, need to notify RTM_DELNEIGH */
+
+  netlink_neigh_notify(&nn->nn_entry, RTM_DELNEIGH, AF_INET6);
+  return nn;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,78 +152,64 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry_s *neighbor;
+  FAR struct neighbor_node_s *nn;
   uint8_t lltype;
-  clock_t oldest_time;
-  int     oldest_ndx;
-  bool    found = false;
   bool    new_entry;
-  int     i;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
-   */
+  /* Find the matching entry or get a new one */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  lltype = dev->d_lltype;
+  nn     = neighbor_find(ipaddr, lltype);
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  if (nn != NULL)
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
-        {
-          oldest_ndx = i;
-          found = true;
-          break;
-        }
+      neighbor = &nn->nn_entry;
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
-        {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
-        }
-    }
+      /* Need to notify when the entry changes */
 
-  /* When overwrite old entry, need to notify RTM_DELNEIGH */
+      new_entry = memcmp(&neighbor->ne_addr.u, addr,
+                         neighbor->ne_addr.na_llsize) != 0;
 
-  if (!found && g_neighbors[oldest_ndx].ne_time != 0)
-    {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_DELNEIGH,
-                           AF_INET6);
-    }
+      /* Make it the most recently used entry */
 
-  /* Need to notify when entry is not found or changes in table */
+      dq_rem(&nn->nn_lru, &g_neighbor_lru);
+    }
+  else
+    {
+      nn = neighbor_alloc();
+      if (nn == NULL)
+        {
+          nerr("ERROR: No free neighbor entry\n");
+          return;
+        }
 
-  new_entry = !found || memcmp(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-                             g_neighbors[oldest_ndx].ne_addr.na_llsize) != 0;
+      neighbor  = &nn->nn_entry;
+      new_entry = true;
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+      net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
+      neighbor->ne_addr.na_lltype = lltype;
+      dq_addlast(&nn->nn_hash, neighbor_hash(ipaddr));
+    }
 
-  g_neighbors[oldest_ndx].ne_dev  = dev;
-  g_neighbors[oldest_ndx].ne_time = clock_systime_ticks();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  dq_addlast(&nn->nn_lru, &g_neighbor_lru);
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  neighbor->ne_dev  = dev;
+  neighbor->ne_time = clock_systime_ticks();
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  neighbor->ne_addr.na_llsize = netdev_lladdrsize(dev);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
   /* Notify the new entry */
 
   if (new_entry)
     {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_NEWNEIGH,
-                           AF_INET6);
+      netlink_neigh_notify(neighbor, RTM_NEWNEIGH, AF_INET6);
     }
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
@@ -29,6 +29,8 @@
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/net/netstats.h>
+
 #include "neighbor/neighbor.h"
 
 /****************************************************************************
@@ -53,11 +55,21 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR dq_entry_t *node;
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.nd.lookups++;
+#endif
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (node = dq_peek(neighbor_hash(ipaddr)); node != NULL;
+       node = dq_next(node))
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      FAR struct neighbor_entry_s *neighbor =
+        &container_of(node, struct neighbor_node_s, nn_hash)->nn_entry;
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.nd.probes++;
+#endif
 
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
@@ -66,6 +78,10 @@ FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
         }
     }
 
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.nd.misses++;
+#endif
+
   neighbor_dumpipaddr("Not found", ipaddr);
   return NULL;
 }
@@ -26,8 +26,19 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 #include "neighbor/neighbor.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_IPv6_NCONF_HASHSIZE & \
+     (CONFIG_NET_IPv6_NCONF_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_IPv6_NCONF_HASHSIZE must be a power of two
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -36,8 +47,43 @@
  * this table.
  */
 
-struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+dq_queue_t g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+dq_queue_t g_neighbor_lru;
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Get the bucket of the hash table of the Neighbor Table that holds the
+ *   entries of an IPv6 address.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address
+ *
+ * Returned Value:
+ *   The hash bucket.
+ *
+ ****************************************************************************/
+
+FAR dq_queue_t *neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint32_t key = 0;
+  int i;
+
+  /* Fold the address in host order and take the bucket from the top bits
+   * of the product, see ARP_HASH_BUCKET().
+   */
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= (uint32_t)NTOHS(ipaddr[i]) << 16 | NTOHS(ipaddr[i + 1]);
+    }
+
+  key *= 2654435761u;
+  return &g_neighbor_hash[((uint64_t)key *
+                           CONFIG_NET_IPv6_NCONF_HASHSIZE) >> 32];
+}
@@ -31,7 +31,6 @@
 
 #include <nuttx/net/ip.h>
 
-#include "inet/inet.h"
 #include "neighbor/neighbor.h"
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -63,28 +62,19 @@
 unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
                                unsigned int nentries)
 {
+  FAR dq_entry_t *node;
   unsigned int ncopied;
-  int i;
 
-  /* Copy all non-empty entries in the Neighbor table. */
+  /* Copy all entries in the Neighbor table. */
 
-  for (i = 0, ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_IPv6_NCONF_ENTRIES;
-       i++)
+  for (node = dq_peek(&g_neighbor_lru), ncopied = 0;
+       nentries > ncopied && node != NULL;
+       node = dq_next(node))
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
-
-      /* An unused entry table entry will be nullified.  In particularly,
-       * the Neighbor IP address will be all zero (i.e., the unspecified
-       * IPv6 address).
-       */
-
-      if (!net_ipv6addr_cmp(neighbor->ne_ipaddr, g_ipv6_unspecaddr))
-        {
-          memcpy(&snapshot[ncopied], neighbor,
-                 sizeof(struct neighbor_entry_s));
-          ncopied++;
-        }
+      memcpy(&snapshot[ncopied],
+             &container_of(node, struct neighbor_node_s, nn_lru)->nn_entry,
+             sizeof(struct neighbor_entry_s));
+      ncopied++;
     }
 
   /* Return the number of entries copied into the user buffer */
@@ -55,6 +55,11 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
+      FAR struct neighbor_node_s *nn = NEIGHBOR_NODE(neighbor);
+
       neighbor->ne_time = clock_systime_ticks();
+
+      dq_rem(&nn->nn_lru, &g_neighbor_lru);
+      dq_addlast(&nn->nn_lru, &g_neighbor_lru);
     }
 }
@@ -0,0 +1,230 @@
+/****************************************************************************
+ * net/netdev/netdev_csum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
+
+#include "devif/devif.h"
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_csum_l4off
+ *
+ * Description:
+ *   Get the offset of the TCP or UDP header and the protocol of the packet
+ *   in d_iob.
+ *
+ ****************************************************************************/
+
+static uint16_t netdev_csum_l4off(FAR struct net_driver_s *dev,
+                                  FAR uint8_t *proto)
+{
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      *proto = IPv4BUF->proto;
+      return (IPv4BUF->vhl & IPv4_HLMASK) << 2;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  *proto = IPv6BUF->proto;
+  return IPv6_HDRLEN;
+#else
+  *proto = 0;
+  return 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_csum_field
+ *
+ * Description:
+ *   Get the checksum field of the TCP or UDP header at l4off.
+ *
+ ****************************************************************************/
+
+static FAR uint16_t *netdev_csum_field(FAR struct net_driver_s *dev,
+                                       uint16_t l4off, uint8_t proto)
+{
+  if (proto == IP_PROTO_TCP)
+    {
+      return IPBUF(l4off + offsetof(struct tcp_hdr_s, tcpchksum));
+    }
+  else
+    {
+      return IPBUF(l4off + offsetof(struct udp_hdr_s, udpchksum));
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_csum_partial
+ *
+ * Description:
+ *   Leave the TCP or UDP checksum of the outgoing packet in d_iob to the
+ *   driver if it is able to compute it.  On success only the pseudo header
+ *   sum is stored in the checksum field and the packet is marked as
+ *   NETDEV_CSUM_PARTIAL.
+ *
+ * Input Parameters:
+ *   dev    - The network device that sends the packet
+ *   proto  - IP_PROTO_TCP or IP_PROTO_UDP
+ *   chksum - The checksum field in the TCP or UDP header
+ *
+ * Returned Value:
+ *   true if the driver completes the checksum, false if the caller has to
+ *   compute it.
+ *
+ * Assumptions:
+ *   The caller has locked the network and the IP header is complete.
+ *
+ ****************************************************************************/
+
+bool netdev_csum_partial(FAR struct net_driver_s *dev, uint8_t proto,
+                         FAR uint16_t *chksum)
+{
+  uint8_t l4proto;
+  uint16_t sum;
+
+  dev->d_csumstate = NETDEV_CSUM_NONE;
+
+  if ((dev->d_csumcap & NETDEV_CSUM_TX) == 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_NAT
+  /* NAT rewrites the ports and adjusts the checksum for a full one */
+
+  if (IFF_IS_NAT(dev->d_flags))
+    {
+      return false;
+    }
+#endif
+
+  /* An IP fragment carries only a part of the payload, the driver cannot
+   * checksum the whole datagram then.
+   */
+
+  if (dev->d_iob->io_pktlen > devif_get_mtu(dev)
+#ifdef CONFIG_NETDEV_GSO
+      && dev->d_gsosize == 0
+#endif
+     )
+    {
+      return false;
+    }
+
+  /* The driver expects the TCP or UDP header right after the IP header */
+
+  netdev_csum_l4off(dev, &l4proto);
+  if (l4proto != proto)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      sum = ipv4_upperlayer_header_chksum(dev, proto);
+    }
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv6
+      sum = ipv6_upperlayer_header_chksum(dev, proto, IPv6_HDRLEN);
+#else
+      return false;
+#endif
+    }
+
+  *chksum = HTONS(sum);
+  dev->d_csumstate = NETDEV_CSUM_PARTIAL;
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_csum_complete
+ *
+ * Description:
+ *   Compute the TCP or UDP checksum of a NETDEV_CSUM_PARTIAL packet in
+ *   d_iob in software, for the paths where the packet cannot be handed to
+ *   the driver together with its checksum state.
+ *
+ * Input Parameters:
+ *   dev - The network device that holds the packet
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+void netdev_csum_complete(FAR struct net_driver_s *dev)
+{
+  FAR uint16_t *chksum;
+  uint16_t l4off;
+  uint16_t sum;
+  uint8_t proto;
+
+  if (dev->d_csumstate != NETDEV_CSUM_PARTIAL)
+    {
+      return;
+    }
+
+  dev->d_csumstate = NETDEV_CSUM_NONE;
+
+  /* The checksum field holds the pseudo header sum, summing up the whole
+   * TCP or UDP segment gives the final value.
+   */
+
+  l4off  = netdev_csum_l4off(dev, &proto);
+  chksum = netdev_csum_field(dev, l4off, proto);
+  sum    = ~chksum_iob(0, dev->d_iob, l4off);
+
+  if (sum == 0 && proto == IP_PROTO_UDP)
+    {
+      sum = 0xffff;
+    }
+
+  *chksum = HTONS(sum);
+}
+
+#endif /* CONFIG_NETDEV_CSUM_OFFLOAD */
@@ -82,6 +82,12 @@ int netdev_iob_prepare(FAR struct net_driver_s *dev, bool throttled,
   /* Set the device buffer to l2 */
 
   dev->d_buf = NETLLBUF;
+#ifdef CONFIG_NETDEV_GSO
+  dev->d_gsosize = 0;
+#endif
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  dev->d_csumstate = NETDEV_CSUM_NONE;
+#endif
 
   return OK;
 }
@@ -191,6 +197,12 @@ void netdev_iob_release(FAR struct net_driver_s *dev)
     }
 
   dev->d_buf = NULL;
+#ifdef CONFIG_NETDEV_GSO
+  dev->d_gsosize = 0;
+#endif
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  dev->d_csumstate = NETDEV_CSUM_NONE;
+#endif
 }
 
 /****************************************************************************
@@ -731,6 +731,7 @@ static ssize_t net_ioctl_ifreq_arglen(uint8_t domain, int cmd)
       case SIOCSIFNAME:
       case SIOCGIFNAME:
       case SIOCGIFINDEX:
+      case SIOCETHTOOL:
         return sizeof(struct ifreq);
 
       case SIOCSIFADDR:
@@ -1239,6 +1240,20 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
         break;
 #endif
 
+#ifdef CONFIG_NETDEV_IOCTL
+      case SIOCETHTOOL:  /* Ethtool interface */
+        if (dev->d_ioctl)
+          {
+            ret = dev->d_ioctl(dev, cmd,
+                               (unsigned long)(uintptr_t)req->ifr_data);
+          }
+        else
+          {
+            ret = -ENOSYS;
+          }
+        break;
+#endif
+
 #ifdef CONFIG_NETDEV_IFINDEX
       case SIOCGIFINDEX:  /* Index to name mapping */
         req->ifr_ifindex = dev->d_ifindex;
@@ -370,6 +370,7 @@ static void adjust_ipv4filter(FAR const struct ipt_replace *repl)
   FAR const uint8_t *head;
   enum ipfilter_chain_e chain;
   enum nf_inet_hooks hook;
+  uint32_t entryno;
   size_t size;
 
   for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
@@ -387,19 +388,27 @@ static void adjust_ipv4filter(FAR const struct ipt_replace *repl)
       /* We need the underflow entry as the default of the chain. */
 
       size++;
+      entryno = 0;
 
       ipt_entry_for_every(entry, head, size)
         {
           FAR struct ipv4_filter_entry_s *filter = convert_ipv4entry(entry);
           if (filter != NULL)
             {
+              filter->common.entryno = entryno;
               ipfilter_cfg_add(&filter->common, PF_INET, chain);
             }
           else
             {
               nwarn("WARNING: Failed to convert entry!\n");
             }
+
+          entryno++;
         }
+
+      /* Build the lookup index of the chain. */
+
+      ipfilter_cfg_compile(PF_INET, chain);
     }
 }
 #endif
@@ -411,6 +420,7 @@ static void adjust_ipv6filter(FAR const struct ip6t_replace *repl)
   FAR const uint8_t *head;
   enum ipfilter_chain_e chain;
   enum nf_inet_hooks hook;
+  uint32_t entryno;
   size_t size;
 
   for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
@@ -428,19 +438,27 @@ static void adjust_ipv6filter(FAR const struct ip6t_replace *repl)
       /* We need the underflow entry as the default of the chain. */
 
       size++;
+      entryno = 0;
 
       ip6t_entry_for_every(entry, head, size)
         {
           FAR struct ipv6_filter_entry_s *filter = convert_ipv6entry(entry);
           if (filter != NULL)
             {
+              filter->common.entryno = entryno;
               ipfilter_cfg_add(&filter->common, PF_INET6, chain);
             }
           else
             {
               nwarn("WARNING: Failed to convert entry!\n");
             }
+
+          entryno++;
         }
+
+      /* Build the lookup index of the chain. */
+
+      ipfilter_cfg_compile(PF_INET6, chain);
     }
 }
 #endif
@@ -599,3 +617,99 @@ int ip6t_filter_apply(FAR const struct ip6t_replace *repl)
   return OK;
 }
 #endif
+
+/****************************************************************************
+ * Name: ipt_filter_counters
+ *
+ * Description:
+ *   Copy the hit counters of the filter rules into the entries of the
+ *   filter table, so that they are reported to user space.
+ *
+ * Input Parameters:
+ *   repl - The filter table data saved in kernel space.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void ipt_filter_counters(FAR struct ipt_replace *repl)
+{
+  FAR struct ipfilter_entry_s *filter;
+  FAR struct ipt_entry *entry;
+  FAR uint8_t *head;
+  enum nf_inet_hooks hook;
+  uint32_t entryno;
+  size_t size;
+
+  for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
+    {
+      /* The rules of a chain are in the order of the entries of its hook,
+       * including the underflow entry, but an entry that could not be
+       * converted has no rule.  Match them by the entry number.
+       */
+
+      filter  = ipfilter_cfg_first(PF_INET, convert_chain(hook));
+      head    = (FAR uint8_t *)repl->entries + repl->hook_entry[hook];
+      size    = repl->underflow[hook] - repl->hook_entry[hook] + 1;
+      entryno = 0;
+
+      ipt_entry_for_every(entry, head, size)
+        {
+          if (filter != NULL && filter->entryno == entryno)
+            {
+              entry->counters.pcnt = filter->hits;
+              entry->counters.bcnt = filter->bytes;
+              filter = filter->flink;
+            }
+          else
+            {
+              entry->counters.pcnt = 0;
+              entry->counters.bcnt = 0;
+            }
+
+          entryno++;
+        }
+    }
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void ip6t_filter_counters(FAR struct ip6t_replace *repl)
+{
+  FAR struct ipfilter_entry_s *filter;
+  FAR struct ip6t_entry *entry;
+  FAR uint8_t *head;
+  enum nf_inet_hooks hook;
+  uint32_t entryno;
+  size_t size;
+
+  for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
+    {
+      /* The rules of a chain are in the order of the entries of its hook,
+       * including the underflow entry, but an entry that could not be
+       * converted has no rule.  Match them by the entry number.
+       */
+
+      filter  = ipfilter_cfg_first(PF_INET6, convert_chain(hook));
+      head    = (FAR uint8_t *)repl->entries + repl->hook_entry[hook];
+      size    = repl->underflow[hook] - repl->hook_entry[hook] + 1;
+      entryno = 0;
+
+      ip6t_entry_for_every(entry, head, size)
+        {
+          if (filter != NULL && filter->entryno == entryno)
+            {
+              entry->counters.pcnt = filter->hits;
+              entry->counters.bcnt = filter->bytes;
+              filter = filter->flink;
+            }
+          else
+            {
+              entry->counters.pcnt = 0;
+              entry->counters.bcnt = 0;
+            }
+
+          entryno++;
+        }
+    }
+}
+#endif
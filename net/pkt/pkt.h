@@ -30,9 +30,14 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <poll.h>
 
 #include <nuttx/net/net.h>
 
+#ifdef CONFIG_NET_PKT_MMAP
+#  include <netpacket/packet.h>
+#endif
+
 #ifdef CONFIG_NET_PKT
 
 /****************************************************************************
@@ -50,10 +55,34 @@
  * Public Type Definitions
  ****************************************************************************/
 
-/* Representation of a packet socket connection */
+/* This is a container that holds the poll-related information */
 
 struct devif_callback_s; /* Forward reference */
 
+struct pkt_poll_s
+{
+  FAR struct socket *psock;        /* Packet socket structure */
+  FAR struct net_driver_s *dev;    /* Needed to free the callback structure */
+  FAR struct pollfd *fds;          /* Needed to handle poll events */
+  FAR struct devif_callback_s *cb; /* Needed to teardown the poll */
+};
+
+#ifdef CONFIG_NET_PKT_MMAP
+/* One ring of frames shared with the application, see PACKET_RX_RING */
+
+struct pkt_ring_s
+{
+  FAR uint8_t *base;       /* The first block of the ring */
+  uint32_t block_size;     /* Bytes per block */
+  uint32_t frame_size;     /* Bytes per frame */
+  uint32_t frame_nr;       /* Number of frames, zero without a ring */
+  uint32_t block_frames;   /* Frames per block */
+  uint32_t head;           /* The next frame to be filled or sent */
+};
+#endif
+
+/* Representation of a packet socket connection */
+
 struct pkt_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -69,11 +98,33 @@ struct pkt_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
-   *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+
+  /* Counters of PACKET_STATISTICS */
+
+  uint32_t   packets;  /* Frames received */
+  uint32_t   drops;    /* Frames dropped */
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* The frame rings.  The memory of both rings is allocated together, so
+   * that one mmap() maps the RX ring followed by the TX ring.
+   */
+
+  FAR uint8_t *ringbuf;           /* Memory of the rings */
+  size_t     ringlen;             /* Size of the memory */
+  bool       mapped;              /* The rings cannot be changed */
+  bool       losing;              /* A frame was dropped, TP_STATUS_LOSING */
+  struct pkt_ring_s rxring;       /* Received frames */
+  struct pkt_ring_s txring;       /* Frames to send */
+#endif
+
+  /* The following is a list of poll structures of threads waiting for
+   * socket events.
+   */
+
+  struct pkt_poll_s pollinfo[CONFIG_NET_PKT_NPOLLWAITERS];
 };
 
 /****************************************************************************
@@ -96,8 +147,10 @@ EXTERN const struct sock_intf_s g_pkt_sockif;
  * Public Function Prototypes
  ****************************************************************************/
 
-struct net_driver_s; /* Forward reference */
-struct socket;       /* Forward reference */
+struct net_driver_s;   /* Forward reference */
+struct socket;         /* Forward reference */
+struct pollfd;         /* Forward reference */
+struct mm_map_entry_s; /* Forward reference */
 
 /****************************************************************************
  * Name: pkt_initialize()
@@ -292,6 +345,154 @@ void pkt_poll(FAR struct net_driver_s *dev, FAR struct pkt_conn_s *conn);
 ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: pkt_pollsetup
+ *
+ * Description:
+ *   Setup to monitor events on one packet socket
+ *
+ * Input Parameters:
+ *   psock - The packet socket of interest
+ *   fds   - The structure describing the events to be monitored, OR NULL if
+ *           this is a request to stop monitoring events.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds);
+
+/****************************************************************************
+ * Name: pkt_pollteardown
+ *
+ * Description:
+ *   Teardown monitoring of events on a packet socket
+ *
+ * Input Parameters:
+ *   psock - The packet socket of interest
+ *   fds   - The structure describing the events to be monitored, OR NULL if
+ *           this is a request to stop monitoring events.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
+
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Create, replace or remove (tp_block_nr == 0) the RX or the TX ring of
+ *   a packet socket, see PACKET_RX_RING and PACKET_TX_RING.
+ *
+ * Input Parameters:
+ *   conn   - The packet connection
+ *   option - PACKET_RX_RING or PACKET_TX_RING
+ *   req    - The layout of the ring
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -EBUSY is
+ *   returned once the rings have been mapped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn, int option,
+                   FAR const struct tpacket_req *req);
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Free the rings of a packet socket that is closed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the rings of a packet socket to the caller.
+ *
+ * Input Parameters:
+ *   conn - The packet connection
+ *   map  - The mapping requested
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct pkt_conn_s *conn,
+                  FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the frame in the device buffer to the next frame of the RX ring.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure containing the received frame, with
+ *          d_buf pointing to the link layer header
+ *   conn - The packet connection with an RX ring
+ *
+ * Returned Value:
+ *   OK if the frame was stored, -ENOBUFS if the application still owns the
+ *   next frame of the ring and the frame was dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_input(FAR struct net_driver_s *dev,
+                   FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send all frames of the TX ring that the application has marked with
+ *   TP_STATUS_SEND_REQUEST, in ring order.
+ *
+ * Input Parameters:
+ *   psock - The packet socket with a TX ring
+ *   dev   - The device to send on
+ *
+ * Returned Value:
+ *   The number of bytes sent on success; a negated errno value if no frame
+ *   could be sent.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock,
+                      FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Name: pkt_ring_pollevents
+ *
+ * Description:
+ *   Get the poll events that the rings of a packet socket are ready for:
+ *   POLLIN if the application owns a received frame, POLLOUT if it owns
+ *   the next frame of the TX ring or there is no TX ring.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+pollevent_t pkt_ring_pollevents(FAR struct pkt_conn_s *conn);
+#endif /* CONFIG_NET_PKT_MMAP */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -144,6 +144,23 @@ static int pkt_in(FAR struct net_driver_s *dev)
       dev->d_appdata = dev->d_buf;
       dev->d_sndlen  = 0;
 
+#ifdef CONFIG_NET_PKT_MMAP
+      /* With an RX ring the frame goes to the ring only.  The callback
+       * then just wakes up the poll waiters, a frame that did not fit is
+       * dropped and counted rather than retried.
+       */
+
+      if (conn->rxring.frame_nr > 0)
+        {
+          if (pkt_ring_input(dev, conn) >= 0)
+            {
+              pkt_callback(dev, conn, PKT_NEWDATA);
+            }
+
+          return OK;
+        }
+#endif
+
       /* Perform the application callback */
 
       flags = pkt_callback(dev, conn, PKT_NEWDATA);
@@ -166,6 +183,11 @@ static int pkt_in(FAR struct net_driver_s *dev)
               ret = -EAGAIN;
             }
         }
+
+      if (ret == OK)
+        {
+          conn->packets++;
+        }
     }
   else
     {
@@ -0,0 +1,305 @@
+/****************************************************************************
+ * net/pkt/pkt_netpoll.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT)
+
+#include <stdint.h>
+#include <poll.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_poll_eventhandler
+ *
+ * Description:
+ *   This function is called to report the events of a packet socket via
+ *   the device interface layer.
+ *
+ * Input Parameters:
+ *   dev      The structure of the network driver that caused the event
+ *   pvpriv   An instance of struct pkt_poll_s cast to void*
+ *   flags    Set of events describing why the callback was invoked
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static uint16_t pkt_poll_eventhandler(FAR struct net_driver_s *dev,
+                                      FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct pkt_poll_s *info = pvpriv;
+  pollevent_t eventset;
+
+  ninfo("flags: %04x\n", flags);
+
+  DEBUGASSERT(info == NULL || info->fds != NULL);
+
+  /* 'priv' might be null in some race conditions (?) */
+
+  if (info != NULL)
+    {
+      /* Check for data availability events. */
+
+      eventset = 0;
+      if ((flags & PKT_NEWDATA) != 0)
+        {
+          eventset |= POLLIN;
+        }
+
+      /* Check for loss of connection events. */
+
+      if ((flags & NETDEV_DOWN) != 0)
+        {
+          eventset |= (POLLHUP | POLLERR);
+        }
+
+#ifdef CONFIG_NET_PKT_MMAP
+      /* A poll is a chance that the TX ring has room again. */
+
+      else if ((flags & PKT_POLL) != 0)
+        {
+          eventset |= pkt_ring_pollevents(info->psock->s_conn) & POLLOUT;
+        }
+#endif
+
+      /* Awaken the caller of poll() is requested event occurred. */
+
+      poll_notify(&info->fds, 1, eventset);
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_pollsetup
+ *
+ * Description:
+ *   Setup to monitor events on one packet socket
+ *
+ * Input Parameters:
+ *   psock - The packet socket of interest
+ *   fds   - The structure describing the events to be monitored, OR NULL if
+ *           this is a request to stop monitoring events.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
+{
+  FAR struct pkt_conn_s *conn;
+  FAR struct pkt_poll_s *info;
+  FAR struct devif_callback_s *cb;
+  FAR struct net_driver_s *dev;
+  pollevent_t eventset = 0;
+  int ret = OK;
+
+  /* Some of the following must be atomic */
+
+  net_lock();
+
+  conn = psock->s_conn;
+
+  /* Sanity check */
+
+  if (!conn || !fds)
+    {
+      ret = -EINVAL;
+      goto errout_with_lock;
+    }
+
+  /* Events come from the device that the socket is bound to */
+
+  dev = pkt_find_device(conn);
+  if (dev == NULL)
+    {
+      ret = -ENOTCONN;
+      goto errout_with_lock;
+    }
+
+  /* Find a container to hold the poll information */
+
+  info = conn->pollinfo;
+  while (info->psock != NULL)
+    {
+      if (++info >= &conn->pollinfo[CONFIG_NET_PKT_NPOLLWAITERS])
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+    }
+
+  /* Allocate a packet callback structure */
+
+  cb = pkt_callback_alloc(dev, conn);
+  if (cb == NULL)
+    {
+      ret = -EBUSY;
+      goto errout_with_lock;
+    }
+
+  /* Initialize the poll info container */
+
+  info->psock = psock;
+  info->dev   = dev;
+  info->fds   = fds;
+  info->cb    = cb;
+
+  /* Initialize the callback structure.  Save the reference to the info
+   * structure as callback private data so that it will be available during
+   * callback processing.
+   */
+
+  cb->flags = NETDEV_DOWN;
+  cb->priv  = info;
+  cb->event = pkt_poll_eventhandler;
+
+  if ((fds->events & POLLIN) != 0)
+    {
+      cb->flags |= PKT_NEWDATA;
+    }
+
+#ifdef CONFIG_NET_PKT_MMAP
+  if ((fds->events & POLLOUT) != 0 && conn->txring.frame_nr > 0)
+    {
+      cb->flags |= PKT_POLL;
+    }
+#endif
+
+  /* Save the reference in the poll info structure as fds private as well
+   * for use during poll teardown as well.
+   */
+
+  fds->priv = info;
+
+  /* Check for read data availability now */
+
+  if (!IOB_QEMPTY(&conn->readahead))
+    {
+      /* Normal data may be read without blocking. */
+
+      eventset |= POLLRDNORM;
+    }
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* The frames of the rings are ready without a system call */
+
+  eventset |= pkt_ring_pollevents(conn);
+#else
+  /* Always report POLLWRNORM if caller request it because we don't utilize
+   * IOB buffer for sending.
+   */
+
+  eventset |= POLLWRNORM;
+#endif
+
+  /* Check if any requested events are already in effect */
+
+  poll_notify(&fds, 1, eventset);
+
+errout_with_lock:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_pollteardown
+ *
+ * Description:
+ *   Teardown monitoring of events on a packet socket
+ *
+ * Input Parameters:
+ *   psock - The packet socket of interest
+ *   fds   - The structure describing the events to be monitored, OR NULL if
+ *           this is a request to stop monitoring events.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
+{
+  FAR struct pkt_conn_s *conn;
+  FAR struct pkt_poll_s *info;
+
+  /* Some of the following must be atomic */
+
+  net_lock();
+
+  conn = psock->s_conn;
+
+  /* Sanity check */
+
+  if (!conn || !fds->priv)
+    {
+      net_unlock();
+      return -EINVAL;
+    }
+
+  /* Recover the socket descriptor poll state info from the poll structure */
+
+  info = (FAR struct pkt_poll_s *)fds->priv;
+  DEBUGASSERT(info->fds != NULL && info->cb != NULL);
+
+  /* Release the callback */
+
+  pkt_callback_free(info->dev, conn, info->cb);
+
+  /* Release the poll/select data slot */
+
+  info->fds->priv = NULL;
+
+  /* Then free the poll info container */
+
+  info->psock = NULL;
+
+  net_unlock();
+  return OK;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT */
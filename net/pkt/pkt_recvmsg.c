@@ -421,6 +421,15 @@ ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
       ret = -ENOSYS;
     }
 
+#ifdef CONFIG_NET_PKT_MMAP
+  /* The frames are delivered to the RX ring instead */
+
+  if (conn->rxring.frame_nr > 0)
+    {
+      return -EINVAL;
+    }
+#endif
+
   /* Perform the packet recvfrom() operation */
 
   /* Initialize the state structure.  This is done with the network
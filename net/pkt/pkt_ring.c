@@ -0,0 +1,705 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_MMAP)
+
+#include <sys/param.h>
+#include <sys/socket.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <net/ethernet.h>
+#include <net/if_arp.h>
+#include <netpacket/packet.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
+#include "socket/socket.h"
+#include "utils/utils.h"
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The struct sockaddr_ll of an RX frame and the data of a TX frame follow
+ * the frame header at this offset.
+ */
+
+#define PKT_RING_HDROFF   TPACKET_ALIGN(sizeof(struct tpacket2_hdr))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure holds the state of a send of the TX ring until all frames
+ * of it have been passed to the device.
+ */
+
+struct pkt_ring_send_s
+{
+  FAR struct pkt_conn_s *conn;          /* The connection with the ring */
+  FAR struct devif_callback_s *cb;      /* Reference to callback instance */
+  sem_t sem;                            /* Wakes up the waiting thread */
+  ssize_t sent;                         /* Bytes sent or a negated errno */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ETHERNET
+static const uint8_t g_pkt_ring_broadcast[ETHER_ADDR_LEN] =
+{
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_frame
+ *
+ * Description:
+ *   Get the header of frame 'index' of a ring.  Frames do not cross the
+ *   blocks of the ring.
+ *
+ ****************************************************************************/
+
+static FAR struct tpacket2_hdr *pkt_ring_frame(FAR struct pkt_ring_s *ring,
+                                               uint32_t index)
+{
+  return (FAR struct tpacket2_hdr *)
+    (ring->base + (index / ring->block_frames) * ring->block_size +
+     (index % ring->block_frames) * ring->frame_size);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_layout
+ *
+ * Description:
+ *   Check a ring layout requested by the application and get the size of
+ *   the ring.
+ *
+ ****************************************************************************/
+
+static int pkt_ring_layout(FAR const struct tpacket_req *req,
+                           FAR size_t *size)
+{
+  uint64_t total;
+
+  if (req->tp_block_nr == 0)
+    {
+      *size = 0;
+      return OK;
+    }
+
+  if (req->tp_block_size == 0 ||
+      req->tp_block_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_frame_size < TPACKET2_HDRLEN ||
+      req->tp_frame_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_frame_size > req->tp_block_size)
+    {
+      return -EINVAL;
+    }
+
+  /* Linux requires the number of frames to fill the blocks exactly */
+
+  total = (uint64_t)req->tp_block_size / req->tp_frame_size *
+          req->tp_block_nr;
+  if (req->tp_frame_nr != total)
+    {
+      return -EINVAL;
+    }
+
+  total = (uint64_t)req->tp_block_size * req->tp_block_nr;
+  if (total > SIZE_MAX / 2)
+    {
+      return -ENOMEM;
+    }
+
+  *size = total;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_init
+ *
+ * Description:
+ *   Initialize a ring at 'base' with a layout checked by pkt_ring_layout().
+ *
+ ****************************************************************************/
+
+static void pkt_ring_init(FAR struct pkt_ring_s *ring, FAR uint8_t *base,
+                          FAR const struct tpacket_req *req)
+{
+  ring->base         = base;
+  ring->block_size   = req->tp_block_size;
+  ring->frame_size   = req->tp_frame_size;
+  ring->frame_nr     = req->tp_frame_nr;
+  ring->block_frames = req->tp_block_nr > 0 ?
+                       req->tp_block_size / req->tp_frame_size : 0;
+  ring->head         = 0;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_req
+ *
+ * Description:
+ *   Get the layout of an existing ring.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_req(FAR const struct pkt_ring_s *ring,
+                         FAR struct tpacket_req *req)
+{
+  req->tp_block_size = ring->block_size;
+  req->tp_block_nr   = ring->frame_nr > 0 ?
+                       ring->frame_nr / ring->block_frames : 0;
+  req->tp_frame_size = ring->frame_size;
+  req->tp_frame_nr   = ring->frame_nr;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_sockaddr
+ *
+ * Description:
+ *   Describe the sender of a received frame.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_sockaddr(FAR struct net_driver_s *dev,
+                              FAR struct sockaddr_ll *addr)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->sll_family  = AF_PACKET;
+  addr->sll_ifindex = dev->d_ifindex;
+
+#ifdef CONFIG_NET_ETHERNET
+  if (dev->d_lltype == NET_LL_ETHERNET)
+    {
+      FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)dev->d_buf;
+
+      addr->sll_protocol = eth->type;
+      addr->sll_hatype   = ARPHRD_ETHER;
+      addr->sll_halen    = ETHER_ADDR_LEN;
+      memcpy(addr->sll_addr, eth->src, ETHER_ADDR_LEN);
+
+      if ((eth->dest[0] & 1) == 0)
+        {
+          addr->sll_pkttype =
+            memcmp(eth->dest, dev->d_mac.ether.ether_addr_octet,
+                   ETHER_ADDR_LEN) == 0 ? PACKET_HOST : PACKET_OTHERHOST;
+        }
+      else if (memcmp(eth->dest, g_pkt_ring_broadcast,
+                      ETHER_ADDR_LEN) == 0)
+        {
+          addr->sll_pkttype = PACKET_BROADCAST;
+        }
+      else
+        {
+          addr->sll_pkttype = PACKET_MULTICAST;
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: pkt_ring_send_eventhandler
+ *
+ * Description:
+ *   Pass the next frame of the TX ring to the device on each poll, until
+ *   the application owns the next frame.
+ *
+ ****************************************************************************/
+
+static uint16_t pkt_ring_send_eventhandler(FAR struct net_driver_s *dev,
+                                           FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct pkt_ring_send_s *pstate = pvpriv;
+  FAR struct pkt_ring_s *ring;
+  FAR struct tpacket2_hdr *hdr;
+  int ret;
+
+  ninfo("flags: %04x sent: %zd\n", flags, pstate->sent);
+
+  /* Wait for the next polling cycle if another connection has claimed the
+   * device buffer or it holds unprocessed incoming data.
+   */
+
+  if (dev->d_sndlen > 0 || (flags & PKT_NEWDATA) != 0)
+    {
+      return flags;
+    }
+
+  ring = &pstate->conn->txring;
+
+  for (; ; )
+    {
+      hdr = pkt_ring_frame(ring, ring->head);
+      if (hdr->tp_status != TP_STATUS_SEND_REQUEST)
+        {
+          goto end_wait;
+        }
+
+      UP_DMB();
+
+      /* Skip frames that cannot be sent */
+
+      if (hdr->tp_len == 0 ||
+          hdr->tp_len > ring->frame_size - PKT_RING_HDROFF ||
+          hdr->tp_len > NETDEV_PKTSIZE(dev))
+        {
+          nwarn("WARNING: Bad frame length %" PRIu32 "\n", hdr->tp_len);
+          hdr->tp_status = TP_STATUS_WRONG_FORMAT;
+          ring->head     = (ring->head + 1) % ring->frame_nr;
+          continue;
+        }
+
+      break;
+    }
+
+  ret = devif_send(dev, (FAR uint8_t *)hdr + PKT_RING_HDROFF, hdr->tp_len,
+                   -NET_LL_HDRLEN(dev));
+  if (ret <= 0)
+    {
+      if (pstate->sent == 0)
+        {
+          pstate->sent = ret < 0 ? ret : -ENOMEM;
+        }
+
+      goto end_wait;
+    }
+
+  dev->d_len    = dev->d_sndlen;
+  pstate->sent += hdr->tp_len;
+
+  /* Make sure no ARP request overwrites this frame.  This flag will be
+   * cleared in arp_out().
+   */
+
+  IFF_SET_NOARP(dev->d_flags);
+
+  /* The frame has been copied, give it back to the application */
+
+  UP_DMB();
+  hdr->tp_status = TP_STATUS_AVAILABLE;
+  ring->head     = (ring->head + 1) % ring->frame_nr;
+
+  /* Ask for another poll if there is more to send */
+
+  hdr = pkt_ring_frame(ring, ring->head);
+  if (hdr->tp_status == TP_STATUS_SEND_REQUEST)
+    {
+      netdev_txnotify_dev(dev);
+      return flags;
+    }
+
+end_wait:
+
+  /* Don't allow any further call backs. */
+
+  pstate->cb->flags = 0;
+  pstate->cb->priv  = NULL;
+  pstate->cb->event = NULL;
+
+  /* Wake up the waiting thread */
+
+  nxsem_post(&pstate->sem);
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Create, replace or remove (tp_block_nr == 0) the RX or the TX ring of
+ *   a packet socket, see PACKET_RX_RING and PACKET_TX_RING.
+ *
+ * Input Parameters:
+ *   conn   - The packet connection
+ *   option - PACKET_RX_RING or PACKET_TX_RING
+ *   req    - The layout of the ring
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -EBUSY is
+ *   returned once the rings have been mapped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn, int option,
+                   FAR const struct tpacket_req *req)
+{
+  struct tpacket_req rxreq;
+  struct tpacket_req txreq;
+  FAR uint8_t *ringbuf = NULL;
+  size_t rxlen;
+  size_t txlen;
+  int ret;
+
+  if (conn->mapped)
+    {
+      return -EBUSY;
+    }
+
+  /* Both rings are reallocated together, they are empty until mapped */
+
+  pkt_ring_req(&conn->rxring, &rxreq);
+  pkt_ring_req(&conn->txring, &txreq);
+
+  if (option == PACKET_RX_RING)
+    {
+      rxreq = *req;
+    }
+  else
+    {
+      txreq = *req;
+    }
+
+  ret = pkt_ring_layout(&rxreq, &rxlen);
+  if (ret < 0 || (ret = pkt_ring_layout(&txreq, &txlen)) < 0)
+    {
+      return ret;
+    }
+
+  if (rxlen + txlen > 0)
+    {
+      /* The application accesses the rings, they are in user memory */
+
+      ringbuf = kumm_memalign(TPACKET_ALIGNMENT, rxlen + txlen);
+      if (ringbuf == NULL)
+        {
+          nerr("ERROR: Failed to allocate %zu bytes of rings\n",
+               rxlen + txlen);
+          return -ENOMEM;
+        }
+
+      /* TP_STATUS_KERNEL and TP_STATUS_AVAILABLE */
+
+      memset(ringbuf, 0, rxlen + txlen);
+    }
+
+  if (conn->ringbuf != NULL)
+    {
+      kumm_free(conn->ringbuf);
+    }
+
+  conn->ringbuf = ringbuf;
+  conn->ringlen = rxlen + txlen;
+  conn->losing  = false;
+
+  pkt_ring_init(&conn->rxring, ringbuf, &rxreq);
+  pkt_ring_init(&conn->txring, ringbuf + rxlen, &txreq);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Free the rings of a packet socket that is closed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  net_lock();
+
+  if (conn->ringbuf != NULL)
+    {
+      kumm_free(conn->ringbuf);
+    }
+
+  conn->ringbuf = NULL;
+  conn->ringlen = 0;
+  conn->mapped  = false;
+  memset(&conn->rxring, 0, sizeof(conn->rxring));
+  memset(&conn->txring, 0, sizeof(conn->txring));
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the rings of a packet socket to the caller.
+ *
+ * Input Parameters:
+ *   conn - The packet connection
+ *   map  - The mapping requested
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct pkt_conn_s *conn,
+                  FAR struct mm_map_entry_s *map)
+{
+  int ret = -EINVAL;
+
+  net_lock();
+
+  /* The rings are in memory that the caller can access.  They are not
+   * unmapped, but freed when the socket is closed.
+   */
+
+  if (conn->ringbuf != NULL && map->offset >= 0 &&
+      map->offset < conn->ringlen &&
+      map->length <= conn->ringlen - map->offset)
+    {
+      map->vaddr   = conn->ringbuf + map->offset;
+      conn->mapped = true;
+      ret          = OK;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the frame in the device buffer to the next frame of the RX ring.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure containing the received frame, with
+ *          d_buf pointing to the link layer header
+ *   conn - The packet connection with an RX ring
+ *
+ * Returned Value:
+ *   OK if the frame was stored, -ENOBUFS if the application still owns the
+ *   next frame of the ring and the frame was dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_input(FAR struct net_driver_s *dev,
+                   FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket2_hdr *hdr;
+  struct timespec ts;
+  uint32_t snaplen;
+  uint16_t maclen;
+  uint16_t macoff;
+
+  hdr = pkt_ring_frame(ring, ring->head);
+  if (hdr->tp_status != TP_STATUS_KERNEL)
+    {
+      conn->drops++;
+      conn->losing = true;
+      return -ENOBUFS;
+    }
+
+  UP_DMB();
+
+  /* Align the network header like Linux does, the link layer header is in
+   * front of it.
+   */
+
+  maclen  = NET_LL_HDRLEN(dev);
+  macoff  = TPACKET_ALIGN(TPACKET2_HDRLEN + maclen) - maclen;
+  snaplen = 0;
+
+  if (ring->frame_size > macoff)
+    {
+      snaplen = MIN(dev->d_len, ring->frame_size - macoff);
+      snaplen = iob_copyout((FAR uint8_t *)hdr + macoff, dev->d_iob,
+                            snaplen, -maclen);
+    }
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr->tp_len       = dev->d_len;
+  hdr->tp_snaplen   = snaplen;
+  hdr->tp_mac       = macoff;
+  hdr->tp_net       = macoff + maclen;
+  hdr->tp_sec       = ts.tv_sec;
+  hdr->tp_nsec      = ts.tv_nsec;
+  hdr->tp_vlan_tci  = 0;
+  hdr->tp_vlan_tpid = 0;
+
+  pkt_ring_sockaddr(dev, (FAR struct sockaddr_ll *)
+                         ((FAR uint8_t *)hdr + PKT_RING_HDROFF));
+
+  /* Pass the frame to the application */
+
+  UP_DMB();
+  hdr->tp_status = TP_STATUS_USER |
+                   (conn->losing ? TP_STATUS_LOSING : 0);
+
+  conn->losing = false;
+  conn->packets++;
+  ring->head = (ring->head + 1) % ring->frame_nr;
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send all frames of the TX ring that the application has marked with
+ *   TP_STATUS_SEND_REQUEST, in ring order.
+ *
+ * Input Parameters:
+ *   psock - The packet socket with a TX ring
+ *   dev   - The device to send on
+ *
+ * Returned Value:
+ *   The number of bytes sent on success; a negated errno value if no frame
+ *   could be sent.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock,
+                      FAR struct net_driver_s *dev)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  struct pkt_ring_send_s state;
+  int ret = OK;
+
+  net_lock();
+
+  memset(&state, 0, sizeof(state));
+  nxsem_init(&state.sem, 0, 0); /* Doesn't really fail */
+  state.conn = conn;
+
+  if (pkt_ring_frame(&conn->txring, conn->txring.head)->tp_status ==
+      TP_STATUS_SEND_REQUEST)
+    {
+      /* Allocate resource to receive a callback */
+
+      state.cb = pkt_callback_alloc(dev, conn);
+      if (state.cb != NULL)
+        {
+          state.cb->flags = PKT_POLL;
+          state.cb->priv  = &state;
+          state.cb->event = pkt_ring_send_eventhandler;
+
+          /* Notify the device driver that new TX data is available. */
+
+          netdev_txnotify_dev(dev);
+
+          /* Wait until the frames have been passed to the device or an
+           * error occurred.  net_sem_wait will also terminate if a signal
+           * is received.
+           */
+
+          ret = net_sem_wait(&state.sem);
+
+          /* Make sure that no further events are processed */
+
+          pkt_callback_free(dev, conn, state.cb);
+        }
+      else
+        {
+          ret = -EBUSY;
+        }
+    }
+
+  nxsem_destroy(&state.sem);
+  net_unlock();
+
+  /* Report what was sent before a signal or an error */
+
+  return state.sent != 0 ? state.sent : ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_pollevents
+ *
+ * Description:
+ *   Get the poll events that the rings of a packet socket are ready for:
+ *   POLLIN if the application owns a received frame, POLLOUT if it owns
+ *   the next frame of the TX ring or there is no TX ring.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+pollevent_t pkt_ring_pollevents(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring;
+  pollevent_t eventset = 0;
+  uint32_t last;
+
+  /* The application consumes the RX ring in order, it owns a frame if the
+   * last one filled has not been returned yet.
+   */
+
+  ring = &conn->rxring;
+  if (ring->frame_nr > 0)
+    {
+      last = (ring->head + ring->frame_nr - 1) % ring->frame_nr;
+      if (pkt_ring_frame(ring, last)->tp_status != TP_STATUS_KERNEL)
+        {
+          eventset |= POLLIN;
+        }
+    }
+
+  ring = &conn->txring;
+  if (ring->frame_nr == 0 ||
+      pkt_ring_frame(ring, ring->head)->tp_status == TP_STATUS_AVAILABLE)
+    {
+      eventset |= POLLOUT;
+    }
+
+  return eventset;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_MMAP */
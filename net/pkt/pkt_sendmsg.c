@@ -173,6 +173,24 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   struct send_s state;
   int ret = OK;
 
+#ifdef CONFIG_NET_PKT_MMAP
+  /* With a TX ring, a send transmits the frames queued in the ring and the
+   * message itself is ignored, as on Linux.
+   */
+
+  if (psock != NULL && psock->s_conn != NULL &&
+      ((FAR struct pkt_conn_s *)psock->s_conn)->txring.frame_nr > 0)
+    {
+      dev = pkt_find_device(psock->s_conn);
+      if (dev == NULL)
+        {
+          return -ENODEV;
+        }
+
+      return pkt_ring_send(psock, dev);
+    }
+#endif
+
   /* Validity check, only single iov supported */
 
   if (msg->msg_iovlen != 1)
@@ -54,7 +54,19 @@ static sockcaps_t pkt_sockcaps(FAR struct socket *psock);
 static void       pkt_addref(FAR struct socket *psock);
 static int        pkt_bind(FAR struct socket *psock,
                     FAR const struct sockaddr *addr, socklen_t addrlen);
+static int        pkt_netpoll(FAR struct socket *psock,
+                    FAR struct pollfd *fds, bool setup);
 static int        pkt_close(FAR struct socket *psock);
+#ifdef CONFIG_NET_SOCKOPTS
+static int        pkt_getsockopt(FAR struct socket *psock, int level,
+                    int option, FAR void *value, FAR socklen_t *value_len);
+static int        pkt_setsockopt(FAR struct socket *psock, int level,
+                    int option, FAR const void *value, socklen_t value_len);
+#endif
+#ifdef CONFIG_NET_PKT_MMAP
+static int        pkt_mmap(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -71,10 +83,25 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_listen */
   NULL,            /* si_connect */
   NULL,            /* si_accept */
-  NULL,            /* si_poll */
+  pkt_netpoll,     /* si_poll */
   pkt_sendmsg,     /* si_sendmsg */
   pkt_recvmsg,     /* si_recvmsg */
-  pkt_close        /* si_close */
+  pkt_close,       /* si_close */
+  NULL,            /* si_ioctl */
+  NULL,            /* si_socketpair */
+  NULL             /* si_shutdown */
+#ifdef CONFIG_NET_SOCKOPTS
+  , pkt_getsockopt /* si_getsockopt */
+  , pkt_setsockopt /* si_setsockopt */
+#endif
+#ifdef CONFIG_NET_PKT_MMAP
+#  ifdef CONFIG_NET_SENDFILE
+  , NULL           /* si_sendfile */
+#  endif
+  , NULL           /* si_recvmmsg */
+  , NULL           /* si_sendmmsg */
+  , pkt_mmap       /* si_mmap */
+#endif
 };
 
 /****************************************************************************
@@ -264,6 +291,43 @@ static int pkt_bind(FAR struct socket *psock,
     }
 }
 
+/****************************************************************************
+ * Name: pkt_netpoll
+ *
+ * Description:
+ *   The standard poll() operation redirects operations on socket descriptors
+ *   to net_poll which, indirectly, calls to function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored, OR NULL if
+ *           this is a request to stop monitoring events.
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+static int pkt_netpoll(FAR struct socket *psock, FAR struct pollfd *fds,
+                       bool setup)
+{
+  /* Check if we are setting up or tearing down the poll */
+
+  if (setup)
+    {
+      /* Perform the packet poll() setup */
+
+      return pkt_pollsetup(psock, fds);
+    }
+  else
+    {
+      /* Perform the packet poll() teardown */
+
+      return pkt_pollteardown(psock, fds);
+    }
+}
+
 /****************************************************************************
  * Name: pkt_close
  *
@@ -301,6 +365,12 @@ static int pkt_close(FAR struct socket *psock)
 
               iob_free_queue(&conn->readahead);
 
+#ifdef CONFIG_NET_PKT_MMAP
+              /* And the frame rings */
+
+              pkt_ring_free(conn);
+#endif
+
               /* Then free the connection structure */
 
               conn->crefs = 0;          /* No more references on the connection */
@@ -321,6 +391,193 @@ static int pkt_close(FAR struct socket *psock)
     }
 }
 
+#ifdef CONFIG_NET_SOCKOPTS
+/****************************************************************************
+ * Name: pkt_getsockopt
+ *
+ * Description:
+ *   pkt_getsockopt() retrieves the value for the SOL_PACKET option
+ *   specified by the 'option' argument.  If the size of the option value
+ *   is greater than 'value_len', the value stored in the object pointed to
+ *   by the 'value' argument will be silently truncated.
+ *
+ *   See <netpacket/packet.h> for the list of values for the 'option'
+ *   argument.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   level     Protocol level to set the option
+ *   option    identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ ****************************************************************************/
+
+static int pkt_getsockopt(FAR struct socket *psock, int level, int option,
+                          FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  int ret = OK;
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  net_lock();
+  switch (option)
+    {
+      case PACKET_STATISTICS:
+        {
+          struct tpacket_stats stats;
+
+          /* Like Linux, the received frames include the dropped ones and
+           * the counters are reset.
+           */
+
+          stats.tp_packets = conn->packets + conn->drops;
+          stats.tp_drops   = conn->drops;
+          conn->packets    = 0;
+          conn->drops      = 0;
+
+          if (*value_len > sizeof(stats))
+            {
+              *value_len = sizeof(stats);
+            }
+
+          memcpy(value, &stats, *value_len);
+        }
+        break;
+
+#ifdef CONFIG_NET_PKT_MMAP
+      case PACKET_VERSION:
+      case PACKET_HDRLEN:
+        if (*value_len < sizeof(int))
+          {
+            ret = -EINVAL;
+          }
+        else if (option == PACKET_VERSION)
+          {
+            *(FAR int *)value = TPACKET_V2;
+            *value_len        = sizeof(int);
+          }
+        else if (*(FAR int *)value == TPACKET_V2)
+          {
+            *(FAR int *)value = TPACKET2_HDRLEN;
+            *value_len        = sizeof(int);
+          }
+        else
+          {
+            ret = -EINVAL;
+          }
+        break;
+#endif
+
+      default:
+        nerr("ERROR: Unrecognized packet option: %d\n", option);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   pkt_setsockopt() sets the SOL_PACKET option specified by the 'option'
+ *   argument to the value pointed to by the 'value' argument.
+ *
+ *   See <netpacket/packet.h> for the list of values for the 'option'
+ *   argument.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   level     Protocol level to set the option
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ ****************************************************************************/
+
+static int pkt_setsockopt(FAR struct socket *psock, int level, int option,
+                          FAR const void *value, socklen_t value_len)
+{
+  int ret;
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  net_lock();
+  switch (option)
+    {
+#ifdef CONFIG_NET_PKT_MMAP
+      case PACKET_VERSION:
+
+        /* TPACKET_V2 is the only frame header version */
+
+        if (value_len < sizeof(int) || *(FAR const int *)value != TPACKET_V2)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            ret = OK;
+          }
+        break;
+
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        if (value_len < sizeof(struct tpacket_req))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            ret = pkt_ring_setup(psock->s_conn, option, value);
+          }
+        break;
+#endif
+
+      default:
+        nerr("ERROR: Unrecognized packet option: %d\n", option);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
+/****************************************************************************
+ * Name: pkt_mmap
+ *
+ * Description:
+ *   Map the RX ring followed by the TX ring of a packet socket, see
+ *   PACKET_RX_RING.
+ *
+ * Input Parameters:
+ *   psock - Socket structure of the socket to map
+ *   map   - The mapping requested
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_MMAP
+static int pkt_mmap(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map)
+{
+  return pkt_ring_mmap(psock->s_conn, map);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
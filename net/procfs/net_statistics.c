@@ -27,10 +27,12 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/net/netstats.h>
 
 #include "procfs/procfs.h"
@@ -68,6 +70,18 @@ static int netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_NET_ARP
+static int netprocfs_arpcache(FAR struct netprocfs_file_s *netfile);
+#endif
+#ifdef CONFIG_NET_IPv6
+static int netprocfs_ndcache(FAR struct netprocfs_file_s *netfile);
+#endif
+#ifdef CONFIG_NET_LOCK_STATS
+static int netprocfs_netlock(FAR struct netprocfs_file_s *netfile);
+#ifdef CONFIG_NET_CONN_LOCK
+static int netprocfs_connlock(FAR struct netprocfs_file_s *netfile);
+#endif
+#endif /* CONFIG_NET_LOCK_STATS */
 
 /****************************************************************************
  * Private Data
@@ -102,6 +116,21 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_NET_ARP
+  , netprocfs_arpcache
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  , netprocfs_ndcache
+#endif
+
+#ifdef CONFIG_NET_LOCK_STATS
+  , netprocfs_netlock
+#ifdef CONFIG_NET_CONN_LOCK
+  , netprocfs_connlock
+#endif
+#endif /* CONFIG_NET_LOCK_STATS */
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -449,6 +478,94 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_nbcache
+ *
+ * Description:
+ *   Format the lookup cost of one neighbor cache.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_ARP) || defined(CONFIG_NET_IPv6)
+static int netprocfs_nbcache(FAR struct netprocfs_file_s *netfile,
+                             FAR const char *name,
+                             FAR const struct nbcache_stats_s *stats)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "%-9s  %" PRIu32 " lookups %" PRIu32 " probes "
+                  "%" PRIu32 " miss %" PRIu32 " evict\n",
+                  name, stats->lookups, stats->probes, stats->misses,
+                  stats->evictions);
+}
+#endif
+
+/****************************************************************************
+ * Name: netprocfs_arpcache and netprocfs_ndcache
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP
+static int netprocfs_arpcache(FAR struct netprocfs_file_s *netfile)
+{
+  return netprocfs_nbcache(netfile, "ARP", &g_netstats.arp);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int netprocfs_ndcache(FAR struct netprocfs_file_s *netfile)
+{
+  return netprocfs_nbcache(netfile, "Neighbor", &g_netstats.nd);
+}
+#endif
+
+/****************************************************************************
+ * Name: netprocfs_lockstats
+ *
+ * Description:
+ *   Format the usage and contention of one kind of lock, the wait times in
+ *   microseconds.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+static int netprocfs_lockstats(FAR struct netprocfs_file_s *netfile,
+                               FAR const char *name,
+                               FAR const struct net_lockstats_s *stats)
+{
+  unsigned long freq = perf_getfreq();
+  uint64_t waittime = 0;
+  uint64_t maxwait = 0;
+
+  if (freq != 0)
+    {
+      waittime = stats->waittime * USEC_PER_SEC / freq;
+      maxwait  = (uint64_t)stats->maxwait * USEC_PER_SEC / freq;
+    }
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "%-9s  %" PRIu32 " taken %" PRIu32 " waited "
+                  "%" PRIu64 "us max %" PRIu64 "us\n",
+                  name, stats->acquired, stats->contended,
+                  waittime, maxwait);
+}
+
+/****************************************************************************
+ * Name: netprocfs_netlock and netprocfs_connlock
+ ****************************************************************************/
+
+static int netprocfs_netlock(FAR struct netprocfs_file_s *netfile)
+{
+  return netprocfs_lockstats(netfile, "Net lock", &g_netstats.lock.netlock);
+}
+
+#ifdef CONFIG_NET_CONN_LOCK
+static int netprocfs_connlock(FAR struct netprocfs_file_s *netfile)
+{
+  return netprocfs_lockstats(netfile, "Conn lock",
+                             &g_netstats.lock.connlock);
+}
+#endif
+#endif /* CONFIG_NET_LOCK_STATS */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -92,6 +92,7 @@ static ssize_t netprocfs_tcpstats(FAR struct netprocfs_file_s *priv,
       laddr = net_ip_binding_laddr(&conn->u, domain);
       raddr = net_ip_binding_raddr(&conn->u, domain);
 
+      conn_lock(&conn->sconn);
       len += snprintf(buffer + len, buflen - len,
                       "    %2" PRIu8
                       ": %02" PRIx8
@@ -114,6 +115,7 @@ static ssize_t netprocfs_tcpstats(FAR struct netprocfs_file_s *priv,
                       tcp_wrbuffer_inqueue_size(conn),
 #endif
                       (conn->readahead) ? conn->readahead->io_pktlen : 0);
+      conn_unlock(&conn->sconn);
 
       len += snprintf(buffer + len, buflen - len,
                       " %*s:%-6" PRIu16 " %*s:%-6" PRIu16 "\n",
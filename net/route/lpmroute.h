@@ -0,0 +1,151 @@
+/****************************************************************************
+ * net/route/lpmroute.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_LPMROUTE_H
+#define __NET_ROUTE_LPMROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPM
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_addlpm_ipv4 and net_addlpm_ipv6
+ *
+ * Description:
+ *   Add one route to the longest prefix match trie.  The function is called
+ *   by the routing table backends after the route has been added to the
+ *   routing table.  If the prefix is already in the trie, the route added
+ *   first stays in effect, like in a scan of the routing table.
+ *
+ * Input Parameters:
+ *   target   - The destination IP address on the destination network
+ *   netmask  - The mask defining the destination sub-net
+ *   router   - The IP address on one of our networks that provides the
+ *              router to the external network
+ *
+ * Returned Value:
+ *   None.  The trie is rebuilt from the routing table on the next lookup if
+ *   the route cannot be added.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_addlpm_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_addlpm_ipv6(const net_ipv6addr_t target,
+                     const net_ipv6addr_t netmask,
+                     const net_ipv6addr_t router);
+#endif
+
+/****************************************************************************
+ * Name: net_dellpm_ipv4 and net_dellpm_ipv6
+ *
+ * Description:
+ *   Remove one route from the longest prefix match trie.  The function is
+ *   called by the routing table backends after the route has been removed
+ *   from the routing table.
+ *
+ * Input Parameters:
+ *   target   - The destination IP address on the destination network
+ *   netmask  - The mask defining the destination sub-net
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_dellpm_ipv4(in_addr_t target, in_addr_t netmask);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_dellpm_ipv6(const net_ipv6addr_t target,
+                     const net_ipv6addr_t netmask);
+#endif
+
+/****************************************************************************
+ * Name: net_flushlpm_ipv4 and net_flushlpm_ipv6
+ *
+ * Description:
+ *   Discard the longest prefix match trie.  It is rebuilt from the routing
+ *   table on the next lookup.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_flushlpm_ipv4(void);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_flushlpm_ipv6(void);
+#endif
+
+/****************************************************************************
+ * Name: net_lookuplpm_ipv4 and net_lookuplpm_ipv6
+ *
+ * Description:
+ *   Find the route with the longest prefix that matches an address, see
+ *   net_ipv4_router() and net_ipv6_router().
+ *
+ * Input Parameters:
+ *   target    - An IP address on a remote network to use in the lookup.
+ *   router    - The address of router on a local network that can forward
+ *               our packets to the target.
+ *   prefixlen - Only match prefixes longer than this.
+ *
+ * Returned Value:
+ *   OK if a route was found, -ENOENT if there is none.  -EAGAIN is
+ *   returned if the trie could not be built, the caller must then scan
+ *   the routing table itself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lookuplpm_ipv4(in_addr_t target, FAR in_addr_t *router,
+                       int8_t prefixlen);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lookuplpm_ipv6(const net_ipv6addr_t target, net_ipv6addr_t router,
+                       int16_t prefixlen);
+#endif
+
+#endif /* CONFIG_ROUTE_LPM */
+#endif /* __NET_ROUTE_LPMROUTE_H */
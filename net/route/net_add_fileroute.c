@@ -37,6 +37,7 @@
 
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
@@ -88,6 +89,13 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_closeroute_ipv4(&fshandle);
 
+#ifdef CONFIG_ROUTE_LPM
+  if (nwritten >= 0)
+    {
+      net_addlpm_ipv4(target, netmask, router);
+    }
+#endif
+
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
@@ -124,6 +132,13 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   net_closeroute_ipv6(&fshandle);
 
+#ifdef CONFIG_ROUTE_LPM
+  if (nwritten >= 0)
+    {
+      net_addlpm_ipv6(target, netmask, router);
+    }
+#endif
+
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET6);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
@@ -38,6 +38,7 @@
 
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -88,6 +89,9 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_ipv4_routes);
+#ifdef CONFIG_ROUTE_LPM
+  net_addlpm_ipv4(target, netmask, router);
+#endif
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET);
@@ -125,6 +129,9 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_ipv6_routes);
+#ifdef CONFIG_ROUTE_LPM
+  net_addlpm_ipv6(target, netmask, router);
+#endif
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET6);
@@ -41,6 +41,7 @@
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
@@ -323,6 +324,14 @@ errout_with_fshandle:
 
 errout_with_lock:
   net_unlockroute_ipv4();
+
+#ifdef CONFIG_ROUTE_LPM
+  if (ret >= 0)
+    {
+      net_dellpm_ipv4(target, netmask);
+    }
+#endif
+
   return ret;
 }
 #endif
@@ -476,6 +485,14 @@ errout_with_fshandle:
 
 errout_with_lock:
   net_unlockroute_ipv6();
+
+#ifdef CONFIG_ROUTE_LPM
+  if (ret >= 0)
+    {
+      net_dellpm_ipv6(target, netmask);
+    }
+#endif
+
   return ret;
 }
 #endif
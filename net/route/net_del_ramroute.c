@@ -36,6 +36,7 @@
 
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -115,6 +116,10 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
 
       netlink_route_notify(route, RTM_DELROUTE, AF_INET);
 
+#ifdef CONFIG_ROUTE_LPM
+      net_dellpm_ipv4(route->target, route->netmask);
+#endif
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv4(route);
@@ -173,6 +178,10 @@ static int net_del_ipv6route(FAR struct net_route_ipv6_s *route,
 
       netlink_route_notify(route, RTM_DELROUTE, AF_INET6);
 
+#ifdef CONFIG_ROUTE_LPM
+      net_dellpm_ipv6(route->target, route->netmask);
+#endif
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv6(route);
@@ -0,0 +1,768 @@
+/****************************************************************************
+ * net/route/net_lpmroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/lpmroute.h"
+#include "route/route.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_ROUTE_LPM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The longest key is an IPv6 address */
+
+#define LPM_MAXWORDS          4
+
+/* Access to the data of a node: the prefix in host order, followed by the
+ * router address in network order.
+ */
+
+#define LPM_KEY(n)            ((n)->data)
+#define LPM_ROUTER(t,n)       ((FAR void *)((n)->data + (t)->nwords))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The trie is a binary trie with path compression: a node is only present
+ * for a prefix of a route, or where the prefixes of two subtrees diverge
+ * (a glue node).  There are at most two nodes per route, and a lookup
+ * visits at most one node per distinct prefix length on the path to the
+ * address.
+ */
+
+struct lpm_node_s
+{
+  FAR struct lpm_node_s *child[2]; /* Longer prefixes, by their next bit */
+  uint16_t nroutes;                /* Routes with this prefix, 0 for glue */
+  uint8_t plen;                    /* Length of the prefix in bits */
+  uint32_t data[];                 /* Prefix, then router (see LPM_KEY) */
+};
+
+struct lpm_trie_s
+{
+  FAR struct lpm_node_s *root;     /* Node with the shortest prefix */
+  uint8_t nwords;                  /* Length of an address in words */
+  bool valid;                      /* The trie mirrors the routing table */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The tries are protected by the network lock, like the in-memory routing
+ * tables.  They are built from the routing table on the first lookup.
+ */
+
+#ifdef CONFIG_NET_IPv4
+static struct lpm_trie_s g_lpm_ipv4 =
+{
+  NULL, sizeof(in_addr_t) / sizeof(uint32_t), false
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct lpm_trie_s g_lpm_ipv6 =
+{
+  NULL, sizeof(net_ipv6addr_t) / sizeof(uint32_t), false
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_bit
+ *
+ * Description:
+ *   Get bit 'i' of a key, counted from the most significant bit.
+ *
+ ****************************************************************************/
+
+static inline int lpm_bit(FAR const uint32_t *key, unsigned int i)
+{
+  return (key[i >> 5] >> (31 - (i & 31))) & 1;
+}
+
+/****************************************************************************
+ * Name: lpm_prefix
+ *
+ * Description:
+ *   Clear the bits of a key beyond the first 'plen' bits.
+ *
+ ****************************************************************************/
+
+static void lpm_prefix(FAR uint32_t *key, unsigned int plen,
+                       unsigned int nwords)
+{
+  unsigned int i = plen >> 5;
+
+  if ((plen & 31) != 0)
+    {
+      key[i] &= ~(UINT32_MAX >> (plen & 31));
+      i++;
+    }
+
+  for (; i < nwords; i++)
+    {
+      key[i] = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   Get the number of leading bits that two keys have in common, up to
+ *   'len' bits.
+ *
+ ****************************************************************************/
+
+static unsigned int lpm_common(FAR const uint32_t *a,
+                               FAR const uint32_t *b, unsigned int len)
+{
+  unsigned int n = 0;
+  uint32_t diff;
+
+  while (n < len)
+    {
+      diff = a[n >> 5] ^ b[n >> 5];
+      if (diff == 0)
+        {
+          n += 32;
+          continue;
+        }
+
+      while ((diff & 0x80000000) == 0)
+        {
+          diff <<= 1;
+          n++;
+        }
+
+      break;
+    }
+
+  return MIN(n, len);
+}
+
+/****************************************************************************
+ * Name: lpm_match
+ *
+ * Description:
+ *   Return true if the prefix of a node matches a key.
+ *
+ ****************************************************************************/
+
+static inline bool lpm_match(FAR const uint32_t *key,
+                             FAR const struct lpm_node_s *node)
+{
+  FAR const uint32_t *prefix = LPM_KEY(node);
+  unsigned int nfull = node->plen >> 5;
+  unsigned int rem = node->plen & 31;
+  unsigned int i;
+
+  for (i = 0; i < nfull; i++)
+    {
+      if (key[i] != prefix[i])
+        {
+          return false;
+        }
+    }
+
+  return rem == 0 || ((key[i] ^ prefix[i]) >> (32 - rem)) == 0;
+}
+
+/****************************************************************************
+ * Name: lpm_newnode
+ *
+ * Description:
+ *   Allocate a node for a prefix.  The node is a glue node if 'router' is
+ *   NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_newnode(FAR struct lpm_trie_s *trie,
+                                          FAR const uint32_t *key,
+                                          unsigned int plen,
+                                          FAR const void *router)
+{
+  FAR struct lpm_node_s *node;
+  size_t keysize = trie->nwords * sizeof(uint32_t);
+
+  node = kmm_malloc(sizeof(struct lpm_node_s) + 2 * keysize);
+  if (node == NULL)
+    {
+      nerr("ERROR: Failed to allocate a trie node\n");
+      return NULL;
+    }
+
+  node->child[0] = NULL;
+  node->child[1] = NULL;
+  node->plen     = plen;
+  memcpy(LPM_KEY(node), key, keysize);
+
+  if (router != NULL)
+    {
+      node->nroutes = 1;
+      memcpy(LPM_ROUTER(trie, node), router, keysize);
+    }
+  else
+    {
+      node->nroutes = 0;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: lpm_insert
+ *
+ * Description:
+ *   Add a route to the trie.  The bits of the key beyond 'plen' must be
+ *   zero.
+ *
+ ****************************************************************************/
+
+static int lpm_insert(FAR struct lpm_trie_s *trie, FAR const uint32_t *key,
+                      unsigned int plen, FAR const void *router)
+{
+  FAR struct lpm_node_s **link = &trie->root;
+  FAR struct lpm_node_s *node;
+  FAR struct lpm_node_s *leaf;
+  FAR struct lpm_node_s *glue;
+  uint32_t gkey[LPM_MAXWORDS];
+  unsigned int common;
+
+  while ((node = *link) != NULL)
+    {
+      common = lpm_common(key, LPM_KEY(node), MIN(plen, node->plen));
+      if (common == node->plen)
+        {
+          if (plen == node->plen)
+            {
+              /* The prefix is already in the trie.  As in a scan of the
+               * routing table, the route that was added first wins.
+               */
+
+              if (node->nroutes++ == 0)
+                {
+                  memcpy(LPM_ROUTER(trie, node), router,
+                         trie->nwords * sizeof(uint32_t));
+                }
+
+              return OK;
+            }
+
+          link = &node->child[lpm_bit(key, node->plen)];
+          continue;
+        }
+
+      /* The prefix diverges from the one of the node, or is shorter */
+
+      leaf = lpm_newnode(trie, key, plen, router);
+      if (leaf == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      if (common == plen)
+        {
+          /* The new prefix is a prefix of the node */
+
+          leaf->child[lpm_bit(LPM_KEY(node), plen)] = node;
+          *link = leaf;
+          return OK;
+        }
+
+      /* Both hang below a glue node at the point where they diverge */
+
+      memcpy(gkey, key, trie->nwords * sizeof(uint32_t));
+      lpm_prefix(gkey, common, trie->nwords);
+
+      glue = lpm_newnode(trie, gkey, common, NULL);
+      if (glue == NULL)
+        {
+          kmm_free(leaf);
+          return -ENOMEM;
+        }
+
+      glue->child[lpm_bit(key, common)]           = leaf;
+      glue->child[lpm_bit(LPM_KEY(node), common)] = node;
+      *link = glue;
+      return OK;
+    }
+
+  leaf = lpm_newnode(trie, key, plen, router);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *link = leaf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_compact
+ *
+ * Description:
+ *   Remove the node at 'link' if it neither holds a route nor separates
+ *   two subtrees.
+ *
+ ****************************************************************************/
+
+static void lpm_compact(FAR struct lpm_node_s **link)
+{
+  FAR struct lpm_node_s *node = *link;
+
+  if (node->nroutes > 0 ||
+      (node->child[0] != NULL && node->child[1] != NULL))
+    {
+      return;
+    }
+
+  *link = node->child[0] != NULL ? node->child[0] : node->child[1];
+  kmm_free(node);
+}
+
+/****************************************************************************
+ * Name: lpm_remove
+ *
+ * Description:
+ *   Remove one route from the trie.
+ *
+ * Returned Value:
+ *   The number of routes left with the same prefix, -ENOENT if there is no
+ *   route with the prefix.
+ *
+ ****************************************************************************/
+
+static int lpm_remove(FAR struct lpm_trie_s *trie, FAR const uint32_t *key,
+                      unsigned int plen)
+{
+  FAR struct lpm_node_s **plink = NULL;
+  FAR struct lpm_node_s **link = &trie->root;
+  FAR struct lpm_node_s *node;
+
+  while ((node = *link) != NULL)
+    {
+      if (node->plen > plen || !lpm_match(key, node))
+        {
+          return -ENOENT;
+        }
+
+      if (node->plen == plen)
+        {
+          break;
+        }
+
+      plink = link;
+      link  = &node->child[lpm_bit(key, node->plen)];
+    }
+
+  if (node == NULL || node->nroutes == 0)
+    {
+      return -ENOENT;
+    }
+
+  if (--node->nroutes > 0)
+    {
+      return node->nroutes;
+    }
+
+  /* The parent may now be a glue node with a single subtree */
+
+  lpm_compact(link);
+  if (plink != NULL)
+    {
+      lpm_compact(plink);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: lpm_lookup
+ *
+ * Description:
+ *   Find the node of the route with the longest prefix that matches a key
+ *   and is longer than 'prefixlen'.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_lookup(FAR struct lpm_trie_s *trie,
+                                         FAR const uint32_t *key,
+                                         int prefixlen)
+{
+  FAR struct lpm_node_s *node = trie->root;
+  FAR struct lpm_node_s *best = NULL;
+  unsigned int nbits = trie->nwords * 32;
+
+  while (node != NULL && lpm_match(key, node))
+    {
+      if (node->nroutes > 0)
+        {
+          best = node;
+        }
+
+      if (node->plen >= nbits)
+        {
+          break;
+        }
+
+      node = node->child[lpm_bit(key, node->plen)];
+    }
+
+  return best != NULL && best->plen > prefixlen ? best : NULL;
+}
+
+/****************************************************************************
+ * Name: lpm_flush
+ *
+ * Description:
+ *   Free all nodes of a trie and mark it for rebuild.
+ *
+ ****************************************************************************/
+
+static void lpm_flush(FAR struct lpm_trie_s *trie)
+{
+  FAR struct lpm_node_s *node = trie->root;
+  FAR struct lpm_node_s *next;
+
+  /* Rotate left subtrees to the right until the node has none, this frees
+   * the trie without recursion.
+   */
+
+  while (node != NULL)
+    {
+      next = node->child[0];
+      if (next != NULL)
+        {
+          node->child[0] = next->child[1];
+          next->child[1] = node;
+        }
+      else
+        {
+          next = node->child[1];
+          kmm_free(node);
+        }
+
+      node = next;
+    }
+
+  trie->root  = NULL;
+  trie->valid = false;
+}
+
+/****************************************************************************
+ * Name: lpm_add_ipv4 and lpm_add_ipv6
+ *
+ * Description:
+ *   Convert a route to a key and add it to the trie.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int lpm_add_ipv4(in_addr_t target, in_addr_t netmask,
+                        in_addr_t router)
+{
+  uint32_t key = NTOHL(target);
+  uint8_t plen = net_ipv4_mask2pref(netmask);
+
+  lpm_prefix(&key, plen, g_lpm_ipv4.nwords);
+  return lpm_insert(&g_lpm_ipv4, &key, plen, &router);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static void lpm_key_ipv6(const net_ipv6addr_t addr, FAR uint32_t *key)
+{
+  int i;
+
+  for (i = 0; i < LPM_MAXWORDS; i++)
+    {
+      key[i] = ((uint32_t)NTOHS(addr[2 * i]) << 16) | NTOHS(addr[2 * i + 1]);
+    }
+}
+
+static int lpm_add_ipv6(const net_ipv6addr_t target,
+                        const net_ipv6addr_t netmask,
+                        const net_ipv6addr_t router)
+{
+  uint32_t key[LPM_MAXWORDS];
+  uint8_t plen = net_ipv6_mask2pref(netmask);
+
+  lpm_key_ipv6(target, key);
+  lpm_prefix(key, plen, g_lpm_ipv6.nwords);
+  return lpm_insert(&g_lpm_ipv6, key, plen, router);
+}
+#endif
+
+/****************************************************************************
+ * Name: lpm_build_ipv4 and lpm_build_ipv6
+ *
+ * Description:
+ *   Add each route of the routing table to the trie.  These are the
+ *   handlers of net_foreachroute_ipv4() and net_foreachroute_ipv6().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int lpm_build_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
+{
+  return lpm_add_ipv4(route->target, route->netmask, route->router);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int lpm_build_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
+{
+  return lpm_add_ipv6(route->target, route->netmask, route->router);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_addlpm_ipv4 and net_addlpm_ipv6
+ *
+ * Description:
+ *   Add one route to the longest prefix match trie.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_addlpm_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
+{
+  net_lock();
+  if (g_lpm_ipv4.valid && lpm_add_ipv4(target, netmask, router) < 0)
+    {
+      lpm_flush(&g_lpm_ipv4);
+    }
+
+  net_unlock();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_addlpm_ipv6(const net_ipv6addr_t target,
+                     const net_ipv6addr_t netmask,
+                     const net_ipv6addr_t router)
+{
+  net_lock();
+  if (g_lpm_ipv6.valid && lpm_add_ipv6(target, netmask, router) < 0)
+    {
+      lpm_flush(&g_lpm_ipv6);
+    }
+
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: net_dellpm_ipv4 and net_dellpm_ipv6
+ *
+ * Description:
+ *   Remove one route from the longest prefix match trie.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_dellpm_ipv4(in_addr_t target, in_addr_t netmask)
+{
+  uint32_t key = NTOHL(target);
+  uint8_t plen = net_ipv4_mask2pref(netmask);
+
+  lpm_prefix(&key, plen, g_lpm_ipv4.nwords);
+
+  /* If other routes have the same prefix, only the routing table knows
+   * which one is in effect now.
+   */
+
+  net_lock();
+  if (g_lpm_ipv4.valid && lpm_remove(&g_lpm_ipv4, &key, plen) != 0)
+    {
+      lpm_flush(&g_lpm_ipv4);
+    }
+
+  net_unlock();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_dellpm_ipv6(const net_ipv6addr_t target,
+                     const net_ipv6addr_t netmask)
+{
+  uint32_t key[LPM_MAXWORDS];
+  uint8_t plen = net_ipv6_mask2pref(netmask);
+
+  lpm_key_ipv6(target, key);
+  lpm_prefix(key, plen, g_lpm_ipv6.nwords);
+
+  net_lock();
+  if (g_lpm_ipv6.valid && lpm_remove(&g_lpm_ipv6, key, plen) != 0)
+    {
+      lpm_flush(&g_lpm_ipv6);
+    }
+
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: net_flushlpm_ipv4 and net_flushlpm_ipv6
+ *
+ * Description:
+ *   Discard the longest prefix match trie.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_flushlpm_ipv4(void)
+{
+  net_lock();
+  lpm_flush(&g_lpm_ipv4);
+  net_unlock();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_flushlpm_ipv6(void)
+{
+  net_lock();
+  lpm_flush(&g_lpm_ipv6);
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lookuplpm_ipv4 and net_lookuplpm_ipv6
+ *
+ * Description:
+ *   Find the route with the longest prefix that matches an address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lookuplpm_ipv4(in_addr_t target, FAR in_addr_t *router,
+                       int8_t prefixlen)
+{
+  FAR struct lpm_node_s *node;
+  uint32_t key = NTOHL(target);
+  int ret;
+
+  net_lock();
+
+  if (!g_lpm_ipv4.valid)
+    {
+      ret = net_foreachroute_ipv4(lpm_build_ipv4, NULL);
+      if (ret < 0)
+        {
+          nwarn("WARNING: Failed to build the IPv4 trie: %d\n", ret);
+          lpm_flush(&g_lpm_ipv4);
+          net_unlock();
+          return -EAGAIN;
+        }
+
+      g_lpm_ipv4.valid = true;
+    }
+
+  node = lpm_lookup(&g_lpm_ipv4, &key, prefixlen);
+  if (node != NULL)
+    {
+      memcpy(router, LPM_ROUTER(&g_lpm_ipv4, node), sizeof(in_addr_t));
+      ret = OK;
+    }
+  else
+    {
+      ret = -ENOENT;
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lookuplpm_ipv6(const net_ipv6addr_t target, net_ipv6addr_t router,
+                       int16_t prefixlen)
+{
+  FAR struct lpm_node_s *node;
+  uint32_t key[LPM_MAXWORDS];
+  int ret;
+
+  lpm_key_ipv6(target, key);
+
+  net_lock();
+
+  if (!g_lpm_ipv6.valid)
+    {
+      ret = net_foreachroute_ipv6(lpm_build_ipv6, NULL);
+      if (ret < 0)
+        {
+          nwarn("WARNING: Failed to build the IPv6 trie: %d\n", ret);
+          lpm_flush(&g_lpm_ipv6);
+          net_unlock();
+          return -EAGAIN;
+        }
+
+      g_lpm_ipv6.valid = true;
+    }
+
+  node = lpm_lookup(&g_lpm_ipv6, key, prefixlen);
+  if (node != NULL)
+    {
+      memcpy(router, LPM_ROUTER(&g_lpm_ipv6, node), sizeof(net_ipv6addr_t));
+      ret = OK;
+    }
+  else
+    {
+      ret = -ENOENT;
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_LPM */
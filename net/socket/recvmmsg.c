@@ -0,0 +1,210 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives multiple messages from a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to recvmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Buffers to receive the messages
+ *   vlen      The number of messages in msgvec
+ *   flags     Receive flags
+ *   timeout   Time limit of the whole call, NULL to wait without limit
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  If nothing could
+ *   be received, a negated errno value is returned (see comments with
+ *   recvmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout)
+{
+  FAR struct msghdr *msg;
+  clock_t deadline = 0;
+  unsigned int count;
+  ssize_t ret = OK;
+
+  /* Verify that non-NULL pointers were passed */
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  for (count = 0; count < vlen; count++)
+    {
+      msg = &msgvec[count].msg_hdr;
+      if (msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL)
+        {
+          return -EINVAL;
+        }
+
+      if (msg->msg_name != NULL && msg->msg_namelen <= 0)
+        {
+          return -EINVAL;
+        }
+    }
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+
+  /* Let the address family receive the whole batch if it is able to */
+
+  if (psock->s_sockif->si_recvmmsg != NULL)
+    {
+      ret = psock->s_sockif->si_recvmmsg(psock, msgvec, vlen, flags,
+                                         timeout);
+      if (ret != -ENOSYS)
+        {
+          return ret;
+        }
+    }
+
+  /* Otherwise receive the messages one by one.  Like on Linux, the timeout
+   * is only checked after each message.
+   */
+
+  if (timeout != NULL)
+    {
+      deadline = clock_systime_ticks() + clock_time2ticks(timeout);
+    }
+
+  for (count = 0; count < vlen; )
+    {
+      ret = psock_recvmsg(psock, &msgvec[count].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count++].msg_len = ret;
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL && clock_compare(deadline, clock_systime_ticks()))
+        {
+          break;
+        }
+    }
+
+  return count > 0 ? (int)count : (int)ret;
+}
+
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   recvmmsg() receives multiple messages from a socket with a single call.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   Buffers to receive the messages
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags, MSG_WAITFORONE turns on MSG_DONTWAIT after the
+ *            first message
+ *   timeout  Time limit of the whole call, NULL to wait without limit
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received, the msg_len field
+ *   of each one is set to its number of bytes.  On error, -1 is returned,
+ *   and errno is set appropriately (see recvmsg()).
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+      file_put(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
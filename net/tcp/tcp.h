@@ -105,6 +105,7 @@
 #define TCP_WSCALE            0x01U /* Window Scale option enabled */
 #define TCP_SACK              0x02U /* Selective ACKs enabled */
 #define TCP_CLOSE_ARRANGED    0x04U /* Connection is arranged to be freed */
+#define TCP_TSTAMP            0x20U /* Timestamps option enabled */
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
 /* The TCP flags for congestion control */
@@ -114,6 +115,19 @@
 
 #endif
 
+/* Size of the Timestamps option with the two leading NOPs that align the
+ * 32-bit values, carried in every segment once the option is negotiated.
+ */
+
+#define TCP_OPT_TS_ALIGNED_LEN 12
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+#  define TCP_TSOPT_SIZE(conn) \
+     (((conn)->flags & TCP_TSTAMP) != 0 ? TCP_OPT_TS_ALIGNED_LEN : 0)
+#else
+#  define TCP_TSOPT_SIZE(conn) 0
+#endif
+
 /* The Max Range count of TCP Selective ACKs */
 
 #define TCP_SACK_RANGES_MAX   4
@@ -176,6 +190,79 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* Congestion control algorithm.  The common code implements slow start
+ * on connection start, fast retransmit and fast recovery (RFC 6582) and
+ * calls these operations where an algorithm differs.  The algorithm of a
+ * connection is selected with the TCP_CONGESTION socket option.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;   /* Name used with TCP_CONGESTION */
+
+  /* Reset the state of the algorithm on starting a new connection */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* Grow cwnd on an ACK of 'acked' new bytes outside of fast recovery */
+
+  CODE void (*on_ack)(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+  /* Set ssthresh on a loss, detected by duplicate ACKs or, if 'rto' is
+   * true, by the retransmission timer.
+   */
+
+  CODE void (*on_loss)(FAR struct tcp_conn_s *conn, bool rto);
+
+  /* Optional: new data up to sndseq_max has been sent */
+
+  CODE void (*on_send)(FAR struct tcp_conn_s *conn);
+
+  /* Optional: the rate to pace out segments, in bytes per second, or zero
+   * to send as fast as cwnd allows.
+   */
+
+  CODE uint32_t (*pacing_rate)(FAR struct tcp_conn_s *conn);
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* State of the CUBIC algorithm */
+
+struct tcp_cubic_s
+{
+  uint32_t w_max;         /* cwnd before the last reduction */
+  uint32_t origin;        /* cwnd at the plateau of the cubic function */
+  uint32_t w_est;         /* cwnd estimate of a Reno flow */
+  uint32_t k;             /* Time to reach origin (units: milliseconds) */
+  clock_t  epoch;         /* Start of the congestion avoidance epoch, only
+                           * valid if w_est is not zero */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_PACE
+/* State of the delay based, paced algorithm */
+
+struct tcp_pace_s
+{
+  uint32_t bw;            /* Filtered delivery rate (bytes per second) */
+  uint32_t full_bw;       /* bw at the last growth by 25% in startup */
+  uint32_t min_rtt;       /* Minimum RTT (units: microseconds) */
+  clock_t  min_rtt_time;  /* Time when min_rtt was measured */
+  uint32_t delivered;     /* Total number of bytes ACKed */
+  uint32_t rtt_seq;       /* Sequence number that ends the current round */
+  clock_t  rtt_time;      /* Start time of the current round */
+  uint32_t rtt_delivered; /* delivered at the start of the current round */
+  clock_t  cycle_time;    /* Start time of the current gain cycle phase */
+  uint8_t  mode;          /* Startup, drain or bandwidth probing */
+  uint8_t  cycle;         /* Phase in the gain cycle */
+  uint8_t  full_bw_cnt;   /* Rounds without growth by 25% in startup */
+  uint8_t  bw_age;        /* Rounds since bw was last raised */
+  bool     rtt_valid;     /* A round is being timed */
+};
+#endif
+#endif /* CONFIG_NET_TCP_CC_NEWRENO */
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -208,6 +295,9 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+#if CONFIG_NET_TCP_HASHSIZE > 0
+  dq_entry_t hashnode;    /* Link in the connection hash table */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -252,6 +342,24 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  FAR const struct tcp_cc_ops_s *cc_ops; /* Congestion control algorithm */
+#if defined(CONFIG_NET_TCP_CC_CUBIC) || defined(CONFIG_NET_TCP_CC_PACE)
+  union
+  {
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+    struct tcp_cubic_s cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_PACE
+    struct tcp_pace_s pace;
+#endif
+  } cc;                   /* State of the congestion control algorithm */
+#endif
+#ifdef CONFIG_NET_TCP_CC_PACE
+  clock_t  pace_time;     /* Time when pace_credit was last updated */
+  uint32_t pace_credit;   /* Bytes that may be sent without pacing */
+  struct   work_s pace_work; /* Resumes sending after a pacing delay */
+#endif
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -264,6 +372,13 @@ struct tcp_conn_s
 #endif
   uint32_t snd_wl1;
   uint32_t snd_wl2;
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  uint32_t ts_offset;     /* Random offset of our timestamp clock */
+  uint32_t ts_recent;     /* Latest timestamp received from the peer */
+  clock_t  ts_time;       /* Time when ts_recent was updated */
+  uint32_t srtt;          /* Smoothed RTT (units: 1/8 milliseconds) */
+  uint32_t rttvar;        /* RTT variation (units: 1/4 milliseconds) */
+#endif
 #if CONFIG_NET_RECV_BUFSIZE > 0
   int32_t  rcv_bufs;      /* Maximum amount of bytes queued in recv */
 #endif
@@ -343,6 +458,14 @@ struct tcp_conn_s
   FAR struct tcp_backlog_s *backlog;
 #endif
 
+#ifdef CONFIG_NET_SOCKOPTS
+  /* The member of a SO_REUSEPORT group that was selected for the SYN of a
+   * half-open connection, the connection is accepted by it.
+   */
+
+  FAR struct tcp_conn_s    *synlistener;
+#endif
+
 #ifdef CONFIG_NET_TCP_KEEPALIVE
   /* There fields manage TCP/IP keep-alive.  All times are in units of the
    * system clock tick.
@@ -455,6 +578,26 @@ extern "C"
 {
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* The congestion control algorithms, see struct tcp_cc_ops_s */
+
+extern const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_PACE
+extern const struct tcp_cc_ops_s g_tcp_cc_pace;
+#endif
+
+#if defined(CONFIG_NET_TCP_CC_DEFAULT_CUBIC)
+#  define TCP_CC_DEFAULT (&g_tcp_cc_cubic)
+#elif defined(CONFIG_NET_TCP_CC_DEFAULT_PACE)
+#  define TCP_CC_DEFAULT (&g_tcp_cc_pace)
+#else
+#  define TCP_CC_DEFAULT (&g_tcp_cc_newreno)
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -652,7 +795,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 
 int tcp_selectport(uint8_t domain,
                    FAR const union ip_addr_u *ipaddr,
-                   uint16_t portno);
+                   uint16_t portno, sockopt_t opt);
 
 /****************************************************************************
  * Name: tcp_bind
@@ -1066,6 +1209,23 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno);
 #endif
 
+/****************************************************************************
+ * Name: tcp_reuseport_select
+ *
+ * Description:
+ *   Select the listener of a SO_REUSEPORT group that handles a new flow
+ *   by the hash of the flow.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct tcp_conn_s *tcp_reuseport_select(FAR struct tcp_conn_s *listener,
+                                            uint32_t hash);
+#endif
+
 /****************************************************************************
  * Name: tcp_unlisten
  *
@@ -2308,6 +2468,229 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_rto
+ *
+ * Description:
+ *   Update the congestion control variables after a retransmission
+ *   timeout: the connection restarts in slow start with a cwnd of one
+ *   segment.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_rto(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_slow_start
+ *
+ * Description:
+ *   Grow cwnd in slow start (RFC 5681), for the algorithms that do not
+ *   have their own.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   acked  - The number of newly ACKed bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_slow_start(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name, as
+ *   done by the TCP_CONGESTION socket option.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm
+ *   len    - The length of the name
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name,
+                  size_t len);
+
+#ifdef CONFIG_NET_TCP_CC_PACE
+/****************************************************************************
+ * Name: tcp_cc_pace
+ *
+ * Description:
+ *   Limit the size of the next segment to the pacing rate of the
+ *   congestion control algorithm.  If not even one segment may be sent
+ *   now, sending is resumed later by a device poll.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   sndlen - The size of the segment to send
+ *
+ * Returned Value:
+ *   The number of bytes that may be sent now, possibly zero.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_cc_pace(FAR struct tcp_conn_s *conn, uint32_t sndlen);
+#endif
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+/****************************************************************************
+ * Name: tcp_cc_sent
+ *
+ * Description:
+ *   Inform the congestion control that a segment with new data has been
+ *   sent.  This also accounts for the bytes against the pacing budget
+ *   obtained with tcp_cc_pace().
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   sndlen - The number of bytes sent
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_sent(FAR struct tcp_conn_s *conn, uint32_t sndlen);
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+/****************************************************************************
+ * Name: tcp_ts_init
+ *
+ * Description:
+ *   Initialize the timestamp and RTT estimation variables.  The function is
+ *   called on starting a new connection.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The normal user level code is calling the connect/accept to start a new
+ *   connection.
+ *
+ ****************************************************************************/
+
+void tcp_ts_init(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_ts_option
+ *
+ * Description:
+ *   Write the Timestamps option, preceded by two NOPs, to the option area
+ *   of an outgoing segment.  The option takes TCP_OPT_TS_ALIGNED_LEN bytes.
+ *
+ * Input Parameters:
+ *   conn    - The TCP connection of interest
+ *   optdata - Where to write the option
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_ts_option(FAR struct tcp_conn_s *conn, FAR uint8_t *optdata);
+
+/****************************************************************************
+ * Name: tcp_ts_parse
+ *
+ * Description:
+ *   Find the Timestamps option in the header of an incoming segment.
+ *
+ * Input Parameters:
+ *   tcp    - The TCP header
+ *   tsval  - Location to return the TSval field
+ *   tsecr  - Location to return the TSecr field
+ *
+ * Returned Value:
+ *   true if the segment carries the option.
+ *
+ ****************************************************************************/
+
+bool tcp_ts_parse(FAR struct tcp_hdr_s *tcp, FAR uint32_t *tsval,
+                  FAR uint32_t *tsecr);
+
+/****************************************************************************
+ * Name: tcp_ts_input
+ *
+ * Description:
+ *   Process the Timestamps option of an incoming segment: reject the
+ *   segment if its timestamp is older than the latest one from the peer
+ *   (PAWS, RFC 7323 Section 5.3) and record the timestamp to echo.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   tcp    - The TCP header
+ *   tsecr  - Location to return the TSecr field, zero if the segment does
+ *            not carry the option
+ *
+ * Returned Value:
+ *   false if the segment must be dropped.  The caller should then send an
+ *   ACK.
+ *
+ * Assumptions:
+ *   The network is locked and the option has been negotiated.
+ *
+ ****************************************************************************/
+
+bool tcp_ts_input(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
+                  FAR uint32_t *tsecr);
+
+/****************************************************************************
+ * Name: tcp_ts_rtt
+ *
+ * Description:
+ *   Update the RTT estimation and the retransmission timeout with the
+ *   timestamp echoed by an ACK of new data (RFC 6298).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   tsecr  - The TSecr field of the ACK
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_ts_rtt(FAR struct tcp_conn_s *conn, uint32_t tsecr);
 #endif
 
 #ifdef __cplusplus
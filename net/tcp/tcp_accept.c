@@ -35,6 +35,8 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 
@@ -225,6 +227,14 @@ int psock_tcp_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
   conn = psock->s_conn;
 
+#ifdef CONFIG_NET_REUSEPORT_LOCALCPU
+  /* Remember the CPU of the accepting thread, SO_REUSEPORT prefers the
+   * listeners that accept on the CPU that receives the SYN.
+   */
+
+  conn->rcvcpu = this_cpu();
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   state.acpt_newconn = tcp_backlogremove(conn);
   if (state.acpt_newconn)
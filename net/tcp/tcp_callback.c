@@ -146,7 +146,9 @@ static uint16_t tcp_ofoseg_data_event(FAR struct net_driver_s *dev,
           rcvseq = TCP_SEQ_ADD(rcvseq,
                                seg->data->io_pktlen);
           net_incr32(conn->rcvseq, seg->data->io_pktlen);
+          conn_lock(&conn->sconn);
           net_iob_concat(&conn->readahead, &seg->data);
+          conn_unlock(&conn->sconn);
         }
       else if (TCP_SEQ_GT(rcvseq, seg->left))
         {
@@ -180,7 +182,9 @@ static uint16_t tcp_ofoseg_data_event(FAR struct net_driver_s *dev,
                   rcvseq = TCP_SEQ_ADD(rcvseq,
                                        seg->data->io_pktlen);
                   net_incr32(conn->rcvseq, seg->data->io_pktlen);
+                  conn_lock(&conn->sconn);
                   net_iob_concat(&conn->readahead, &seg->data);
+                  conn_unlock(&conn->sconn);
                 }
             }
         }
@@ -404,7 +408,9 @@ uint16_t tcp_datahandler(FAR struct net_driver_s *dev,
 
   /* Concat the iob to readahead */
 
+  conn_lock(&conn->sconn);
   net_iob_concat(&conn->readahead, &iob);
+  conn_unlock(&conn->sconn);
 
   /* Clear device buffer */
 
@@ -24,8 +24,18 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
 #include "tcp/tcp.h"
 
 /****************************************************************************
@@ -74,10 +84,124 @@
     } \
  } while(0)
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void newreno_on_ack(FAR struct tcp_conn_s *conn, uint32_t acked);
+static void newreno_on_loss(FAR struct tcp_conn_s *conn, bool rto);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "newreno",              /* name */
+  NULL,                   /* init */
+  newreno_on_ack,         /* on_ack */
+  newreno_on_loss,        /* on_loss */
+  NULL,                   /* on_send */
+  NULL                    /* pacing_rate */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The algorithms that may be selected with TCP_CONGESTION */
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc_algs[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+#ifdef CONFIG_NET_TCP_CC_PACE
+  &g_tcp_cc_pace,
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: newreno_on_ack
+ *
+ * Description:
+ *   Grow cwnd in slow start and in congestion avoidance (RFC 5681).
+ *
+ ****************************************************************************/
+
+static void newreno_on_ack(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t increase;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      tcp_cc_slow_start(conn, acked);
+    }
+  else
+    {
+      /* cong avoid (RFC 5681):
+       * Grow cwnd linearly by approximately maxseg per RTT using
+       * maxseg^2 / cwnd per ACK as the increment.
+       * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+       * avoid capping cwnd.
+       */
+
+      increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+      CC_CWND_INC(conn->cwnd, increase);
+      conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+      ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+    }
+}
+
+/****************************************************************************
+ * Name: newreno_on_loss
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+ *
+ ****************************************************************************/
+
+static void newreno_on_loss(FAR struct tcp_conn_s *conn, bool rto)
+{
+  conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
+#ifdef CONFIG_NET_TCP_CC_PACE
+/****************************************************************************
+ * Name: tcp_cc_pace_work
+ *
+ * Description:
+ *   The pacing delay of a connection has elapsed, poll it for more data.
+ *
+ ****************************************************************************/
+
+static void tcp_cc_pace_work(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+
+  net_lock();
+
+  /* The connection may have been freed in the meantime */
+
+  while ((conn = tcp_nextconn(conn)) != NULL)
+    {
+      if (conn == arg)
+        {
+          netdev_txnotify_dev(conn->dev);
+          break;
+        }
+    }
+
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -117,6 +241,21 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
   conn->ssthresh = 2 * TCP_IPV4_DEFAULT_MSS;
   conn->dupacks = 0;
+
+#ifdef CONFIG_NET_TCP_CC_PACE
+  conn->pace_time   = clock_systime_ticks();
+  conn->pace_credit = 0;
+#endif
+
+  if (conn->cc_ops == NULL)
+    {
+      conn->cc_ops = TCP_CC_DEFAULT;
+    }
+
+  if (conn->cc_ops->init != NULL)
+    {
+      conn->cc_ops->init(conn);
+    }
 }
 
 /****************************************************************************
@@ -140,15 +279,14 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
 void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 {
-  /* After Fast retransmitted, set ssthresh to the maximum of
-   * the unacked and the 2*SMSS, and enter to Fast Recovery.
-   * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+  /* After Fast retransmitted, let the algorithm set ssthresh and enter
+   * to Fast Recovery.
    * cwnd=ssthresh + 3*SMSS  referring to rfc5681
    */
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->cc_ops->on_loss(conn, false);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
@@ -269,34 +407,241 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
       if (conn->tcpstateflags >= TCP_ESTABLISHED)
         {
-          uint32_t increase;
+          conn->cc_ops->on_ack(conn, acked);
+        }
+    }
+}
 
-          if (conn->cwnd < conn->ssthresh)
-            {
-              /* slow start (RFC 5681):
-               * Grow cwnd exponentially by maxseg(smss) per ACK.
-               */
+/****************************************************************************
+ * Name: tcp_cc_rto
+ *
+ * Description:
+ *   Update the congestion control variables after a retransmission
+ *   timeout: the connection restarts in slow start with a cwnd of one
+ *   segment.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-              increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+void tcp_cc_rto(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              ninfo("update slow start cwnd to %u\n", conn->cwnd);
-            }
-          else
-            {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
+  conn->flags &= ~TCP_INFR;
+
+  /* update the max_cwnd */
+
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  conn->cc_ops->on_loss(conn, true);
+  conn->cwnd = conn->mss;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_slow_start
+ *
+ * Description:
+ *   Grow cwnd in slow start (RFC 5681), for the algorithms that do not
+ *   have their own.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   acked  - The number of newly ACKed bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_slow_start(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  /* slow start (RFC 5681):
+   * Grow cwnd exponentially by maxseg(smss) per ACK.
+   */
+
+  uint32_t increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
 
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+  CC_CWND_INC(conn->cwnd, increase);
+  ninfo("update slow start cwnd to %u\n", conn->cwnd);
+}
 
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
-              ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name, as
+ *   done by the TCP_CONGESTION socket option.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm
+ *   len    - The length of the name
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name,
+                  size_t len)
+{
+  FAR const struct tcp_cc_ops_s *ops;
+  int i;
+
+  len = strnlen(name, len);
+
+  for (i = 0; i < nitems(g_tcp_cc_algs); i++)
+    {
+      ops = g_tcp_cc_algs[i];
+      if (strlen(ops->name) == len && strncmp(ops->name, name, len) == 0)
+        {
+          /* The new algorithm starts from the current cwnd and ssthresh */
+
+          conn->cc_ops = ops;
+          if (ops->init != NULL)
+            {
+              ops->init(conn);
             }
+
+          return OK;
         }
     }
+
+  return -ENOENT;
+}
+
+#ifdef CONFIG_NET_TCP_CC_PACE
+/****************************************************************************
+ * Name: tcp_cc_pace
+ *
+ * Description:
+ *   Limit the size of the next segment to the pacing rate of the
+ *   congestion control algorithm.  If not even one segment may be sent
+ *   now, sending is resumed later by a device poll.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   sndlen - The size of the segment to send
+ *
+ * Returned Value:
+ *   The number of bytes that may be sent now, possibly zero.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_cc_pace(FAR struct tcp_conn_s *conn, uint32_t sndlen)
+{
+  clock_t now = clock_systime_ticks();
+  clock_t elapsed;
+  uint64_t credit;
+  uint64_t burst;
+  uint32_t rate = 0;
+  uint32_t seglen;
+
+  if (conn->cc_ops->pacing_rate != NULL)
+    {
+      rate = conn->cc_ops->pacing_rate(conn);
+    }
+
+  elapsed         = now - conn->pace_time;
+  conn->pace_time = now;
+
+  if (rate == 0)
+    {
+      return sndlen;
+    }
+
+  /* Earn credit for the time elapsed since the last update.  The credit
+   * is capped to two ticks worth of data, or two segments on slow paths,
+   * so an idle connection cannot send its whole window in one burst.
+   */
+
+  if (elapsed > TICK_PER_SEC)
+    {
+      elapsed = TICK_PER_SEC;
+    }
+
+  burst  = MAX((uint64_t)rate * TICK2USEC(2) / USEC_PER_SEC,
+               2 * conn->mss);
+  credit = conn->pace_credit +
+           (uint64_t)rate * TICK2USEC(elapsed) / USEC_PER_SEC;
+  conn->pace_credit = MIN(credit, burst);
+
+  if (conn->pace_credit >= sndlen)
+    {
+      return sndlen;
+    }
+  else if (conn->pace_credit >= conn->mss)
+    {
+      /* Send whole segments, a GSO packet is cut at multiples of mss */
+
+      return conn->pace_credit - conn->pace_credit % conn->mss;
+    }
+
+  /* Come back when there is enough credit for one segment */
+
+  if (work_available(&conn->pace_work))
+    {
+      seglen  = MIN(sndlen, conn->mss);
+      elapsed = ((uint64_t)(seglen - conn->pace_credit) * TICK_PER_SEC +
+                 rate - 1) / rate;
+
+      work_queue(LPWORK, &conn->pace_work, tcp_cc_pace_work, conn,
+                 MAX(elapsed, 1));
+    }
+
+  return 0;
+}
+#endif
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+/****************************************************************************
+ * Name: tcp_cc_sent
+ *
+ * Description:
+ *   Inform the congestion control that a segment with new data has been
+ *   sent.  This also accounts for the bytes against the pacing budget
+ *   obtained with tcp_cc_pace().
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   sndlen - The number of bytes sent
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_sent(FAR struct tcp_conn_s *conn, uint32_t sndlen)
+{
+#ifdef CONFIG_NET_TCP_CC_PACE
+  conn->pace_credit -= MIN(conn->pace_credit, sndlen);
+#endif
+
+  if (conn->cc_ops->on_send != NULL)
+    {
+      conn->cc_ops->on_send(conn);
+    }
 }
+#endif
@@ -0,0 +1,252 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* RFC 9438 constants: C = 0.4 segments / s^3, beta_cubic = 0.7 and the
+ * additive increase of the Reno-friendly region
+ * alpha_cubic = 3 * (1 - beta_cubic) / (1 + beta_cubic) = 9 / 17.
+ */
+
+#define CUBIC_BETA_NUM        7
+#define CUBIC_BETA_DEN        10
+#define CUBIC_ALPHA_NUM       9
+#define CUBIC_ALPHA_DEN       17
+
+/* K^3 in ms^3 per segment of (W_max - cwnd): 1e9 / C */
+
+#define CUBIC_K3_PER_SEG      2500000000ull
+
+/* Bound of |t - K| that keeps the cube in 64 bits (units: milliseconds) */
+
+#define CUBIC_MAX_DELTA       100000
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static void cubic_on_ack(FAR struct tcp_conn_s *conn, uint32_t acked);
+static void cubic_on_loss(FAR struct tcp_conn_s *conn, bool rto);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",                /* name */
+  cubic_init,             /* init */
+  cubic_on_ack,           /* on_ack */
+  cubic_on_loss,          /* on_loss */
+  NULL,                   /* on_send */
+  NULL                    /* pacing_rate */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_root
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_root(uint64_t a)
+{
+  uint64_t x = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      x <<= 1;
+      b = 3 * x * (x + 1) + 1;
+      if ((a >> s) >= b)
+        {
+          a -= b << s;
+          x++;
+        }
+    }
+
+  return (uint32_t)x;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->cc.cubic, 0, sizeof(conn->cc.cubic));
+}
+
+/****************************************************************************
+ * Name: cubic_on_ack
+ *
+ * Description:
+ *   Grow cwnd towards W_cubic(t) = C * (t - K)^3 + W_max, or along the
+ *   estimate of a Reno flow if that is larger (RFC 9438, Section 4.2).
+ *
+ ****************************************************************************/
+
+static void cubic_on_ack(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cc.cubic;
+  uint32_t cwnd = conn->cwnd;
+  uint64_t target;
+  int64_t delta;
+  int64_t offs;
+
+  if (cwnd < conn->ssthresh)
+    {
+      tcp_cc_slow_start(conn, acked);
+      return;
+    }
+
+  /* A window beyond the one of the peer cannot be used, growing it would
+   * only make the next reduction meaningless.
+   */
+
+  if (cwnd >= conn->snd_wnd)
+    {
+      return;
+    }
+
+  if (cubic->w_est == 0)
+    {
+      /* Start of a congestion avoidance epoch */
+
+      cubic->epoch = clock_systime_ticks();
+      cubic->w_est = cwnd;
+
+      if (cwnd < cubic->w_max)
+        {
+          cubic->k      = cubic_root((uint64_t)(cubic->w_max - cwnd) *
+                                     CUBIC_K3_PER_SEG / conn->mss);
+          cubic->origin = cubic->w_max;
+        }
+      else
+        {
+          cubic->k      = 0;
+          cubic->origin = cwnd;
+        }
+    }
+
+  /* W_cubic(t), in bytes */
+
+  delta = (int64_t)TICK2MSEC(clock_systime_ticks() - cubic->epoch) -
+          cubic->k;
+  if (delta > CUBIC_MAX_DELTA)
+    {
+      delta = CUBIC_MAX_DELTA;
+    }
+  else if (delta < -CUBIC_MAX_DELTA)
+    {
+      delta = -CUBIC_MAX_DELTA;
+    }
+
+  offs = delta * delta * delta * 2 / 5 / 1000 * conn->mss / 1000000;
+  if (offs < -(int64_t)cubic->origin)
+    {
+      target = 0;
+    }
+  else
+    {
+      target = cubic->origin + offs;
+    }
+
+  /* The Reno-friendly estimate grows alpha_cubic segments per RTT */
+
+  cubic->w_est += (uint64_t)acked * conn->mss * CUBIC_ALPHA_NUM /
+                  ((uint64_t)cwnd * CUBIC_ALPHA_DEN);
+  if (cubic->w_est > target)
+    {
+      target = cubic->w_est;
+    }
+
+  /* Approach the target by (target - cwnd) / cwnd per segment, at most
+   * by a half of cwnd per RTT.
+   */
+
+  if (target > (uint64_t)cwnd * 3 / 2)
+    {
+      target = (uint64_t)cwnd * 3 / 2;
+    }
+
+  if (target > cwnd)
+    {
+      conn->cwnd += (target - cwnd) * acked / cwnd;
+    }
+
+  ninfo("update cubic cwnd to %" PRIu32 " target %" PRIu64 "\n",
+        conn->cwnd, target);
+}
+
+/****************************************************************************
+ * Name: cubic_on_loss
+ *
+ * Description:
+ *   Reduce to beta_cubic * cwnd and remember the point of the loss, lower
+ *   than cwnd if the previous one was higher (fast convergence).
+ *
+ ****************************************************************************/
+
+static void cubic_on_loss(FAR struct tcp_conn_s *conn, bool rto)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cc.cubic;
+  uint32_t cwnd = conn->cwnd;
+
+  if (cwnd < cubic->w_max)
+    {
+      cubic->w_max = (uint64_t)cwnd * (CUBIC_BETA_DEN + CUBIC_BETA_NUM) /
+                     (2 * CUBIC_BETA_DEN);
+    }
+  else
+    {
+      cubic->w_max = cwnd;
+    }
+
+  conn->ssthresh = MAX((uint64_t)cwnd * CUBIC_BETA_NUM / CUBIC_BETA_DEN,
+                       2 * conn->mss);
+  cubic->w_est   = 0;
+}
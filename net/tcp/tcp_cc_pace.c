@@ -0,0 +1,345 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_pace.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The model: once per round trip the delivery rate over the round and the
+ * duration of the round are measured.  bw is the maximum delivery rate of
+ * the last PACE_BW_ROUNDS rounds, min_rtt the minimum round duration of
+ * the last PACE_MIN_RTT_SEC seconds.  Segments are paced out at a gain of
+ * bw and the data in flight is limited to a gain of bw * min_rtt.
+ */
+
+#define PACE_BW_ROUNDS        10
+#define PACE_MIN_RTT_SEC      10
+
+/* Gains, in units of 1/256 */
+
+#define PACE_UNIT             256
+#define PACE_HIGH_GAIN        739  /* 2 / ln(2): doubles the rate per RTT */
+#define PACE_DRAIN_GAIN       88   /* 1 / PACE_HIGH_GAIN */
+#define PACE_CWND_GAIN        512  /* Room for delayed and stretched ACKs */
+
+/* Startup ends when bw did not grow by 25% for three rounds */
+
+#define PACE_FULL_BW_NUM      5
+#define PACE_FULL_BW_DEN      4
+#define PACE_FULL_BW_ROUNDS   3
+
+#define PACE_MIN_CWND_SEGS    4
+
+/* Modes */
+
+#define PACE_STARTUP          0    /* Find the bandwidth, like slow start */
+#define PACE_DRAIN            1    /* Drain the queue built in startup */
+#define PACE_PROBE_BW         2    /* Cycle the gain to probe for more */
+
+#define PACE_CYCLE_LEN        8
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void pace_init(FAR struct tcp_conn_s *conn);
+static void pace_on_ack(FAR struct tcp_conn_s *conn, uint32_t acked);
+static void pace_on_loss(FAR struct tcp_conn_s *conn, bool rto);
+static void pace_on_send(FAR struct tcp_conn_s *conn);
+static uint32_t pace_pacing_rate(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Probe with 5/4 of bw for one min_rtt, drain the queue that this built
+ * with 3/4 for one min_rtt, then cruise at bw for six min_rtt.
+ */
+
+static const uint16_t g_pace_gain_cycle[PACE_CYCLE_LEN] =
+{
+  320, 192, 256, 256, 256, 256, 256, 256
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_pace =
+{
+  "pace",                 /* name */
+  pace_init,              /* init */
+  pace_on_ack,            /* on_ack */
+  pace_on_loss,           /* on_loss */
+  pace_on_send,           /* on_send */
+  pace_pacing_rate        /* pacing_rate */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pace_bdp
+ *
+ * Description:
+ *   Get the bandwidth-delay product of the model times 'gain', zero if
+ *   there is no model yet.
+ *
+ ****************************************************************************/
+
+static uint32_t pace_bdp(FAR struct tcp_pace_s *pace, uint32_t gain)
+{
+  uint64_t bdp;
+
+  if (pace->bw == 0 || pace->min_rtt == UINT32_MAX)
+    {
+      return 0;
+    }
+
+  bdp = (uint64_t)pace->bw * pace->min_rtt / USEC_PER_SEC;
+  bdp = bdp * gain / PACE_UNIT;
+
+  return bdp > UINT32_MAX ? UINT32_MAX : (uint32_t)bdp;
+}
+
+/****************************************************************************
+ * Name: pace_init
+ ****************************************************************************/
+
+static void pace_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_pace_s *pace = &conn->cc.pace;
+
+  memset(pace, 0, sizeof(*pace));
+  pace->min_rtt = UINT32_MAX;
+  pace->mode    = PACE_STARTUP;
+}
+
+/****************************************************************************
+ * Name: pace_round
+ *
+ * Description:
+ *   End the timed round if this ACK covers its last byte, and take a
+ *   delivery rate and an RTT sample from it.
+ *
+ * Returned Value:
+ *   true if a round has ended.
+ *
+ ****************************************************************************/
+
+static bool pace_round(FAR struct tcp_conn_s *conn, clock_t now)
+{
+  FAR struct tcp_pace_s *pace = &conn->cc.pace;
+  clock_t ticks;
+  uint32_t rtt;
+  uint32_t bw;
+
+  if (!pace->rtt_valid || TCP_SEQ_LT(conn->last_ackno, pace->rtt_seq))
+    {
+      return false;
+    }
+
+  pace->rtt_valid = false;
+
+  /* The resolution is one tick, a faster round counts as one tick */
+
+  ticks = now - pace->rtt_time;
+  rtt   = TICK2USEC(MAX(ticks, 1));
+  bw    = (uint64_t)(pace->delivered - pace->rtt_delivered) *
+          USEC_PER_SEC / rtt;
+
+  if (rtt <= pace->min_rtt ||
+      now - pace->min_rtt_time > SEC2TICK(PACE_MIN_RTT_SEC))
+    {
+      pace->min_rtt      = rtt;
+      pace->min_rtt_time = now;
+    }
+
+  if (bw >= pace->bw || ++pace->bw_age >= PACE_BW_ROUNDS)
+    {
+      pace->bw     = bw;
+      pace->bw_age = 0;
+    }
+
+  ninfo("pace round: rtt=%" PRIu32 " bw=%" PRIu32 " min_rtt=%" PRIu32
+        " max_bw=%" PRIu32 "\n", rtt, bw, pace->min_rtt, pace->bw);
+  return true;
+}
+
+/****************************************************************************
+ * Name: pace_on_ack
+ ****************************************************************************/
+
+static void pace_on_ack(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_pace_s *pace = &conn->cc.pace;
+  clock_t now = clock_systime_ticks();
+  uint32_t target;
+
+  pace->delivered += acked;
+
+  if (pace_round(conn, now) && pace->mode == PACE_STARTUP)
+    {
+      if ((uint64_t)pace->bw * PACE_FULL_BW_DEN >=
+          (uint64_t)pace->full_bw * PACE_FULL_BW_NUM)
+        {
+          pace->full_bw     = pace->bw;
+          pace->full_bw_cnt = 0;
+        }
+      else if (++pace->full_bw_cnt >= PACE_FULL_BW_ROUNDS)
+        {
+          pace->mode = PACE_DRAIN;
+        }
+    }
+
+  if (pace->mode == PACE_DRAIN &&
+      conn->tx_unacked <= pace_bdp(pace, PACE_UNIT))
+    {
+      pace->mode       = PACE_PROBE_BW;
+      pace->cycle      = 0;
+      pace->cycle_time = now;
+    }
+  else if (pace->mode == PACE_PROBE_BW &&
+           now - pace->cycle_time >= USEC2TICK(pace->min_rtt))
+    {
+      pace->cycle      = (pace->cycle + 1) % PACE_CYCLE_LEN;
+      pace->cycle_time = now;
+    }
+
+  /* Without a model yet, grow like slow start */
+
+  target = pace_bdp(pace, pace->mode == PACE_STARTUP ?
+                          PACE_HIGH_GAIN : PACE_CWND_GAIN);
+  if (target == 0)
+    {
+      tcp_cc_slow_start(conn, acked);
+      return;
+    }
+
+  target = MAX(target, PACE_MIN_CWND_SEGS * conn->mss);
+
+  /* Grow by the ACKed bytes, also after a loss, and hold at the target
+   * once the bandwidth has been found.
+   */
+
+  if (conn->cwnd + acked > conn->cwnd)
+    {
+      conn->cwnd += acked;
+    }
+
+  if (pace->mode != PACE_STARTUP && conn->cwnd > target)
+    {
+      conn->cwnd = target;
+    }
+}
+
+/****************************************************************************
+ * Name: pace_on_loss
+ *
+ * Description:
+ *   A loss says little about the bandwidth of the path, keep the data in
+ *   flight at the size of the model.
+ *
+ ****************************************************************************/
+
+static void pace_on_loss(FAR struct tcp_conn_s *conn, bool rto)
+{
+  FAR struct tcp_pace_s *pace = &conn->cc.pace;
+  uint32_t bdp = pace_bdp(pace, PACE_CWND_GAIN);
+
+  if (bdp == 0)
+    {
+      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+    }
+  else
+    {
+      conn->ssthresh = MAX(bdp, PACE_MIN_CWND_SEGS * conn->mss);
+    }
+
+  /* A retransmission would make the timed round too long */
+
+  pace->rtt_valid = false;
+}
+
+/****************************************************************************
+ * Name: pace_on_send
+ *
+ * Description:
+ *   Start timing a round with the segment just sent if no round is timed.
+ *
+ ****************************************************************************/
+
+static void pace_on_send(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_pace_s *pace = &conn->cc.pace;
+
+  if (!pace->rtt_valid)
+    {
+      pace->rtt_seq       = conn->sndseq_max;
+      pace->rtt_time      = clock_systime_ticks();
+      pace->rtt_delivered = pace->delivered;
+      pace->rtt_valid     = true;
+    }
+}
+
+/****************************************************************************
+ * Name: pace_pacing_rate
+ ****************************************************************************/
+
+static uint32_t pace_pacing_rate(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_pace_s *pace = &conn->cc.pace;
+  uint32_t gain;
+
+  switch (pace->mode)
+    {
+      case PACE_STARTUP:
+        gain = PACE_HIGH_GAIN;
+        break;
+
+      case PACE_DRAIN:
+        gain = PACE_DRAIN_GAIN;
+        break;
+
+      default:
+        gain = g_pace_gain_cycle[pace->cycle];
+        break;
+    }
+
+  return (uint64_t)pace->bw * gain / PACE_UNIT;
+}
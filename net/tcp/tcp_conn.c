@@ -58,6 +58,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -71,6 +72,7 @@
 #include "icmpv6/icmpv6.h"
 #include "nat/nat.h"
 #include "netdev/netdev.h"
+#include "socket/socket.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -81,6 +83,29 @@
 #  define CONFIG_NET_TCP_MAX_CONNS 0
 #endif
 
+#if CONFIG_NET_TCP_HASHSIZE > 0
+#  if (CONFIG_NET_TCP_HASHSIZE & (CONFIG_NET_TCP_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_TCP_HASHSIZE must be a power of two
+#  endif
+
+/* Map a hash key to a bucket of the connection hash table.  The bucket is
+ * taken from the top bits of the product (Fibonacci hashing), which all
+ * the bits of the key contribute to, see ARP_HASH_BUCKET().
+ */
+
+#  define TCP_HASH_BUCKET(key) \
+          ((uint32_t)(((uint64_t)(uint32_t)((key) * 2654435761u) * \
+                       CONFIG_NET_TCP_HASHSIZE) >> 32))
+#endif
+
+/* The socket options that a connection passes to tcp_selectport() */
+
+#ifdef CONFIG_NET_SOCKOPTS
+#  define TCP_SOCKOPTS(conn) ((conn)->sconn.s_options)
+#else
+#  define TCP_SOCKOPTS(conn) 0
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -95,10 +120,130 @@ NET_BUFPOOL_DECLARE(g_tcp_connections, sizeof(struct tcp_conn_s),
 
 static dq_queue_t g_active_tcp_connections;
 
+#if CONFIG_NET_TCP_HASHSIZE > 0
+/* The active connections hashed by their remote address and ports */
+
+static dq_queue_t g_tcp_hash[CONFIG_NET_TCP_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_hashkey
+ *
+ * Description:
+ *   Compute the hash key of a connection from its remote address and its
+ *   ports (in network byte order).  The key is folded in host order, so
+ *   that the host part of the address and the port numbers change its low
+ *   bits.  The local address is not part of the key, so that connections
+ *   bound to INADDR_ANY are found as well.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_HASHSIZE > 0
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_ipv4_hashkey(in_addr_t raddr, uint16_t lport,
+                                        uint16_t rport)
+{
+  return NTOHL(raddr) ^ ((uint32_t)NTOHS(lport) << 16 | NTOHS(rport));
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_hashkey(FAR const uint16_t *raddr,
+                                        uint16_t lport, uint16_t rport)
+{
+  uint32_t key = (uint32_t)NTOHS(lport) << 16 | NTOHS(rport);
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= (uint32_t)NTOHS(raddr[i]) << 16 | NTOHS(raddr[i + 1]);
+    }
+
+  return key;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_hashfirst and tcp_hashnext
+ *
+ * Description:
+ *   Traverse the active connections of one bucket of the hash table.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *tcp_hashfirst(uint32_t key)
+{
+  FAR dq_entry_t *node = dq_peek(&g_tcp_hash[TCP_HASH_BUCKET(key)]);
+
+  return node ? container_of(node, struct tcp_conn_s, hashnode) : NULL;
+}
+
+static inline FAR struct tcp_conn_s *
+tcp_hashnext(FAR struct tcp_conn_s *conn)
+{
+  FAR dq_entry_t *node = dq_next(&conn->hashnode);
+
+  return node ? container_of(node, struct tcp_conn_s, hashnode) : NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_hashbucket
+ *
+ * Description:
+ *   Get the bucket of the hash table that holds the connection.
+ *
+ ****************************************************************************/
+
+static FAR dq_queue_t *tcp_hashbucket(FAR struct tcp_conn_s *conn)
+{
+  uint32_t key;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      key = tcp_ipv6_hashkey(conn->u.ipv6.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      key = tcp_ipv4_hashkey(conn->u.ipv4.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  return &g_tcp_hash[TCP_HASH_BUCKET(key)];
+}
+#endif /* CONFIG_NET_TCP_HASHSIZE > 0 */
+
+/****************************************************************************
+ * Name: tcp_addactive
+ *
+ * Description:
+ *   Put a connection whose addresses and ports are set into the list of
+ *   active connections.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_addactive(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#if CONFIG_NET_TCP_HASHSIZE > 0
+  dq_addlast(&conn->hashnode, tcp_hashbucket(conn));
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -109,18 +254,38 @@ static dq_queue_t g_active_tcp_connections;
  *   Primary uses: (1) to determine if a port number is available, (2) to
  *   To identify the socket that will accept new connections on a local port.
  *
+ * Input Parameters:
+ *   domain - IP domain (PF_INET or PF_INET6)
+ *   ipaddr - The local IP address to use in the lookup
+ *   portno - The local port to use in the lookup
+ *   opt    - The options of the connection that wants to use the port
+ *              SO_REUSEPORT: If both connections have this, they never
+ *              conflict.
+ *
  ****************************************************************************/
 
 static FAR struct tcp_conn_s *
   tcp_listener(uint8_t domain, FAR const union ip_addr_u *ipaddr,
-               uint16_t portno)
+               uint16_t portno, sockopt_t opt)
 {
   FAR struct tcp_conn_s *conn = NULL;
+#ifdef CONFIG_NET_SOCKOPTS
+  bool skip_reusable = _SO_GETOPT(opt, SO_REUSEPORT);
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
   while ((conn = tcp_nextconn(conn)) != NULL)
     {
+#ifdef CONFIG_NET_SOCKOPTS
+      /* The connections of a SO_REUSEPORT group share the port */
+
+      if (skip_reusable && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
+#endif
+
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -195,9 +360,14 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+#if CONFIG_NET_TCP_HASHSIZE > 0
+  conn       = tcp_hashfirst(tcp_ipv4_hashkey(srcipaddr, tcp->destport,
+                                              tcp->srcport));
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -234,7 +404,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#if CONFIG_NET_TCP_HASHSIZE > 0
+      conn = tcp_hashnext(conn);
+#else
       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -262,9 +436,14 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+#if CONFIG_NET_TCP_HASHSIZE > 0
+  conn       = tcp_hashfirst(tcp_ipv6_hashkey(*srcipaddr, tcp->destport,
+                                              tcp->srcport));
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -301,7 +480,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#if CONFIG_NET_TCP_HASHSIZE > 0
+      conn = tcp_hashnext(conn);
+#else
       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -368,7 +551,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   port = tcp_selectport(PF_INET,
                        (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
-                       addr->sin_port);
+                       addr->sin_port, TCP_SOCKOPTS(conn));
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -468,7 +651,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   port = tcp_selectport(PF_INET6,
                 (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
-                addr->sin6_port);
+                addr->sin6_port, TCP_SOCKOPTS(conn));
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -516,8 +699,12 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
  *   been created with this port number.
  *
  * Input Parameters:
+ *   domain -- IP domain (PF_INET or PF_INET6)
+ *   ipaddr -- the local IP address of the connection
  *   portno -- the selected port number in network order. Zero means no port
  *     selected.
+ *   opt    -- the socket options of the connection.  A non-zero port may be
+ *     shared with other SO_REUSEPORT connections if SO_REUSEPORT is set.
  *
  * Returned Value:
  *   Selected or verified port number in network order on success, a negated
@@ -535,7 +722,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
 int tcp_selectport(uint8_t domain,
                    FAR const union ip_addr_u *ipaddr,
-                   uint16_t portno)
+                   uint16_t portno, sockopt_t opt)
 {
   static uint16_t g_last_tcp_port;
 
@@ -568,7 +755,7 @@ int tcp_selectport(uint8_t domain,
               return -EADDRINUSE;
             }
         }
-      while (tcp_listener(domain, ipaddr, portno)
+      while (tcp_listener(domain, ipaddr, portno, 0)
 #ifdef CONFIG_NET_NAT
              || nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno)
 #endif
@@ -580,7 +767,7 @@ int tcp_selectport(uint8_t domain,
        * connection is using this local port.
        */
 
-      if (tcp_listener(domain, ipaddr, portno)
+      if (tcp_listener(domain, ipaddr, portno, opt)
 #ifdef CONFIG_NET_NAT
           || nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno)
 #endif
@@ -724,11 +911,17 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       conn->domain        = domain;
 #endif
+#ifdef CONFIG_NETDEV_RSS
+      conn->rcvcpu        = -1;
+#endif
 #ifdef CONFIG_NET_TCP_KEEPALIVE
       conn->keepidle      = 2 * DSEC_PER_HOUR;
       conn->keepintvl     = 2 * DSEC_PER_SEC;
       conn->keepcnt       = 3;
 #endif
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc_ops        = TCP_CC_DEFAULT;
+#endif
 #if CONFIG_NET_RECV_BUFSIZE > 0
       conn->rcv_bufs      = CONFIG_NET_RECV_BUFSIZE;
 #endif
@@ -738,6 +931,8 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
       nxsem_init(&conn->snd_sem, 0, 0);
 #endif
 
+      conn_lock_init(&conn->sconn);
+
       /* Set the default value of mss to max, this field will changed when
        * receive SYN.
        */
@@ -776,8 +971,10 @@ void tcp_free_rx_buffers(FAR struct tcp_conn_s *conn)
 {
   /* Release any read-ahead buffers attached to the connection */
 
+  conn_lock(&conn->sconn);
   iob_free_chain(conn->readahead);
   conn->readahead = NULL;
+  conn_unlock(&conn->sconn);
 
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
   /* Release any out-of-order buffers */
@@ -860,6 +1057,9 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#if CONFIG_NET_TCP_HASHSIZE > 0
+      dq_rem(&conn->hashnode, tcp_hashbucket(conn));
+#endif
     }
 
   tcp_free_rx_buffers(conn);
@@ -1095,6 +1295,14 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #  ifdef CONFIG_NET_BINDTODEVICE
       conn->sconn.s_boundto  = listener->sconn.s_boundto;
 #  endif
+
+      /* The accepted connection belongs to the SO_REUSEPORT group of the
+       * listener, so that it does not keep other members of the group
+       * from binding the port.
+       */
+
+      conn->sconn.s_options |= listener->sconn.s_options & _SO_REUSEPORT;
+      conn->synlistener      = listener;
 #endif
 
       conn->sconn.s_tos      = listener->sconn.s_tos;
@@ -1106,6 +1314,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->snd_bufs         = listener->snd_bufs;
 #endif
       conn->mss              = listener->mss;
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc_ops           = listener->cc_ops;
+#endif
 
       /* Fill in the necessary fields for the new connection. */
 
@@ -1136,6 +1347,12 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       tcp_cc_init(conn);
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      /* Initialize the timestamp clock and the RTT estimation */
+
+      tcp_ts_init(conn);
+#endif
+
       /* rcvseq should be the seqno from the incoming packet + 1. */
 
       memcpy(conn->rcvseq, tcp->seqno, 4);
@@ -1156,7 +1373,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_addactive(conn);
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1273,7 +1490,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
           port = tcp_selectport(PF_INET,
                                 (FAR const union ip_addr_u *)
-                                &conn->u.ipv4.laddr, 0);
+                                &conn->u.ipv4.laddr, 0, 0);
         }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -1288,7 +1505,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
           port = tcp_selectport(PF_INET6,
                                 (FAR const union ip_addr_u *)
-                                conn->u.ipv6.laddr, 0);
+                                conn->u.ipv6.laddr, 0, 0);
         }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -1454,6 +1671,12 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   tcp_cc_init(conn);
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* Initialize the timestamp clock and the RTT estimation. */
+
+  tcp_ts_init(conn);
+#endif
+
   /* Initialize the list of TCP read-ahead buffers */
 
   conn->readahead = NULL;
@@ -1467,7 +1690,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_addactive(conn);
   ret = OK;
 
 errout_with_lock:
@@ -615,6 +615,15 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
         {
           conn->flags    |= TCP_SACK;
         }
+#endif
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      else if (opt == TCP_OPT_TS &&
+               IPDATA(tcpiplen + 1 + i) == TCP_OPT_TS_LEN)
+        {
+          conn->ts_recent = tcp_getsequence(&IPDATA(tcpiplen + 2 + i));
+          conn->ts_time   = clock_systime_ticks();
+          conn->flags    |= TCP_TSTAMP;
+        }
 #endif
       else
         {
@@ -634,6 +643,15 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
 
       i += IPDATA(tcpiplen + 1 + i);
     }
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* The option takes room from the payload of every segment */
+
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      conn->mss -= TCP_OPT_TS_ALIGNED_LEN;
+    }
+#endif
 }
 
 /****************************************************************************
@@ -670,6 +688,48 @@ static void tcp_clear_zero_probe(FAR struct tcp_conn_s *conn,
     }
 }
 
+/****************************************************************************
+ * Name: tcp_input_flowhash
+ *
+ * Description:
+ *   Compute the flow hash of an incoming segment from the source address
+ *   and both ports, see tcp_conn_flowhash().
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received segment
+ *   domain - IP domain (PF_INET or PF_INET6)
+ *   tcp    - Header of TCP structure
+ *
+ * Returned Value:
+ *   The hash of the flow.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static uint32_t tcp_input_flowhash(FAR struct net_driver_s *dev,
+                                   uint8_t domain,
+                                   FAR struct tcp_hdr_s *tcp)
+{
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (domain == PF_INET6)
+#  endif
+    {
+      return net_flowhash(PF_INET6, IPv6BUF->srcipaddr, tcp->srcport,
+                          tcp->destport);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  return net_flowhash(PF_INET, IPv4BUF->srcipaddr, tcp->srcport,
+                      tcp->destport);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_input
  *
@@ -695,11 +755,13 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   FAR struct tcp_conn_s *conn = NULL;
   FAR struct tcp_hdr_s *tcp;
   union ip_binding_u uaddr;
-  unsigned int tcpiplen;
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
   int      len;
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  uint32_t tsecr = 0;
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -713,20 +775,12 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   tcp = IPBUF(iplen);
 
-  /* Get the size of the IP header and the TCP header.
-   *
-   * REVISIT:  TCP header is *not* a constant!  It can be larger if the
-   * TCP header includes options.  The constant TCP_HDRLEN should be
-   * replaced with the macro TCP_OPT_HDRLEN(n) which will calculate the
-   * correct header length in all cases.
-   */
-
-  tcpiplen = iplen + TCP_HDRLEN;
-
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-  /* Start of TCP input header processing code. */
+  /* Start of TCP input header processing code.  Skip the check if the
+   * driver has verified the checksum already.
+   */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!netdev_csum_valid(dev) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -800,6 +854,15 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
       if ((conn = tcp_findlistener(&uaddr, tmp16)) != NULL)
 #endif
         {
+#ifdef CONFIG_NET_SOCKOPTS
+          /* Spread the new flows over the listeners of a SO_REUSEPORT
+           * group, each of them has its own backlog.
+           */
+
+          conn = tcp_reuseport_select(conn,
+                                      tcp_input_flowhash(dev, domain, tcp));
+#endif
+
           if (!tcp_backlogavailable(conn))
             {
               nerr("ERROR: no free containers for TCP BACKLOG!\n");
@@ -957,6 +1020,21 @@ found:
 
   dev->d_len -= (len + iplen);
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* Drop a segment with an old timestamp, but acknowledge it so that the
+   * peer learns the current state (RFC 7323, Section 5.3).
+   */
+
+  if ((conn->flags & TCP_TSTAMP) != 0 && !tcp_ts_input(conn, tcp, &tsecr))
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.drop++;
+#endif
+      tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
+      return;
+    }
+#endif
+
 #if defined(CONFIG_NET_STATISTICS) && \
     defined(CONFIG_NET_TCP_DEBUG_DROP_RECV)
 
@@ -997,6 +1075,9 @@ found:
     {
       uint32_t unackseq;
       uint32_t ackseq;
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      uint32_t tx_unacked = conn->tx_unacked;
+#endif
       int timeout;
 
       /* The next sequence number is equal to the current sequence
@@ -1082,6 +1163,22 @@ found:
         }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      /* With timestamps, every ACK of new data gives an RTT sample, also
+       * after retransmissions, since the peer echoes the timestamp of the
+       * segment that it acknowledges.
+       */
+
+      if ((conn->flags & TCP_TSTAMP) != 0)
+        {
+          if (tsecr != 0 && conn->tx_unacked < tx_unacked)
+            {
+              tcp_ts_rtt(conn, tsecr);
+            }
+        }
+      else
+#endif
+
       /* Do RTT estimation, unless we have done retransmissions. */
 
       if (conn->nrtx == 0)
@@ -1176,7 +1273,7 @@ found:
                    * E.g. a keep-alive segment.
                    */
 
-                  tcp_send(dev, conn, TCP_ACK, tcpiplen);
+                  tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
                   return;
                 }
             }
@@ -1189,7 +1286,7 @@ found:
 #endif
               if ((conn->tcpstateflags & TCP_STATE_MASK) <= TCP_ESTABLISHED)
                 {
-                  tcp_send(dev, conn, TCP_ACK, tcpiplen);
+                  tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
                   return;
                 }
             }
@@ -1416,7 +1513,7 @@ found:
                 conn->sndseq_max    = tcp_getsequence(conn->sndseq) + 1;
 #endif
                 ninfo("TCP state: TCP_LAST_ACK\n");
-                tcp_send(dev, conn, TCP_FIN | TCP_ACK, tcpiplen);
+                tcp_send(dev, conn, TCP_FIN | TCP_ACK, tcpip_hdrsize(conn));
               }
             else
               {
@@ -1597,7 +1694,7 @@ found:
 
             net_incr32(conn->rcvseq, 1); /* ack FIN */
             tcp_callback(dev, conn, TCP_CLOSE);
-            tcp_send(dev, conn, TCP_ACK, tcpiplen);
+            tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
             return;
           }
         else if ((flags & TCP_ACKDATA) != 0 && conn->tx_unacked == 0)
@@ -1644,7 +1741,7 @@ found:
 
             net_incr32(conn->rcvseq, 1); /* ack FIN */
             tcp_callback(dev, conn, TCP_CLOSE);
-            tcp_send(dev, conn, TCP_ACK, tcpiplen);
+            tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
             return;
           }
 
@@ -1669,7 +1766,7 @@ found:
         goto drop;
 
       case TCP_TIME_WAIT:
-        tcp_send(dev, conn, TCP_ACK, tcpiplen);
+        tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
         return;
 
       case TCP_CLOSING:
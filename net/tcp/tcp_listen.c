@@ -50,12 +50,16 @@
 #include <stdbool.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
+#include <nuttx/sched.h>
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Private Data
@@ -143,10 +147,229 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: tcp_reuseport_group
+ *
+ * Description:
+ *   Return true if both connections set SO_REUSEPORT and are bound to the
+ *   same local address and port, i.e. they may listen together.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static bool tcp_reuseport_group(FAR struct tcp_conn_s *conn1,
+                                FAR struct tcp_conn_s *conn2)
+{
+  if (!_SO_GETOPT(conn1->sconn.s_options, SO_REUSEPORT) ||
+      !_SO_GETOPT(conn2->sconn.s_options, SO_REUSEPORT) ||
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      conn1->domain != conn2->domain ||
+#endif
+      conn1->lport != conn2->lport)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (conn1->domain == PF_INET6)
+#  endif
+    {
+      return net_ipv6addr_cmp(conn1->u.ipv6.laddr, conn2->u.ipv6.laddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  return net_ipv4addr_cmp(conn1->u.ipv4.laddr, conn2->u.ipv4.laddr);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_conn_flowhash
+ *
+ * Description:
+ *   Compute the flow hash of a new connection.  It is the same that
+ *   tcp_input() computes from the headers of the SYN.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_conn_flowhash(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#  endif
+    {
+      return net_flowhash(PF_INET6, conn->u.ipv6.raddr, conn->rport,
+                          conn->lport);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  return net_flowhash(PF_INET, &conn->u.ipv4.raddr, conn->rport,
+                      conn->lport);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_reuseport_oncpu
+ *
+ * Description:
+ *   Return true if the listener was last accepting on the given CPU, or if
+ *   no CPU is preferred (cpu < 0).  A listener that never accepted has no
+ *   CPU (rcvcpu is -1) and only matches when no CPU is preferred.
+ *
+ ****************************************************************************/
+
+static inline bool tcp_reuseport_oncpu(FAR struct tcp_conn_s *conn, int cpu)
+{
+#ifdef CONFIG_NET_REUSEPORT_LOCALCPU
+  return cpu < 0 || conn->rcvcpu == cpu;
+#else
+  return true;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_reuseport_accepter
+ *
+ * Description:
+ *   Get the listener that accepts a connection at the end of the three-way
+ *   handshake.  That is the member of the SO_REUSEPORT group whose backlog
+ *   was checked for the SYN, even if the group or the CPU preferences have
+ *   changed since.  Only if that member no longer listens, another member
+ *   of the group is selected.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s *
+tcp_reuseport_accepter(FAR struct tcp_conn_s *listener,
+                       FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s *synlistener = conn->synlistener;
+  int ndx;
+
+  conn->synlistener = NULL;
+  if (synlistener == NULL || synlistener == listener)
+    {
+      return listener;
+    }
+
+  /* The member may have been closed, only use it if it is still in the
+   * list of listeners.
+   */
+
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      if (tcp_listenports[ndx] == synlistener &&
+          tcp_reuseport_group(listener, synlistener))
+        {
+          return synlistener;
+        }
+    }
+
+  return tcp_reuseport_select(listener, tcp_conn_flowhash(conn));
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_reuseport_select
+ *
+ * Description:
+ *   Select the listener of a SO_REUSEPORT group that handles a new flow.
+ *   The flows are spread over the members of the group by their hash, so
+ *   that each listener has its own backlog and its own accepting thread.
+ *   With CONFIG_NET_REUSEPORT_LOCALCPU the members whose thread was last
+ *   accepting on the receiving CPU are preferred.
+ *
+ * Input Parameters:
+ *   listener - A listener of the group, as returned by tcp_findlistener()
+ *   hash     - The hash of the flow, see net_flowhash()
+ *
+ * Returned Value:
+ *   The selected listener, 'listener' itself if it does not set
+ *   SO_REUSEPORT.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct tcp_conn_s *tcp_reuseport_select(FAR struct tcp_conn_s *listener,
+                                            uint32_t hash)
+{
+  FAR struct tcp_conn_s *conn;
+  unsigned int nmembers = 0;
+  unsigned int index;
+  int cpu = -1;
+  int ndx;
+
+  if (!_SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT))
+    {
+      return listener;
+    }
+
+#ifdef CONFIG_NET_REUSEPORT_LOCALCPU
+  /* Count the members that are local to this CPU first */
+
+  cpu = this_cpu();
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      conn = tcp_listenports[ndx];
+      if (conn != NULL && tcp_reuseport_group(listener, conn) &&
+          tcp_reuseport_oncpu(conn, cpu))
+        {
+          nmembers++;
+        }
+    }
+
+  if (nmembers == 0)
+    {
+      cpu = -1;
+    }
+#endif
+
+  if (nmembers == 0)
+    {
+      for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+        {
+          conn = tcp_listenports[ndx];
+          if (conn != NULL && tcp_reuseport_group(listener, conn))
+            {
+              nmembers++;
+            }
+        }
+    }
+
+  /* A single CPU-local member still has to be looked up */
+
+  if (cpu < 0 && nmembers < 2)
+    {
+      return listener;
+    }
+
+  /* Then pick the member with the index given by the hash */
+
+  index = hash % nmembers;
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      conn = tcp_listenports[ndx];
+      if (conn != NULL && tcp_reuseport_group(listener, conn) &&
+          tcp_reuseport_oncpu(conn, cpu) && index-- == 0)
+        {
+          return conn;
+        }
+    }
+
+  return listener;
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Name: tcp_unlisten
  *
@@ -191,6 +414,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+  FAR struct tcp_conn_s *listener;
   int ndx;
   int ret;
 
@@ -200,13 +424,20 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
   net_lock();
 
-  /* First, check if there is already a socket listening on this port */
+  /* First, check if there is already a socket listening on this port.
+   * The members of a SO_REUSEPORT group may listen together.
+   */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(&conn->u, conn->lport, conn->domain))
+  listener = tcp_findlistener(&conn->u, conn->lport, conn->domain);
 #else
-  if (tcp_islistener(&conn->u, conn->lport))
+  listener = tcp_findlistener(&conn->u, conn->lport);
+#endif
+  if (listener != NULL
+#ifdef CONFIG_NET_SOCKOPTS
+      && !tcp_reuseport_group(listener, conn)
 #endif
+     )
     {
       /* Yes, then we must refuse this request */
 
@@ -294,6 +525,14 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
 #endif
   if (listener != NULL)
     {
+#ifdef CONFIG_NET_SOCKOPTS
+      /* Use the member of a SO_REUSEPORT group that tcp_input() selected
+       * for the SYN of this connection.
+       */
+
+      listener = tcp_reuseport_accepter(listener, conn);
+#endif
+
       /* Yes, there is a listener.  Is it accepting connections now? */
 
       if (listener->accept)
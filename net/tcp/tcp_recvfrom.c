@@ -32,6 +32,8 @@
 #include <debug.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/tls.h>
 #include <nuttx/net/net.h>
@@ -706,7 +708,9 @@ static ssize_t tcp_recvfrom_one(FAR struct tcp_conn_s *conn, FAR void *buf,
    * the socket has been disconnected.
    */
 
+  conn_lock(&conn->sconn);
   tcp_readahead(&state);
+  conn_unlock(&conn->sconn);
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -847,6 +851,74 @@ static ssize_t tcp_recvfrom_one(FAR struct tcp_conn_s *conn, FAR void *buf,
   return ret;
 }
 
+/****************************************************************************
+ * Name: tcp_recvfrom_fast
+ *
+ * Description:
+ *   Copy the data that is already buffered in the read-ahead buffers
+ *   without holding the network lock.  The connection lock protects the
+ *   read-ahead buffers against the input path.  The network lock is only
+ *   taken afterwards to update the receive window.
+ *
+ * Input Parameters:
+ *   conn     The TCP connection of interest
+ *   msg      Receive info and buffer for receive data
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of bytes received, 0 if no data is buffered.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CONN_LOCK
+static ssize_t tcp_recvfrom_fast(FAR struct tcp_conn_s *conn,
+                                 FAR struct msghdr *msg, int flags)
+{
+  struct tcp_recvfrom_s state;
+  ssize_t nrecv = 0;
+  int i;
+
+  for (i = 0; i < msg->msg_iovlen; i++)
+    {
+      tcp_recvfrom_initialize(conn, msg->msg_iov[i].iov_base,
+                              msg->msg_iov[i].iov_len, msg->msg_name,
+                              &msg->msg_namelen, &state, flags);
+
+      conn_lock(&conn->sconn);
+      tcp_readahead(&state);
+      conn_unlock(&conn->sconn);
+
+      tcp_recvfrom_uninitialize(&state);
+      if (state.ir_recvlen <= 0)
+        {
+          break;
+        }
+
+      nrecv += state.ir_recvlen;
+      if (state.ir_recvlen < msg->msg_iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  if (nrecv > 0)
+    {
+      /* Send the ACK timely, the same as tcp_recvfrom_one() does */
+
+      net_lock();
+      if (tcp_should_send_recvwindow(conn))
+        {
+          netdev_txnotify_dev(conn->dev);
+        }
+
+      tcp_notify_recvcpu(conn);
+      net_unlock();
+    }
+
+  return nrecv;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -880,9 +952,25 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   ssize_t                ret     = 0;
   int                    i;
 
-  net_lock();
-
   conn = psock->s_conn;
+
+#ifdef CONFIG_NET_CONN_LOCK
+  /* Try to satisfy the request from the read-ahead buffers first.  This
+   * is not possible for MSG_WAITALL, which might have to wait, nor for
+   * MSG_PEEK, which must not consume the data of one iovec for the next.
+   */
+
+  if ((flags & (MSG_WAITALL | MSG_PEEK)) == 0)
+    {
+      nrecv = tcp_recvfrom_fast(conn, msg, flags);
+      if (nrecv > 0)
+        {
+          return nrecv;
+        }
+    }
+#endif
+
+  net_lock();
   for (i = 0; i < msg->msg_iovlen; i++)
     {
       FAR void *buf = msg->msg_iov[i].iov_base;
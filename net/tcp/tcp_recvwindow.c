@@ -65,7 +65,9 @@ static uint32_t tcp_calc_rcvsize(FAR struct tcp_conn_s *conn,
   uint32_t recvsize;
   uint32_t desire;
 
+  conn_lock(&conn->sconn);
   recvsize = conn->readahead ? conn->readahead->io_pktlen : 0;
+  conn_unlock(&conn->sconn);
   if (conn->rcv_bufs > recvsize)
     {
       desire = conn->rcv_bufs - recvsize;
@@ -156,6 +158,7 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
    * (ignoring competition with other IOB consumers).
    */
 
+  conn_lock(&conn->sconn);
   if (conn->readahead != NULL)
     {
       tailroom = iob_tailroom(conn->readahead);
@@ -165,6 +168,8 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
       tailroom = 0;
     }
 
+  conn_unlock(&conn->sconn);
+
   niob_avail = iob_navail(true);
 
   /* Is there a a queue entry and IOBs available for read-ahead buffering? */
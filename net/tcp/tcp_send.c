@@ -48,6 +48,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <debug.h>
@@ -104,6 +105,31 @@ static inline FAR struct tcp_hdr_s *tcp_header(FAR struct net_driver_s *dev)
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: tcp_gso_split
+ *
+ * Description:
+ *   Check if the packet in d_iob is cut into segments by the driver or by
+ *   the upper half.  These compute the checksum of every segment, a full
+ *   checksum of the whole packet would be wasted then.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure to use in the send operation
+ *
+ * Returned Value:
+ *   true if the packet is sent as several segments.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_CHECKSUMS) && defined(CONFIG_NETDEV_GSO)
+static inline bool tcp_gso_split(FAR struct net_driver_s *dev)
+{
+  return dev->d_gsosize > 0 && dev->d_len > devif_get_mtu(dev);
+}
+#else
+#  define tcp_gso_split(dev) false
+#endif
+
 /****************************************************************************
  * Name: tcp_sendcommon
  *
@@ -200,7 +226,11 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!netdev_csum_partial(dev, IP_PROTO_TCP, &tcp->tcpchksum) &&
+          !tcp_gso_split(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -224,7 +254,11 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!netdev_csum_partial(dev, IP_PROTO_TCP, &tcp->tcpchksum) &&
+          !tcp_gso_split(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -287,6 +321,7 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
               uint16_t flags, uint16_t len)
 {
   FAR struct tcp_hdr_s *tcp;
+  int optlen = 0;
 
   if (dev->d_iob == NULL)
     {
@@ -297,39 +332,62 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->flags = flags;
   dev->d_len = len;
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* The Timestamps option is part of every segment once negotiated and is
+   * already accounted for in len, see tcpip_hdrsize().
+   */
+
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      tcp_ts_option(conn, tcp->optdata);
+      optlen = TCP_OPT_TS_ALIGNED_LEN;
+    }
+#endif
+
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
   if ((conn->flags & TCP_SACK) && (flags == TCP_ACK) && conn->nofosegs > 0)
     {
-      int optlen = conn->nofosegs * sizeof(struct tcp_sack_s);
+      FAR uint8_t *optdata = &tcp->optdata[optlen];
+      int nsacks = conn->nofosegs;
+      int sacklen;
       int i;
 
-      tcp->optdata[0] = TCP_OPT_NOOP;
-      tcp->optdata[1] = TCP_OPT_NOOP;
-      tcp->optdata[2] = TCP_OPT_SACK;
-      tcp->optdata[3] = TCP_OPT_SACK_PERM_LEN + optlen;
+      /* Report only as many blocks as fit in the option space */
+
+      i = (TCP_MAX_HDRLEN - TCP_HDRLEN - optlen - 4) /
+          (int)sizeof(struct tcp_sack_s);
+      if (nsacks > i)
+        {
+          nsacks = i;
+        }
 
-      optlen += 4;
+      sacklen = nsacks * sizeof(struct tcp_sack_s);
 
-      for (i = 0; i < conn->nofosegs; i++)
+      optdata[0] = TCP_OPT_NOOP;
+      optdata[1] = TCP_OPT_NOOP;
+      optdata[2] = TCP_OPT_SACK;
+      optdata[3] = TCP_OPT_SACK_PERM_LEN + sacklen;
+
+      sacklen += 4;
+
+      for (i = 0; i < nsacks; i++)
         {
           ninfo("TCP SACK [%d]"
                 "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n", i,
                 conn->ofosegs[i].left, conn->ofosegs[i].right,
                 TCP_SEQ_SUB(conn->ofosegs[i].right, conn->ofosegs[i].left));
-          tcp_setsequence(&tcp->optdata[4 + i * 2 * sizeof(uint32_t)],
+          tcp_setsequence(&optdata[4 + i * 2 * sizeof(uint32_t)],
                           conn->ofosegs[i].left);
-          tcp_setsequence(&tcp->optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
+          tcp_setsequence(&optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
                           conn->ofosegs[i].right);
         }
 
-      dev->d_len += optlen;
-      tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
+      dev->d_len += sacklen;
+      optlen     += sacklen;
     }
-  else
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
-    {
-      tcp->tcpoffset = (TCP_HDRLEN / 4) << 4;
-    }
+
+  tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
 
   tcp_sendcommon(dev, conn, tcp);
 
@@ -503,7 +561,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!netdev_csum_partial(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv6 */
@@ -523,7 +584,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!netdev_csum_partial(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv4 */
@@ -609,7 +673,7 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   /* Set the packet length for the TCP Maximum Segment Size */
 
-  dev->d_len = tcpip_hdrsize(conn);
+  dev->d_len = tcpip_hdrsize(conn) - TCP_TSOPT_SIZE(conn);
 
   /* Set the packet length for the TCP Maximum Segment Size */
 
@@ -657,6 +721,18 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
     }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* Offer the option in a SYN, echo it in a SYNACK if the peer offered it,
+   * and carry it in every later segment.
+   */
+
+  if (tcp->flags == TCP_SYN || (conn->flags & TCP_TSTAMP) != 0)
+    {
+      tcp_ts_option(conn, &tcp->optdata[optlen]);
+      optlen += TCP_OPT_TS_ALIGNED_LEN;
+    }
+#endif
+
   tcp->tcpoffset         = ((TCP_HDRLEN + optlen) / 4) << 4;
   dev->d_len            += optlen;
 
@@ -728,7 +804,7 @@ void tcp_send_txnotify(FAR struct socket *psock,
 
 uint16_t tcpip_hdrsize(FAR struct tcp_conn_s *conn)
 {
-  uint16_t hdrsize = sizeof(struct tcp_hdr_s);
+  uint16_t hdrsize = sizeof(struct tcp_hdr_s) + TCP_TSOPT_SIZE(conn);
 
   UNUSED(conn);
   return net_ip_domain_select(conn->domain,
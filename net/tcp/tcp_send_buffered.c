@@ -411,6 +411,33 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 }
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
+/****************************************************************************
+ * Name: tcp_maxsndlen
+ *
+ * Description:
+ *   Get the largest amount of data that may be handed to the device in a
+ *   single packet.  This is a multiple of the MSS if the device supports
+ *   generic segmentation offload and the MSS otherwise.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_maxsndlen(FAR struct net_driver_s *dev,
+                              FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NETDEV_GSO
+  uint32_t hdrlen = NET_LL_HDRLEN(dev) + tcpip_hdrsize(conn);
+  uint32_t maxlen;
+
+  if (dev->d_gsomax > hdrlen + conn->mss)
+    {
+      maxlen = dev->d_gsomax - hdrlen;
+      return maxlen - maxlen % conn->mss;
+    }
+#endif
+
+  return conn->mss;
+}
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -607,7 +634,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                        * driver to send the message and marked as rexmit
                        */
 
+#ifndef CONFIG_NET_TCP_CC_NEWRENO
                       TCP_WBNACK(wrb) = 0;
+#endif
                       conn->timeout = true;
                       netdev_txnotify_dev(conn->dev);
                       return flags;
@@ -1037,12 +1066,14 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       if (TCP_SEQ_LT(seq, snd_wnd_edge))
         {
           uint32_t remaining_snd_wnd;
+          uint32_t maxlen;
           int ret;
 
+          maxlen = tcp_maxsndlen(dev, conn);
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > maxlen)
             {
-              sndlen = conn->mss;
+              sndlen = maxlen;
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1067,6 +1098,16 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               sndlen = CONFIG_IOB_BUFSIZE;
             }
 
+#ifdef CONFIG_NET_TCP_CC_PACE
+          /* Hold the segment back if it would exceed the pacing rate */
+
+          sndlen = tcp_cc_pace(conn, sndlen);
+          if (sndlen == 0)
+            {
+              return flags;
+            }
+#endif
+
           ninfo("SEND: wrb=%p seq=%" PRIu32 " pktlen=%u sent=%u sndlen=%zu "
                 "mss=%u snd_wnd=%" PRIu32 " seq=%" PRIu32
                 " remaining_snd_wnd=%" PRIu32 "\n",
@@ -1106,10 +1147,22 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NETDEV_GSO
+          /* Let the driver cut the packet into MSS sized segments */
+
+          if (sndlen > conn->mss)
+            {
+              dev->d_gsosize = conn->mss;
+            }
+#endif
+
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                TCP_WBSENT(wrb), tcpip_hdrsize(conn));
           if (ret <= 0)
             {
+#ifdef CONFIG_NETDEV_GSO
+              dev->d_gsosize = 0;
+#endif
               return flags;
             }
 
@@ -1133,6 +1186,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                conn->sndseq_max = predicted_seqno;
             }
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+          tcp_cc_sent(conn, sndlen);
+#endif
+
           ninfo("SEND: wrb=%p nrtx=%u tx_unacked=%" PRIu32
                 " sent=%" PRIu32 "\n",
                 wrb, TCP_WBNRTX(wrb), conn->tx_unacked, conn->sent);
@@ -1201,6 +1258,15 @@ static uint32_t tcp_max_wrb_size(FAR struct tcp_conn_s *conn)
 
   size = 4 * mss;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* or enough data to fill a GSO packet */
+
+  if (size < CONFIG_NETDEV_GSO_MAXSIZE)
+    {
+      size = CONFIG_NETDEV_GSO_MAXSIZE;
+    }
+#endif
+
   /* but it should not hog too many IOB buffers */
 
   if (size > CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE / 2)
@@ -1249,6 +1315,55 @@ static unsigned int tcp_send_gettimeout(clock_t start, unsigned int timeout)
   return timeout;
 }
 
+/****************************************************************************
+ * Name: tcp_send_waitbuffer
+ *
+ * Description:
+ *   Wait until the data queued in the write buffers is below the send
+ *   buffer limit.
+ *
+ * Assumptions:
+ *   The network is locked and conn->sndcb is set up.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_SEND_BUFSIZE > 0
+static int tcp_send_waitbuffer(FAR struct tcp_conn_s *conn, bool nonblock,
+                               clock_t start, unsigned int timeout)
+{
+  int ret;
+
+  while (tcp_wrbuffer_inqueue_size(conn) >= conn->snd_bufs)
+    {
+      struct tcp_callback_s info;
+
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      /* Push a cancellation point onto the stack.  This will be
+       * called if the thread is canceled.
+       */
+
+      info.tc_conn = conn;
+      info.tc_cb   = conn->sndcb;
+      info.tc_sem  = &conn->snd_sem;
+      tls_cleanup_push(tls_get_info(), tcp_callback_cleanup, &info);
+
+      ret = net_sem_timedwait_uninterruptible(&conn->snd_sem,
+        tcp_send_gettimeout(start, timeout));
+      tls_cleanup_pop(tls_get_info(), 0);
+      if (ret < 0)
+        {
+          return ret == -ETIMEDOUT ? -EAGAIN : ret;
+        }
+    }
+
+  return OK;
+}
+#endif /* CONFIG_NET_SEND_BUFSIZE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1429,37 +1544,10 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
        * wait for the write buffer to be released
        */
 
-      while (tcp_wrbuffer_inqueue_size(conn) >= conn->snd_bufs)
+      ret = tcp_send_waitbuffer(conn, nonblock, start, timeout);
+      if (ret < 0)
         {
-          struct tcp_callback_s info;
-
-          if (nonblock)
-            {
-              ret = -EAGAIN;
-              goto errout_with_lock;
-            }
-
-          /* Push a cancellation point onto the stack.  This will be
-           * called if the thread is canceled.
-           */
-
-          info.tc_conn = conn;
-          info.tc_cb   = conn->sndcb;
-          info.tc_sem  = &conn->snd_sem;
-          tls_cleanup_push(tls_get_info(), tcp_callback_cleanup, &info);
-
-          ret = net_sem_timedwait_uninterruptible(&conn->snd_sem,
-            tcp_send_gettimeout(start, timeout));
-          tls_cleanup_pop(tls_get_info(), 0);
-          if (ret < 0)
-            {
-              if (ret == -ETIMEDOUT)
-                {
-                  ret = -EAGAIN;
-                }
-
-              goto errout_with_lock;
-            }
+          goto errout_with_lock;
         }
 #endif /* CONFIG_NET_SEND_BUFSIZE */
 
@@ -1546,7 +1634,52 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            * remaining data.
            */
 
-          chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+#ifdef CONFIG_NET_CONN_LOCK
+          /* A new write buffer is not visible to anyone else yet, so the
+           * user data can be copied into it without the network lock.  A
+           * coalesced one holds data queued before and must stay locked,
+           * or the data of other senders could overtake it.
+           */
+
+          if (off == 0)
+            {
+              unsigned int count;
+              int blresult;
+
+              blresult     = net_breaklock(&count);
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+              if (blresult >= 0)
+                {
+                  net_restorelock(count);
+                }
+
+#if CONFIG_NET_SEND_BUFSIZE > 0
+              /* Other senders may have filled the send buffer while the
+               * lock was broken, wait for room again before queueing.
+               */
+
+              ret = tcp_send_waitbuffer(conn, nonblock, start, timeout);
+              if (ret < 0)
+                {
+                  tcp_wrbuffer_release(wrb);
+                  goto errout_with_lock;
+                }
+#endif
+
+              if (!_SS_ISCONNECTED(conn->sconn.s_flags))
+                {
+                  nerr("ERROR: No longer connected\n");
+                  tcp_wrbuffer_release(wrb);
+                  ret = -ENOTCONN;
+                  goto errout_with_lock;
+                }
+            }
+          else
+#endif
+            {
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+            }
+
           if (chunk_result == -ENOMEM)
             {
               if (TCP_WBPKTLEN(wrb) > 0)
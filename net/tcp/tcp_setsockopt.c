@@ -28,6 +28,7 @@
 
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -260,6 +261,27 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        if (value == NULL || value_len == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            net_lock();
+            ret = tcp_cc_select(conn, value, value_len);
+            net_unlock();
+
+            if (ret < 0)
+              {
+                nerr("ERROR: Unknown congestion control: %.*s\n",
+                     (int)value_len, (FAR const char *)value);
+              }
+          }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -339,6 +339,9 @@ void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout)
 void tcp_stop_timer(FAR struct tcp_conn_s *conn)
 {
   work_cancel(LPWORK, &conn->work);
+#ifdef CONFIG_NET_TCP_CC_PACE
+  work_cancel(LPWORK, &conn->pace_work);
+#endif
 }
 
 /****************************************************************************
@@ -633,22 +636,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                     tcp_rexmit(dev, conn, result);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-                    /* If conn is TCP_INFR, it should enter to slow start */
-
-                    if (conn->flags & TCP_INFR)
-                      {
-                        conn->flags &= ~TCP_INFR;
-                      }
-
-                    /* update the max_cwnd */
-
-                    conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
-
-                    /* reset cwnd and ssthresh, refers to RFC5861. */
-
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
-                    conn->cwnd = conn->mss;
+                    tcp_cc_rto(conn);
 #endif
                     goto done;
 
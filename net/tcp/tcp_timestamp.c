@@ -0,0 +1,370 @@
+/****************************************************************************
+ * net/tcp/tcp_timestamp.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* RFC 7323, Section 5.5: ts_recent is invalid after 24 days of idle time */
+
+#define TCP_PAWS_IDLE_SEC    (24 * 24 * 60 * 60)
+
+/* RTT samples above this value (units: milliseconds) are bogus, e.g. an
+ * echo of a timestamp that the peer remembered from a previous connection.
+ */
+
+#define TCP_RTT_MAX_MSEC     (TCP_RTO_MAX * 500)
+
+/* Clock granularity G of RFC 6298 (units: milliseconds) */
+
+#define TCP_RTT_GRANULARITY  MSEC_PER_TICK
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_ts_now
+ *
+ * Description:
+ *   Get the current value of the timestamp clock of the connection, in
+ *   milliseconds.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_ts_now(FAR struct tcp_conn_s *conn)
+{
+  return (uint32_t)TICK2MSEC(clock_systime_ticks()) + conn->ts_offset;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_ts_init
+ *
+ * Description:
+ *   Initialize the timestamp and RTT estimation variables.  The function is
+ *   called on starting a new connection.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The normal user level code is calling the connect/accept to start a new
+ *   connection.
+ *
+ ****************************************************************************/
+
+void tcp_ts_init(FAR struct tcp_conn_s *conn)
+{
+  /* A random offset per connection keeps the clock of the host hidden
+   * (RFC 7323, Section 7.1).
+   */
+
+  arc4random_buf(&conn->ts_offset, sizeof(conn->ts_offset));
+
+  conn->ts_recent = 0;
+  conn->ts_time   = 0;
+  conn->srtt      = 0;
+  conn->rttvar    = 0;
+}
+
+/****************************************************************************
+ * Name: tcp_ts_option
+ *
+ * Description:
+ *   Write the Timestamps option, preceded by two NOPs, to the option area
+ *   of an outgoing segment.  The option takes TCP_OPT_TS_ALIGNED_LEN bytes.
+ *
+ * Input Parameters:
+ *   conn    - The TCP connection of interest
+ *   optdata - Where to write the option
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_ts_option(FAR struct tcp_conn_s *conn, FAR uint8_t *optdata)
+{
+  optdata[0] = TCP_OPT_NOOP;
+  optdata[1] = TCP_OPT_NOOP;
+  optdata[2] = TCP_OPT_TS;
+  optdata[3] = TCP_OPT_TS_LEN;
+
+  /* TSecr is only valid once the peer has sent a timestamp */
+
+  tcp_setsequence(&optdata[4], tcp_ts_now(conn));
+  tcp_setsequence(&optdata[8], (conn->flags & TCP_TSTAMP) != 0 ?
+                               conn->ts_recent : 0);
+}
+
+/****************************************************************************
+ * Name: tcp_ts_parse
+ *
+ * Description:
+ *   Find the Timestamps option in the header of an incoming segment.
+ *
+ * Input Parameters:
+ *   tcp    - The TCP header
+ *   tsval  - Location to return the TSval field
+ *   tsecr  - Location to return the TSecr field
+ *
+ * Returned Value:
+ *   true if the segment carries the option.
+ *
+ ****************************************************************************/
+
+bool tcp_ts_parse(FAR struct tcp_hdr_s *tcp, FAR uint32_t *tsval,
+                  FAR uint32_t *tsecr)
+{
+  FAR uint8_t *opt = tcp->optdata;
+  int optlen = (((tcp->tcpoffset >> 4) - 5) << 2);
+  int i;
+
+  /* Nearly every peer puts the option first, aligned by two NOPs */
+
+  if (optlen >= TCP_OPT_TS_ALIGNED_LEN &&
+      opt[0] == TCP_OPT_NOOP && opt[1] == TCP_OPT_NOOP &&
+      opt[2] == TCP_OPT_TS && opt[3] == TCP_OPT_TS_LEN)
+    {
+      *tsval = tcp_getsequence(&opt[4]);
+      *tsecr = tcp_getsequence(&opt[8]);
+      return true;
+    }
+
+  for (i = 0; i < optlen; )
+    {
+      if (opt[i] == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt[i] == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+
+      if (i + 1 >= optlen || opt[i + 1] < 2)
+        {
+          /* The options are malformed */
+
+          break;
+        }
+
+      if (opt[i] == TCP_OPT_TS && opt[i + 1] == TCP_OPT_TS_LEN &&
+          i + TCP_OPT_TS_LEN <= optlen)
+        {
+          *tsval = tcp_getsequence(&opt[i + 2]);
+          *tsecr = tcp_getsequence(&opt[i + 6]);
+          return true;
+        }
+
+      i += opt[i + 1];
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_ts_input
+ *
+ * Description:
+ *   Process the Timestamps option of an incoming segment: reject the
+ *   segment if its timestamp is older than the latest one from the peer
+ *   (PAWS, RFC 7323 Section 5.3) and record the timestamp to echo.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   tcp    - The TCP header
+ *   tsecr  - Location to return the TSecr field, zero if the segment does
+ *            not carry the option
+ *
+ * Returned Value:
+ *   false if the segment must be dropped.  The caller should then send an
+ *   ACK.
+ *
+ * Assumptions:
+ *   The network is locked and the option has been negotiated.
+ *
+ ****************************************************************************/
+
+bool tcp_ts_input(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
+                  FAR uint32_t *tsecr)
+{
+  uint32_t tsval;
+
+  *tsecr = 0;
+
+  /* Be lenient with peers that omit the option on some segments */
+
+  if (!tcp_ts_parse(tcp, &tsval, tsecr))
+    {
+      return true;
+    }
+
+  if ((tcp->flags & (TCP_SYN | TCP_RST)) == 0 &&
+      TCP_SEQ_LT(tsval, conn->ts_recent))
+    {
+      /* ts_recent expires if the connection was idle for too long */
+
+      if (TICK2SEC(clock_systime_ticks() - conn->ts_time) <=
+          TCP_PAWS_IDLE_SEC)
+        {
+          ninfo("PAWS reject: tsval=%" PRIu32 " ts_recent=%" PRIu32 "\n",
+                tsval, conn->ts_recent);
+          return false;
+        }
+
+      conn->ts_recent = tsval;
+      conn->ts_time   = clock_systime_ticks();
+    }
+
+  /* Only a segment at the left edge of the window updates ts_recent, so
+   * that the echoed timestamp is the one of the oldest unacked segment
+   * (RFC 7323, Section 4.3).
+   */
+
+  if (TCP_SEQ_GTE(tsval, conn->ts_recent) &&
+      TCP_SEQ_LTE(tcp_getsequence(tcp->seqno),
+                  tcp_getsequence(conn->rcvseq)))
+    {
+      conn->ts_recent = tsval;
+      conn->ts_time   = clock_systime_ticks();
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_ts_rtt
+ *
+ * Description:
+ *   Update the RTT estimation and the retransmission timeout with the
+ *   timestamp echoed by an ACK of new data, as described in RFC 6298.
+ *   The echoed timestamp is that of the segment which triggered the ACK,
+ *   so the sample is also valid after retransmissions.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   tsecr  - The TSecr field of the ACK
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_ts_rtt(FAR struct tcp_conn_s *conn, uint32_t tsecr)
+{
+  uint32_t rtt = tcp_ts_now(conn) - tsecr;
+  uint32_t rto;
+  int32_t delta;
+
+  if (rtt > TCP_RTT_MAX_MSEC)
+    {
+      return;
+    }
+
+  /* A zero sample would make srtt look unset */
+
+  if (rtt == 0)
+    {
+      rtt = 1;
+    }
+
+  if (conn->srtt == 0)
+    {
+      /* First sample: SRTT = R, RTTVAR = R / 2 */
+
+      conn->srtt   = rtt << 3;
+      conn->rttvar = rtt << 1;
+    }
+  else
+    {
+      /* RTTVAR = 3/4 * RTTVAR + 1/4 * |SRTT - R|
+       * SRTT   = 7/8 * SRTT + 1/8 * R
+       */
+
+      delta = (int32_t)rtt - (int32_t)(conn->srtt >> 3);
+      conn->srtt += delta;
+
+      if (delta < 0)
+        {
+          delta = -delta;
+        }
+
+      conn->rttvar += delta - (int32_t)(conn->rttvar >> 2);
+    }
+
+  /* RTO = SRTT + max(G, 4 * RTTVAR), in half-seconds rounded up */
+
+  rto = (conn->srtt >> 3) +
+        (conn->rttvar > TCP_RTT_GRANULARITY ?
+         conn->rttvar : TCP_RTT_GRANULARITY);
+  rto = (rto + 499) / 500;
+
+  if (rto < TCP_RTO_MIN)
+    {
+      rto = TCP_RTO_MIN;
+    }
+  else if (rto > TCP_RTO_MAX)
+    {
+      rto = TCP_RTO_MAX;
+    }
+
+  conn->rto = rto;
+
+  ninfo("TCP RTT: rtt=%" PRIu32 " srtt=%" PRIu32 " rttvar=%" PRIu32
+        " rto=%" PRIu32 "\n", rtt, conn->srtt >> 3, conn->rttvar >> 2, rto);
+}
+
+#endif /* CONFIG_NET_TCP_TIMESTAMPS */
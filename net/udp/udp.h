@@ -110,6 +110,9 @@ struct udp_conn_s
 
   /* UDP-specific content follows */
 
+#if CONFIG_NET_UDP_HASHSIZE > 0
+  dq_entry_t hashnode;    /* Link in the connection hash table */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
@@ -250,6 +253,25 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_conn_s *conn,
                                   FAR struct udp_hdr_s *udp);
 
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   Select the connection of a SO_REUSEPORT group that receives a unicast
+ *   packet by the hash of its flow.  'conn' is the first matching
+ *   connection returned by udp_active().
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct udp_conn_s *udp_reuseport_select(FAR struct net_driver_s *dev,
+                                            FAR struct udp_conn_s *conn,
+                                            FAR struct udp_hdr_s *udp);
+#endif
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -263,6 +285,24 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 
 FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port of a UDP connection.  The port must only be changed
+ *   by this function so that the connection hash table stays consistent.
+ *
+ * Input Parameters:
+ *   conn   - A reference to UDP connection structure
+ *   portno - The new local port in network byte order, 0 to unbind
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno);
+
 /****************************************************************************
  * Name: udp_select_port
  *
@@ -753,6 +793,30 @@ void udp_callback_cleanup(FAR void *arg);
 ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
                            int flags);
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Perform the recvmmsg operation for a UDP SOCK_DGRAM, the datagrams
+ *   that are already buffered are received under a single lock.
+ *
+ * Input Parameters:
+ *   psock   Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec  Receive info and buffers for the datagrams
+ *   vlen    The number of entries in msgvec
+ *   flags   Receive flags
+ *   timeout Time limit of the whole call, only checked between datagrams
+ *
+ * Returned Value:
+ *   On success, returns the number of datagrams received.  On  error,
+ *   -errno is returned (see recvfrom for list of errnos).
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock,
+                       FAR struct mmsghdr *msgvec, unsigned int vlen,
+                       int flags, FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_udp_sendto
  *
@@ -782,6 +846,32 @@ ssize_t psock_udp_sendto(FAR struct socket *psock,
                          FAR const void *buf, size_t len, int flags,
                          FAR const struct sockaddr *to, socklen_t tolen);
 
+/****************************************************************************
+ * Name: psock_udp_sendmmsg
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the sendmmsg()
+ *   socket operation.  The whole batch is appended to the write queue in
+ *   one step, so the driver is notified once for it.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The datagrams to send
+ *   vlen     The number of entries in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of datagrams queued.  If the first one
+ *   fails, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+int psock_udp_sendmmsg(FAR struct socket *psock,
+                       FAR struct mmsghdr *msgvec, unsigned int vlen,
+                       int flags);
+#endif
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
@@ -56,9 +56,12 @@
 
 #include <arch/irq.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/sched.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -82,6 +85,18 @@
 #  define CONFIG_NET_UDP_MAX_CONNS 0
 #endif
 
+#if CONFIG_NET_UDP_HASHSIZE > 0
+#  if (CONFIG_NET_UDP_HASHSIZE & (CONFIG_NET_UDP_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_UDP_HASHSIZE must be a power of two
+#  endif
+
+/* Map a local port to a bucket of the connection hash table */
+
+#  define UDP_HASH_BUCKET(portno) \
+          (((uint32_t)(portno) * 2654435761u >> 16) & \
+           (CONFIG_NET_UDP_HASHSIZE - 1))
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -97,10 +112,50 @@ static mutex_t g_free_lock = NXMUTEX_INITIALIZER;
 
 static dq_queue_t g_active_udp_connections;
 
+#if CONFIG_NET_UDP_HASHSIZE > 0
+/* The bound connections hashed by their local port */
+
+static dq_queue_t g_udp_hash[CONFIG_NET_UDP_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_nextactive
+ *
+ * Description:
+ *   Traverse the connections that may be bound to the local port.  With the
+ *   hash table, these are the connections of the port's bucket, otherwise
+ *   all allocated connections.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static inline FAR struct udp_conn_s *
+udp_nextactive(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#if CONFIG_NET_UDP_HASHSIZE > 0
+  FAR dq_entry_t *node;
+
+  if (conn == NULL)
+    {
+      node = dq_peek(&g_udp_hash[UDP_HASH_BUCKET(portno)]);
+    }
+  else
+    {
+      node = dq_next(&conn->hashnode);
+    }
+
+  return node ? container_of(node, struct udp_conn_s, hashnode) : NULL;
+#else
+  return udp_nextconn(conn);
+#endif
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -113,6 +168,7 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never conflict.
+ *              SO_REUSEPORT: Likewise, the sockets then form a group.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -126,11 +182,12 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   FAR struct udp_conn_s *conn = NULL;
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
+  bool skip_group = _SO_GETOPT(opt, SO_REUSEPORT);
 #endif
 
   /* Now search each connection structure. */
 
-  while ((conn = udp_nextconn(conn)) != NULL)
+  while ((conn = udp_nextactive(conn, portno)) != NULL)
     {
       /* With SO_REUSEADDR set for both sockets, we do not need to check its
        * address and port.
@@ -141,6 +198,11 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
         {
           continue;
         }
+
+      if (skip_group && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
 #endif
 
       /* If the port local port number assigned to the connections matches
@@ -203,7 +265,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextactive(conn, udp->destport);
 
   while (conn)
     {
@@ -317,7 +379,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_nextactive(conn, udp->destport);
     }
 
   return conn;
@@ -343,7 +405,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextactive(conn, udp->destport);
 
   while (conn != NULL)
     {
@@ -457,13 +519,63 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_nextactive(conn, udp->destport);
     }
 
   return conn;
 }
 #endif /* CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: udp_reuseport_member
+ *
+ * Description:
+ *   Return true if the connection is an unconnected member of a
+ *   SO_REUSEPORT group and may receive on the given CPU, or on any CPU if
+ *   cpu < 0.  A member that never received has no CPU (rcvcpu is -1) and
+ *   only matches any CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static inline bool udp_reuseport_member(FAR struct udp_conn_s *conn,
+                                        int cpu)
+{
+  return _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) &&
+         !_UDP_ISCONNECTMODE(conn->flags)
+#ifdef CONFIG_NET_REUSEPORT_LOCALCPU
+         && (cpu < 0 || conn->rcvcpu == cpu)
+#endif
+         ;
+}
+
+/****************************************************************************
+ * Name: udp_reuseport_count
+ *
+ * Description:
+ *   Count the members of the SO_REUSEPORT group that match the packet,
+ *   starting at the first matching connection.
+ *
+ ****************************************************************************/
+
+static unsigned int udp_reuseport_count(FAR struct net_driver_s *dev,
+                                        FAR struct udp_conn_s *conn,
+                                        FAR struct udp_hdr_s *udp, int cpu)
+{
+  unsigned int count = 0;
+
+  for (; conn != NULL; conn = udp_active(dev, conn, udp))
+    {
+      if (udp_reuseport_member(conn, cpu))
+        {
+          count++;
+        }
+    }
+
+  return count;
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -580,6 +692,9 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
       conn->domain      = domain;
 #endif
       conn->lport       = 0;
+#ifdef CONFIG_NETDEV_RSS
+      conn->rcvcpu      = -1;
+#endif
 #if CONFIG_NET_RECV_BUFSIZE > 0
       conn->rcvbufs     = CONFIG_NET_RECV_BUFSIZE;
 #endif
@@ -594,6 +709,8 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
 
       sq_init(&conn->write_q);
 #endif
+      conn_lock_init(&conn->sconn);
+
       /* Enqueue the connection into the active list */
 
       dq_addlast(&conn->sconn.node, &g_active_udp_connections);
@@ -623,7 +740,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   nxmutex_lock(&g_free_lock);
-  conn->lport = 0;
+  udp_setport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -631,7 +748,10 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   /* Release any read-ahead buffers attached to the connection, NULL is ok */
 
+  conn_lock(&conn->sconn);
   iob_free_chain(conn->readahead);
+  conn->readahead = NULL;
+  conn_unlock(&conn->sconn);
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
@@ -692,6 +812,104 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   Select the connection of a SO_REUSEPORT group that receives a unicast
+ *   packet.  The flows are spread over the unconnected members of the group
+ *   by the hash of the source address and the ports, so that all packets of
+ *   a flow go to the same socket.  With CONFIG_NET_REUSEPORT_LOCALCPU the
+ *   members whose thread last received on this CPU are preferred.  UDP
+ *   keeps no per-flow state, so the selection is then also a function of
+ *   the receiving CPU and of where the members last received: a flow only
+ *   stays on one socket while RSS keeps it on one CPU and the threads of
+ *   the group stay on their CPUs.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure containing the received packet
+ *   conn - The first matching connection, as returned by udp_active()
+ *   udp  - The UDP header of the packet
+ *
+ * Returned Value:
+ *   The selected connection, 'conn' itself if it is not an unconnected
+ *   member of a SO_REUSEPORT group.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct udp_conn_s *udp_reuseport_select(FAR struct net_driver_s *dev,
+                                            FAR struct udp_conn_s *conn,
+                                            FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *member;
+  FAR const void *srcaddr;
+  unsigned int nmembers = 0;
+  unsigned int index;
+  int cpu = -1;
+
+  if (!udp_reuseport_member(conn, -1))
+    {
+      return conn;
+    }
+
+#ifdef CONFIG_NET_REUSEPORT_LOCALCPU
+  cpu = this_cpu();
+  nmembers = udp_reuseport_count(dev, conn, udp, cpu);
+  if (nmembers == 0)
+    {
+      cpu = -1;
+    }
+#endif
+
+  if (nmembers == 0)
+    {
+      nmembers = udp_reuseport_count(dev, conn, udp, -1);
+    }
+
+  /* A single CPU-local member still has to be looked up */
+
+  if (cpu < 0 && nmembers < 2)
+    {
+      return conn;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#  endif
+    {
+      srcaddr = IPv6BUF->srcipaddr;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      srcaddr = IPv4BUF->srcipaddr;
+    }
+#endif
+
+  index = net_flowhash(conn->domain, srcaddr, udp->srcport, udp->destport) %
+          nmembers;
+
+  for (member = conn; member != NULL; member = udp_active(dev, member, udp))
+    {
+      if (udp_reuseport_member(member, cpu) && index-- == 0)
+        {
+          return member;
+        }
+    }
+
+  return conn;
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -715,6 +933,46 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port of a UDP connection.  The port must only be changed
+ *   by this function so that the connection hash table stays consistent.
+ *
+ * Input Parameters:
+ *   conn   - A reference to UDP connection structure
+ *   portno - The new local port in network byte order, 0 to unbind
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#if CONFIG_NET_UDP_HASHSIZE > 0
+  net_lock();
+
+  /* Only the bound connections are in the hash table */
+
+  if (conn->lport != 0)
+    {
+      dq_rem(&conn->hashnode, &g_udp_hash[UDP_HASH_BUCKET(conn->lport)]);
+    }
+
+  if (portno != 0)
+    {
+      dq_addlast(&conn->hashnode, &g_udp_hash[UDP_HASH_BUCKET(portno)]);
+    }
+
+  conn->lport = portno;
+  net_unlock();
+#else
+  conn->lport = portno;
+#endif
+}
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -852,7 +1110,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
       else
         {
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
     }
@@ -877,7 +1135,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
       else
@@ -929,7 +1187,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
@@ -245,7 +245,9 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   dev->d_appdata = IPBUF(udpiplen);
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-  chksum = udp->udpchksum;
+  /* Skip the check if the driver has verified the checksum already */
+
+  chksum = netdev_csum_valid(dev) ? 0 : udp->udpchksum;
   if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
@@ -289,7 +291,9 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
       conn = udp_active(dev, NULL, udp);
       if (conn)
         {
-          /* We'll only get multiple conn when we support SO_REUSEADDR */
+          /* We'll only get multiple conn when we support SO_REUSEADDR or
+           * SO_REUSEPORT.
+           */
 
 #if defined(CONFIG_NET_SOCKOPTS) && defined(CONFIG_NET_BROADCAST)
           /* Check if the destination is a broadcast/multicast address */
@@ -326,6 +330,17 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
             }
 #endif
 
+#ifdef CONFIG_NET_SOCKOPTS
+          /* A unicast packet goes to one member of a SO_REUSEPORT group */
+
+#  ifdef CONFIG_NET_BROADCAST
+          if (!udp_is_broadcast(dev))
+#  endif
+            {
+              conn = udp_reuseport_select(dev, conn, udp);
+            }
+#endif
+
           /* We can deliver the packet directly to the last listener. */
 
           ret = udp_input_conn(dev, conn, udpiplen);
@@ -65,6 +65,7 @@ static void udp_path(FAR struct udp_conn_s *conn, FAR char *buf, size_t len)
   FAR void *laddr = net_ip_binding_laddr(&conn->u, domain);
   FAR void *raddr = net_ip_binding_raddr(&conn->u, domain);
 
+  conn_lock(&conn->sconn);
   snprintf(buf, len, "udp:["
            "%s:%" PRIu16 "<->%s:%" PRIu16
 #if CONFIG_NET_SEND_BUFSIZE > 0
@@ -89,6 +90,7 @@ static void udp_path(FAR struct udp_conn_s *conn, FAR char *buf, size_t len)
 #endif
            conn->sconn.s_flags
            );
+  conn_unlock(&conn->sconn);
 }
 
 /****************************************************************************
@@ -118,6 +120,7 @@ int udp_ioctl(FAR struct udp_conn_s *conn, int cmd, unsigned long arg)
   switch (cmd)
     {
       case FIONREAD:
+        conn_lock(&conn->sconn);
         iob = conn->readahead;
         if (iob)
           {
@@ -129,6 +132,8 @@ int udp_ioctl(FAR struct udp_conn_s *conn, int cmd, unsigned long arg)
           {
             *(FAR int *)((uintptr_t)arg) = 0;
           }
+
+        conn_unlock(&conn->sconn);
         break;
       case FIONSPACE:
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
@@ -33,6 +33,9 @@
 #include <assert.h>
 
 #include <sys/time.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
@@ -690,6 +693,24 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
       return -ENOTSUP;
     }
 
+#ifdef CONFIG_NET_CONN_LOCK
+  /* Take a datagram that is already buffered without the network lock.
+   * The connection lock protects the read-ahead buffers.
+   */
+
+  udp_recvfrom_initialize(conn, msg, &state, flags);
+
+  conn_lock(&conn->sconn);
+  udp_readahead(&state);
+  conn_unlock(&conn->sconn);
+
+  udp_recvfrom_uninitialize(&state);
+  if (state.ir_recvlen >= 0)
+    {
+      return state.ir_recvlen;
+    }
+#endif
+
   /* Initialize the state structure.  This is done with the network locked
    * because we don't want anything to happen until we are ready.
    */
@@ -699,7 +720,9 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   /* Copy the read-ahead data from the packet */
 
+  conn_lock(&conn->sconn);
   udp_readahead(&state);
+  conn_unlock(&conn->sconn);
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -794,4 +817,126 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Perform the recvmmsg operation for a UDP SOCK_DGRAM.  Only the first
+ *   datagram of a batch may block, the datagrams that are already queued
+ *   in the read-ahead buffers are then taken under a single lock.
+ *
+ * Input Parameters:
+ *   psock   Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec  Receive info and buffers for the datagrams
+ *   vlen    The number of entries in msgvec
+ *   flags   Receive flags
+ *   timeout Time limit of the whole call, only checked between datagrams
+ *
+ * Returned Value:
+ *   On success, returns the number of datagrams received.  On  error,
+ *   -errno is returned (see recvfrom for list of errnos).
+ *
+ * Assumptions:
+ *   The address of each message was verified by the caller.
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock,
+                       FAR struct mmsghdr *msgvec, unsigned int vlen,
+                       int flags, FAR const struct timespec *timeout)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  struct udp_recvfrom_s state;
+  FAR struct msghdr *msg;
+  FAR void *msg_control;
+  unsigned long msg_controllen;
+  clock_t deadline = 0;
+  unsigned int count = 0;
+  ssize_t ret = OK;
+
+  if (timeout != NULL)
+    {
+      deadline = clock_systime_ticks() + clock_time2ticks(timeout);
+    }
+
+  while (count < vlen)
+    {
+      /* Wait for the next datagram as recvmsg() would */
+
+      msg            = &msgvec[count].msg_hdr;
+      msg_control    = msg->msg_control;
+      msg_controllen = msg->msg_controllen;
+
+      ret = psock_udp_recvfrom(psock, msg, flags);
+
+      msg->msg_control    = msg_control;
+      msg->msg_controllen = msg_controllen - msg->msg_controllen;
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count++].msg_len = ret;
+
+      if ((flags & MSG_PEEK) != 0)
+        {
+          break;
+        }
+
+      /* Take the datagrams that are already buffered in one go */
+
+#ifdef CONFIG_NET_CONN_LOCK
+      conn_lock(&conn->sconn);
+#else
+      net_lock();
+#endif
+      udp_recvfrom_initialize(conn, NULL, &state, flags);
+
+      while (count < vlen && conn->readahead != NULL)
+        {
+          msg = &msgvec[count].msg_hdr;
+          if (msg->msg_iovlen != 1)
+            {
+              break;
+            }
+
+          msg_control    = msg->msg_control;
+          msg_controllen = msg->msg_controllen;
+
+          state.ir_msg = msg;
+          udp_readahead(&state);
+
+          msg->msg_control    = msg_control;
+          msg->msg_controllen = msg_controllen - msg->msg_controllen;
+
+          if (state.ir_recvlen < 0)
+            {
+              break;
+            }
+
+          msgvec[count++].msg_len = state.ir_recvlen;
+        }
+
+      udp_recvfrom_uninitialize(&state);
+#ifdef CONFIG_NET_CONN_LOCK
+      conn_unlock(&conn->sconn);
+#else
+      net_unlock();
+#endif
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL && clock_compare(deadline, clock_systime_ticks()))
+        {
+          break;
+        }
+    }
+
+  return count > 0 ? (int)count : (int)ret;
+}
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP */
@@ -87,12 +87,27 @@
 static void udp_send_loopback(FAR struct net_driver_s *dev)
 {
   FAR struct iob_s *iob = netdev_iob_clone(dev, true);
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  uint8_t csumstate = dev->d_csumstate;
+#endif
+
   if (iob == NULL)
     {
       nerr("ERROR: IOB clone failed when looping UDP.\n");
       return;
     }
 
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  /* The looped copy never leaves the host, a checksum left to the driver
+   * does not need to be checked.
+   */
+
+  if (csumstate == NETDEV_CSUM_PARTIAL)
+    {
+      dev->d_csumstate = NETDEV_CSUM_VERIFIED;
+    }
+#endif
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   if (IFF_IS_IPv4(dev->d_flags))
@@ -118,6 +133,9 @@ static void udp_send_loopback(FAR struct net_driver_s *dev)
   /* Restore device IOB with backup IOB */
 
   netdev_iob_replace(dev, iob);
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  dev->d_csumstate = csumstate;
+#endif
 }
 #endif
 
@@ -248,29 +266,32 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       iob_update_pktlen(dev->d_iob, dev->d_len, false);
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-      /* Calculate UDP checksum. */
+      /* Calculate UDP checksum unless the driver does it. */
 
+      if (!netdev_csum_partial(dev, IP_PROTO_UDP, &udp->udpchksum))
+        {
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
-      if (IFF_IS_IPv4(dev->d_flags))
+          if (IFF_IS_IPv4(dev->d_flags))
 #endif
-        {
-          udp->udpchksum = ~udp_ipv4_chksum(dev);
-        }
+            {
+              udp->udpchksum = ~udp_ipv4_chksum(dev);
+            }
 #endif /* CONFIG_NET_IPv4 */
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
-      else
+          else
 #endif
-        {
-          udp->udpchksum = ~udp_ipv6_chksum(dev);
-        }
+            {
+              udp->udpchksum = ~udp_ipv6_chksum(dev);
+            }
 #endif /* CONFIG_NET_IPv6 */
 
-      if (udp->udpchksum == 0)
-        {
-          udp->udpchksum = 0xffff;
+          if (udp->udpchksum == 0)
+            {
+              udp->udpchksum = 0xffff;
+            }
         }
 #endif /* CONFIG_NET_UDP_CHECKSUMS */
 
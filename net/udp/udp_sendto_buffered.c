@@ -258,7 +258,7 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
@@ -514,51 +514,161 @@ static unsigned int udp_send_gettimeout(clock_t start, unsigned int timeout)
 }
 
 /****************************************************************************
- * Public Functions
+ * Name: sendto_batch_size
+ *
+ * Description:
+ *   Get the size of the write buffers gathered in a batch that is not
+ *   queued yet.
+ *
  ****************************************************************************/
 
+#if CONFIG_NET_SEND_BUFSIZE > 0
+static uint32_t sendto_batch_size(FAR sq_queue_t *batch)
+{
+  FAR struct udp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  uint32_t total = 0;
+
+  if (batch != NULL)
+    {
+      for (entry = sq_peek(batch); entry; entry = sq_next(entry))
+        {
+          wrb = (FAR struct udp_wrbuffer_s *)entry;
+          total += wrb->wb_iob->io_pktlen;
+        }
+    }
+
+  return total;
+}
+
 /****************************************************************************
- * Name: psock_udp_sendto
+ * Name: sendto_waitbuffer
  *
  * Description:
- *   This function implements the UDP-specific logic of the standard
- *   sendto() socket operation.
+ *   Wait until a datagram of len bytes fits in the send buffer limit,
+ *   counting the data gathered in the batch, if any.
  *
- * Input Parameters:
- *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
- *   flags    Send flags
- *   to       Address of recipient
- *   tolen    The length of the address structure
+ * Assumptions:
+ *   The network is locked.
  *
- *   NOTE: All input parameters were verified by sendto() before this
- *   function was called.
+ ****************************************************************************/
+
+static int sendto_waitbuffer(FAR struct udp_conn_s *conn, size_t len,
+                             FAR sq_queue_t *batch, bool nonblock,
+                             clock_t start, unsigned int timeout)
+{
+  int ret;
+
+  while (udp_wrbuffer_inqueue_size(conn) +
+         sendto_batch_size(batch) + len > conn->sndbufs)
+    {
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = net_sem_timedwait_uninterruptible(&conn->sndsem,
+        udp_send_gettimeout(start, timeout));
+      if (ret < 0)
+        {
+          return ret == -ETIMEDOUT ? -EAGAIN : ret;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: sendto_batch_flush
  *
- * Returned Value:
- *   On success, returns the number of characters sent.  On  error,
- *   a negated errno value is returned.  See the description in
- *   net/socket/sendto.c for the list of appropriate return value.
+ * Description:
+ *   Append the write buffers gathered by psock_udp_sendmmsg() to the write
+ *   queue in one step, so the driver is notified at most once and sees the
+ *   whole batch in its next poll.
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
-ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
-                         size_t len, int flags,
-                         FAR const struct sockaddr *to, socklen_t tolen)
+static int sendto_batch_flush(FAR struct udp_conn_s *conn,
+                              FAR sq_queue_t *batch)
+{
+  FAR sq_entry_t *entry;
+  bool empty;
+  int ret = OK;
+
+  if (sq_empty(batch))
+    {
+      return OK;
+    }
+
+  empty = sq_empty(&conn->write_q);
+  sq_cat(batch, &conn->write_q);
+
+  if (empty)
+    {
+      /* The batch lies at the head of the write queue, set up for the
+       * transfer of its first datagram.  On failure the write queue holds
+       * nothing but the batch.
+       */
+
+      ret = sendto_next_transfer(conn);
+      if (ret < 0)
+        {
+          while ((entry = sq_remfirst(&conn->write_q)) != NULL)
+            {
+              udp_wrbuffer_release((FAR struct udp_wrbuffer_s *)entry);
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: udp_sendto_iov
+ *
+ * Description:
+ *   Queue one datagram gathered from an I/O vector, see psock_udp_sendto().
+ *
+ *   If batch is not NULL, the write buffer is appended to it instead of the
+ *   write queue, and sendto_batch_flush() hands it to the driver later.
+ *   The buffers held by a non-empty batch are never released while the
+ *   caller waits, so such a call does not wait: it fails with -EAGAIN or
+ *   -ENOMEM and the caller flushes the batch before retrying.
+ *
+ ****************************************************************************/
+
+static ssize_t udp_sendto_iov(FAR struct socket *psock,
+                              FAR const struct iovec *iov, int iovcnt,
+                              int flags, FAR const struct sockaddr *to,
+                              socklen_t tolen, FAR sq_queue_t *batch)
 {
   FAR struct udp_wrbuffer_s *wrb;
   FAR struct udp_conn_s *conn;
   unsigned int timeout;
   uint16_t udpiplen;
+  unsigned int offset;
+  unsigned int count;
+  size_t len;
   bool nonblock;
   bool empty;
+  int blresult;
   int ret = OK;
   clock_t start;
+  int i;
 
   /* Get the underlying the UDP connection structure.  */
 
   conn = psock->s_conn;
 
+  for (len = 0, i = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
   /* The length of a datagram to be up to 65,535 octets */
 
   if (len > 65535)
@@ -679,13 +789,17 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
   nonblock = _SS_ISNONBLOCK(conn->sconn.s_flags) ||
-                            (flags & MSG_DONTWAIT) != 0;
+                            (flags & MSG_DONTWAIT) != 0 ||
+                            (batch != NULL && !sq_empty(batch));
   start    = clock_systime_ticks();
   timeout  = _SO_TIMEOUT(conn->sconn.s_sndtimeo);
 
-  /* Dump the incoming buffer */
+  /* Dump the incoming buffers */
 
-  BUF_DUMP("psock_udp_sendto", buf, len);
+  for (i = 0; i < iovcnt; i++)
+    {
+      BUF_DUMP("psock_udp_sendto", iov[i].iov_base, iov[i].iov_len);
+    }
 
   if (len > 0)
     {
@@ -696,25 +810,10 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
        * wait for the write buffer to be released
        */
 
-      while (udp_wrbuffer_inqueue_size(conn) + len > conn->sndbufs)
+      ret = sendto_waitbuffer(conn, len, batch, nonblock, start, timeout);
+      if (ret < 0)
         {
-          if (nonblock)
-            {
-              ret = -EAGAIN;
-              goto errout_with_lock;
-            }
-
-          ret = net_sem_timedwait_uninterruptible(&conn->sndsem,
-            udp_send_gettimeout(start, timeout));
-          if (ret < 0)
-            {
-              if (ret == -ETIMEDOUT)
-                {
-                  ret = -EAGAIN;
-                }
-
-              goto errout_with_lock;
-            }
+          goto errout_with_lock;
         }
 #endif /* CONFIG_NET_SEND_BUFSIZE */
 
@@ -819,22 +918,52 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
       if (nonblock)
         {
-          ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf,
-                              len, udpiplen, false);
+#ifdef CONFIG_NET_CONN_LOCK
+          /* The write buffer is not queued yet, so nobody else can see it
+           * and the copy does not need the network lock either.
+           */
+
+          blresult = net_breaklock(&count);
+#endif
+          for (offset = udpiplen, i = 0; i < iovcnt; i++)
+            {
+              ret = iob_trycopyin(wrb->wb_iob, iov[i].iov_base,
+                                  iov[i].iov_len, offset, false);
+              if (ret < 0)
+                {
+                  break;
+                }
+
+              offset += iov[i].iov_len;
+            }
+
+#ifdef CONFIG_NET_CONN_LOCK
+          if (blresult >= 0)
+            {
+              net_restorelock(count);
+            }
+#endif
         }
       else
         {
-          unsigned int count;
-          int blresult;
-
           /* iob_copyin might wait for buffers to be freed, but if
            * network is locked this might never happen, since network
            * driver is also locked, therefore we need to break the lock
            */
 
           blresult = net_breaklock(&count);
-          ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf,
-                           len, udpiplen, false);
+          for (offset = udpiplen, i = 0; i < iovcnt; i++)
+            {
+              ret = iob_copyin(wrb->wb_iob, iov[i].iov_base,
+                               iov[i].iov_len, offset, false);
+              if (ret < 0)
+                {
+                  break;
+                }
+
+              offset += iov[i].iov_len;
+            }
+
           if (blresult >= 0)
             {
               net_restorelock(count);
@@ -846,6 +975,18 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
           goto errout_with_wrb;
         }
 
+#if CONFIG_NET_SEND_BUFSIZE > 0
+      /* Other senders may have filled the send buffer while the lock was
+       * broken, wait for room again before queueing.
+       */
+
+      ret = sendto_waitbuffer(conn, len, batch, nonblock, start, timeout);
+      if (ret < 0)
+        {
+          goto errout_with_wrb;
+        }
+#endif
+
       /* Dump I/O buffer chain */
 
       UDP_WBDUMP("I/O buffer chain", wrb, wrb->wb_iob->io_pktlen, 0);
@@ -861,6 +1002,13 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
        * not a very common use case, however.
        */
 
+      if (batch != NULL)
+        {
+          sq_addlast(&wrb->wb_node, batch);
+          net_unlock();
+          return len;
+        }
+
       empty = sq_empty(&conn->write_q);
 
       sq_addlast(&wrb->wb_node, &conn->write_q);
@@ -899,6 +1047,135 @@ errout_with_lock:
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_udp_sendto
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the standard
+ *   sendto() socket operation.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ *   NOTE: All input parameters were verified by sendto() before this
+ *   function was called.
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   a negated errno value is returned.  See the description in
+ *   net/socket/sendto.c for the list of appropriate return value.
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags,
+                         FAR const struct sockaddr *to, socklen_t tolen)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
+  return udp_sendto_iov(psock, &iov, 1, flags, to, tolen, NULL);
+}
+
+/****************************************************************************
+ * Name: psock_udp_sendmmsg
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the sendmmsg()
+ *   socket operation.  The datagrams are gathered in a private queue and
+ *   appended to the write queue in one step, so the driver is notified
+ *   once and picks up all of them in a single poll.  If the buffers run
+ *   out part way, the datagrams gathered so far are handed to the driver
+ *   first, so the remaining ones can wait for them to be sent.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The datagrams to send
+ *   vlen     The number of entries in msgvec
+ *   flags    Send flags
+ *
+ *   NOTE: The destination addresses were verified by the caller.
+ *
+ * Returned Value:
+ *   On success, returns the number of datagrams queued.  If the first one
+ *   fails, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_udp_sendmmsg(FAR struct socket *psock,
+                       FAR struct mmsghdr *msgvec, unsigned int vlen,
+                       int flags)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  FAR struct msghdr *msg;
+  sq_queue_t batch;
+  unsigned int queued = 0;
+  unsigned int count;
+  ssize_t ret = OK;
+  int err;
+
+  sq_init(&batch);
+
+  /* udp_sendto_iov() takes the network lock recursively.  It may still
+   * break it to copy the data, but the datagrams stay in the private
+   * batch until it is flushed.
+   */
+
+  net_lock();
+
+  for (count = 0; count < vlen; count++)
+    {
+      msg = &msgvec[count].msg_hdr;
+      ret = udp_sendto_iov(psock, msg->msg_iov, msg->msg_iovlen, flags,
+                           msg->msg_name, msg->msg_namelen, &batch);
+      if ((ret == -EAGAIN || ret == -ENOMEM) && !sq_empty(&batch))
+        {
+          /* Out of buffers, send what was gathered and try again */
+
+          ret = sendto_batch_flush(conn, &batch);
+          if (ret < 0)
+            {
+              count = queued;
+              break;
+            }
+
+          queued = count;
+          ret = udp_sendto_iov(psock, msg->msg_iov, msg->msg_iovlen, flags,
+                               msg->msg_name, msg->msg_namelen, &batch);
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count].msg_len = ret;
+    }
+
+  /* Only the datagrams that made it to the write queue are reported */
+
+  err = sendto_batch_flush(conn, &batch);
+  if (err < 0)
+    {
+      count = queued;
+      ret   = err;
+    }
+
+  net_unlock();
+  return count > 0 ? (int)count : (int)ret;
+}
+
 /****************************************************************************
  * Name: psock_udp_cansend
  *
@@ -27,6 +27,9 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <nuttx/csum.h>
+#include <nuttx/net/ip.h>
+
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -57,56 +60,39 @@
 uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
                     uint16_t len, bool *odd)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
   uint16_t t;
 
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  if (*odd == true)
+  if (len == 0)
     {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 1;
+      return sum;
     }
 
-  while (dataptr < last_byte)
-    {
-      /* At least two more bytes */
+  /* The previous region ended with the high byte of a word */
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
+  if (*odd == true)
+    {
+      t = data[0];
       sum += t;
       if (sum < t)
         {
           sum++; /* carry */
         }
 
-      dataptr += 2;
+      data += 1;
+      len  -= 1;
     }
 
-  *odd = false;
+  *odd = (len & 1) != 0;
 
-  if (dataptr == last_byte)
-    {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  /* csum_partial() sums the words in memory order, which is the byte
+   * swapped network order sum on a little-endian CPU.
+   */
 
-      *odd = true;
-    }
+  sum = csum_partial(data, len, HTONS(sum));
 
   /* Return sum in host byte order. */
 
-  return sum;
+  return NTOHS(sum);
 }
 
 /****************************************************************************
@@ -0,0 +1,98 @@
+/****************************************************************************
+ * net/utils/net_flowhash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sys/socket.h>
+
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_flowhash_mix
+ *
+ * Description:
+ *   Mix one 32-bit word into the hash (the MurmurHash3 block step).
+ *
+ ****************************************************************************/
+
+static inline uint32_t net_flowhash_mix(uint32_t hash, uint32_t word)
+{
+  word *= 0xcc9e2d51;
+  word  = (word << 15) | (word >> 17);
+  word *= 0x1b873593;
+
+  hash ^= word;
+  hash  = (hash << 13) | (hash >> 19);
+  return hash * 5 + 0xe6546b64;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_flowhash
+ *
+ * Description:
+ *   Compute a well distributed hash of a flow from the remote address and
+ *   both ports, see net/utils/utils.h.
+ *
+ ****************************************************************************/
+
+uint32_t net_flowhash(uint8_t domain, FAR const void *raddr,
+                      uint16_t rport, uint16_t lport)
+{
+  FAR const uint8_t *addr = raddr;
+  uint32_t hash = 0;
+  uint32_t word;
+  int len = domain == PF_INET6 ? 16 : 4;
+  int i;
+
+  for (i = 0; i < len; i += 4)
+    {
+      memcpy(&word, addr + i, 4);
+      hash = net_flowhash_mix(hash, word);
+    }
+
+  hash = net_flowhash_mix(hash, (uint32_t)rport << 16 | lport);
+
+  /* Final avalanche, so that the low bits depend on all of the input */
+
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35;
+  hash ^= hash >> 16;
+
+  return hash;
+}
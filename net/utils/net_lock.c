@@ -39,6 +39,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/netstats.h>
 
 #include "utils/utils.h"
 
@@ -58,6 +59,36 @@ static rmutex_t g_netlock = NXRMUTEX_INITIALIZER;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: net_lockstats_wait
+ *
+ * Description:
+ *   Account a contended acquisition of a lock.
+ *
+ * Input Parameters:
+ *   stats - The statistics of the lock
+ *   start - The perf counter when the caller started to wait
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+static void net_lockstats_wait(FAR struct net_lockstats_s *stats,
+                               clock_t start)
+{
+  clock_t elapsed = perf_gettime() - start;
+
+  stats->contended++;
+  stats->waittime += elapsed;
+  if (elapsed > stats->maxwait)
+    {
+      stats->maxwait = elapsed;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: _net_timedwait
  ****************************************************************************/
@@ -135,7 +166,32 @@ _net_timedwait(FAR sem_t *sem, bool interruptible, unsigned int timeout)
 
 int net_lock(void)
 {
+#ifdef CONFIG_NET_LOCK_STATS
+  clock_t start;
+  int ret;
+
+  /* Only the contended case needs to be timed */
+
+  ret = nxrmutex_trylock(&g_netlock);
+  if (ret < 0)
+    {
+      start = perf_gettime();
+      ret = nxrmutex_lock(&g_netlock);
+      if (ret >= 0)
+        {
+          net_lockstats_wait(&g_netstats.lock.netlock, start);
+        }
+    }
+
+  if (ret >= 0)
+    {
+      g_netstats.lock.netlock.acquired++;
+    }
+
+  return ret;
+#else
   return nxrmutex_lock(&g_netlock);
+#endif
 }
 
 /****************************************************************************
@@ -179,6 +235,84 @@ void net_unlock(void)
   nxrmutex_unlock(&g_netlock);
 }
 
+#ifdef CONFIG_NET_CONN_LOCK
+/****************************************************************************
+ * Name: conn_lock_init
+ *
+ * Description:
+ *   Initialize the lock of a connection.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void conn_lock_init(FAR struct socket_conn_s *sconn)
+{
+  nxmutex_init(&sconn->s_lock);
+}
+
+/****************************************************************************
+ * Name: conn_lock
+ *
+ * Description:
+ *   Take the lock of a connection.  The network lock must not be taken
+ *   while holding it.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void conn_lock(FAR struct socket_conn_s *sconn)
+{
+#ifdef CONFIG_NET_LOCK_STATS
+  clock_t start;
+
+  if (nxmutex_trylock(&sconn->s_lock) < 0)
+    {
+      start = perf_gettime();
+      nxmutex_lock(&sconn->s_lock);
+
+      /* The statistics are shared by all connections and updated without
+       * a common lock, they are only approximate.
+       */
+
+      net_lockstats_wait(&g_netstats.lock.connlock, start);
+    }
+
+  g_netstats.lock.connlock.acquired++;
+#else
+  nxmutex_lock(&sconn->s_lock);
+#endif
+}
+
+/****************************************************************************
+ * Name: conn_unlock
+ *
+ * Description:
+ *   Release the lock of a connection.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void conn_unlock(FAR struct socket_conn_s *sconn)
+{
+  nxmutex_unlock(&sconn->s_lock);
+}
+#endif /* CONFIG_NET_CONN_LOCK */
+
 /****************************************************************************
  * Name: net_breaklock
  *
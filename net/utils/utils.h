@@ -415,6 +415,28 @@ void net_bufpool_free(FAR struct net_bufpool_s *pool, FAR void *node);
 
 int net_bufpool_test(FAR struct net_bufpool_s *pool);
 
+/****************************************************************************
+ * Name: net_flowhash
+ *
+ * Description:
+ *   Compute a hash of a flow from its remote address and both ports.  The
+ *   hash is well distributed in all of its bits, so that it can be reduced
+ *   with a modulo to pick one of a group of sockets (SO_REUSEPORT).
+ *
+ * Input Parameters:
+ *   domain - PF_INET or PF_INET6
+ *   raddr  - The remote IP address, no alignment is required
+ *   rport  - The remote port
+ *   lport  - The local port
+ *
+ * Returned Value:
+ *   The 32-bit hash of the flow.
+ *
+ ****************************************************************************/
+
+uint32_t net_flowhash(uint8_t domain, FAR const void *raddr,
+                      uint16_t rport, uint16_t lport);
+
 /****************************************************************************
  * Name: net_chksum_adjust
  *
@@ -213,6 +213,13 @@ static inline void nx_workqueues(void)
 
 #endif /* CONFIG_SCHED_LPWORK */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  /* Start the per-CPU worker threads */
+
+  work_start_percpu();
+
+#endif /* CONFIG_SCHED_WORKQUEUE_PERCPU */
+
 #ifdef CONFIG_LIBC_USRWORK
   /* Start the user-space work queue */
 
@@ -424,7 +424,12 @@ static void idle_task_initialize(void)
 #else
       tasklist = TLIST_HEAD(tcb);
 #endif
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+      DEBUGASSERT(tasklist == list_readytorun());
+      nxsched_add_rtrbitmap(tcb);
+#else
       dq_addfirst((FAR dq_entry_t *)tcb, tasklist);
+#endif
 
       /* Mark the idle task as the running task */
 
@@ -184,6 +184,12 @@ extern dq_queue_t g_readytorun;
  * CPU.  Tasks after the active task are ready-to-run and assigned to this
  * CPU. The tail of this assigned task list, the lowest priority task, is
  * always the CPU's IDLE task.
+ *
+ * If CONFIG_SCHED_PERCPU_READYTORUN is selected, ready-to-run tasks that
+ * cannot run immediately are queued in the g_assignedtasks[n] list of a
+ * CPU rather than in g_readytorun.  A CPU that looks for its next task
+ * takes such a task from another CPU if it has a higher priority than its
+ * own next task, see nxsched_steal_task().
  */
 
 extern dq_queue_t g_assignedtasks[CONFIG_SMP_NCPUS];
@@ -318,6 +324,14 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb);
 int  nxsched_set_priority(FAR struct tcb_s *tcb, int sched_priority);
 bool nxsched_reprioritize_rtr(FAR struct tcb_s *tcb, int priority);
 
+/* Constant time ready-to-run list management */
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+bool nxsched_add_rtrbitmap(FAR struct tcb_s *tcb);
+void nxsched_remove_rtrbitmap(FAR struct tcb_s *tcb);
+void nxsched_update_rtrbitmap(FAR struct tcb_s *tcb, uint8_t priority);
+#endif
+
 /* Priority inheritance support */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -389,6 +403,9 @@ static inline_function FAR struct tcb_s *this_task(void)
 
 #ifdef CONFIG_SMP
 void nxsched_process_delivered(int cpu);
+#  ifdef CONFIG_SCHED_PERCPU_READYTORUN
+FAR struct tcb_s *nxsched_steal_task(int cpu, FAR struct tcb_s *nxttcb);
+#  endif
 #else
 #  define nxsched_select_cpu(a)     (0)
 #endif
@@ -91,7 +91,11 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
   /* Otherwise, add the new task to the ready-to-run task list */
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  else if (nxsched_add_rtrbitmap(btcb))
+#else
   else if (nxsched_add_prioritized(btcb, list_readytorun()))
+#endif
     {
       /* The new btcb was added at the head of the ready-to-run list.  It
        * is now the new active task!
@@ -216,9 +220,26 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
        * Add the task to the ready-to-run (but not running) task list
        */
 
+#ifdef CONFIG_SCHED_PERCPU_READYTORUN
+      /* Queue the task on the CPU that it last ran on if its affinity
+       * permits, otherwise on the CPU that was selected above.  The task
+       * at the head of that list has a priority at least as high as btcb,
+       * so btcb can never become the head of the list here.
+       */
+
+      if (!CPU_ISSET(btcb->cpu, &btcb->affinity))
+        {
+          btcb->cpu = cpu;
+        }
+
+      nxsched_add_prioritized(btcb, list_assignedtasks(btcb->cpu));
+
+      btcb->task_state = TSTATE_TASK_ASSIGNED;
+#else
       nxsched_add_prioritized(btcb, list_readytorun());
 
       btcb->task_state = TSTATE_TASK_READYTORUN;
+#endif
       doswitch         = false;
     }
   else /* (task_state == TSTATE_TASK_RUNNING) */
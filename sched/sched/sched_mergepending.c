@@ -75,9 +75,11 @@
 bool nxsched_merge_pending(void)
 {
   FAR struct tcb_s *ptcb;
+#ifndef CONFIG_SCHED_READYTORUN_BITMAP
   FAR struct tcb_s *pnext;
-  FAR struct tcb_s *rtcb;
   FAR struct tcb_s *rprev;
+#endif
+  FAR struct tcb_s *rtcb;
   bool ret = false;
 
   /* Initialize the inner search loop */
@@ -91,6 +93,28 @@ bool nxsched_merge_pending(void)
 
   if (!nxsched_islocked_tcb(rtcb))
     {
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+      /* The priority index finds the insertion point directly, so just
+       * move the pending tasks one at a time.
+       */
+
+      while ((ptcb = (FAR struct tcb_s *)
+                     dq_remfirst(list_pendingtasks())) != NULL)
+        {
+          if (nxsched_add_rtrbitmap(ptcb))
+            {
+              rtcb->task_state  = TSTATE_TASK_READYTORUN;
+              ptcb->task_state  = TSTATE_TASK_RUNNING;
+              up_update_task(ptcb);
+              rtcb              = ptcb;
+              ret               = true;
+            }
+          else
+            {
+              ptcb->task_state  = TSTATE_TASK_READYTORUN;
+            }
+        }
+#else
       for (ptcb = (FAR struct tcb_s *)list_pendingtasks()->head;
            ptcb;
            ptcb = pnext)
@@ -157,6 +181,7 @@ bool nxsched_merge_pending(void)
 
       list_pendingtasks()->head = NULL;
       list_pendingtasks()->tail = NULL;
+#endif
     }
 
   return ret;
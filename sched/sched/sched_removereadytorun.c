@@ -93,7 +93,16 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
-  dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  if (tasklist == list_readytorun())
+    {
+      nxsched_remove_rtrbitmap(rtcb);
+    }
+  else
+#endif
+    {
+      dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+    }
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -112,6 +121,70 @@ void nxsched_remove_self(FAR struct tcb_s *tcb)
 }
 #endif /* !CONFIG_SMP */
 
+/****************************************************************************
+ * Name: nxsched_steal_task
+ *
+ * Description:
+ *   Select a ready-to-run task queued on another CPU that should run on
+ *   this CPU instead of the next local task.  The queued tasks of a CPU
+ *   follow its running task in the prioritized g_assignedtasks[] list, so
+ *   only the queued tasks with a higher priority than the best candidate
+ *   so far need to be looked at.  Usually that is one task per CPU, all of
+ *   them only if this CPU would otherwise go idle.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU that is looking for work
+ *   nxttcb - The next task in the assigned task list of this CPU
+ *
+ * Returned Value:
+ *   The highest priority task queued on another CPU whose affinity mask
+ *   includes this CPU, if its priority is higher than that of nxttcb.
+ *   NULL otherwise.  The TCB is still in the assigned task list of its
+ *   CPU.
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PERCPU_READYTORUN
+FAR struct tcb_s *nxsched_steal_task(int cpu, FAR struct tcb_s *nxttcb)
+{
+  FAR struct tcb_s *victim = NULL;
+  FAR struct tcb_s *rtrtcb;
+  uint8_t floor = nxttcb->sched_priority;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (i == cpu)
+        {
+          continue;
+        }
+
+      /* The list is prioritized, so stop at the first task that is not
+       * better than the best candidate so far.  The head of the list is
+       * the running task of that CPU, possibly its IDLE task.
+       */
+
+      for (rtrtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
+           !is_idle_task(rtrtcb) && rtrtcb->sched_priority > floor;
+           rtrtcb = rtrtcb->flink)
+        {
+          if (rtrtcb->task_state != TSTATE_TASK_RUNNING &&
+              CPU_ISSET(cpu, &rtrtcb->affinity))
+            {
+              victim = rtrtcb;
+              floor  = rtrtcb->sched_priority;
+              break;
+            }
+        }
+    }
+
+  return victim;
+}
+#endif
+
 /****************************************************************************
  * Name: nxsched_remove_readytorun
  *
@@ -190,6 +263,15 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
    * globally
    */
 
+#ifdef CONFIG_SCHED_PERCPU_READYTORUN
+  rtrtcb = nxsched_steal_task(cpu, nxttcb);
+  if (rtrtcb != NULL)
+    {
+      dq_rem_mid(rtrtcb);
+      rtrtcb->task_state = TSTATE_TASK_READYTORUN;
+      nxsched_add_prioritized(rtrtcb, &g_readytorun);
+    }
+#else
   for (int i = 0; i < CONFIG_SMP_NCPUS; i++)
     {
       if (i == cpu)
@@ -224,6 +306,7 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
             }
         }
     }
+#endif
 
   /* Which task will go at the head of the list?  It will be either the
    * next tcb in the assigned task list (nxttcb) or a TCB in the
@@ -0,0 +1,233 @@
+/****************************************************************************
+ * sched/sched/sched_rtrbitmap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RTR_NPRIORITIES  (SCHED_PRIORITY_MAX + 1)
+#define RTR_NWORDS       ((RTR_NPRIORITIES + 31) >> 5)
+
+#define RTR_ISSET(p)     ((g_rtrbitmap[(p) >> 5] & (1u << ((p) & 31))) != 0)
+#define RTR_SET(p)       (g_rtrbitmap[(p) >> 5] |= (1u << ((p) & 31)))
+#define RTR_CLR(p)       (g_rtrbitmap[(p) >> 5] &= ~(1u << ((p) & 31)))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The g_readytorun list is still a single list sorted by descending
+ * priority, but it is logically split into one FIFO per priority level.
+ * g_rtrtail[] holds the last TCB of each FIFO and g_rtrbitmap has a bit
+ * set for every priority level that has at least one TCB in the list.
+ */
+
+static uint32_t g_rtrbitmap[RTR_NWORDS];
+static FAR struct tcb_s *g_rtrtail[RTR_NPRIORITIES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_find_rtrpriority
+ *
+ * Description:
+ *   Return the lowest occupied priority level that is greater than or
+ *   equal to 'priority', or -1 if there is none.  The search visits at most
+ *   RTR_NWORDS words of the bitmap.
+ *
+ ****************************************************************************/
+
+static int nxsched_find_rtrpriority(int priority)
+{
+  int word = priority >> 5;
+  uint32_t bits;
+
+  bits = g_rtrbitmap[word] & (UINT32_MAX << (priority & 31));
+  while (bits == 0)
+    {
+      if (++word >= RTR_NWORDS)
+        {
+          return -1;
+        }
+
+      bits = g_rtrbitmap[word];
+    }
+
+  return (word << 5) + ffs((int)bits) - 1;
+}
+
+/****************************************************************************
+ * Name: nxsched_detach_rtrbitmap
+ *
+ * Description:
+ *   Remove the TCB from the priority index.  The TCB is not removed from
+ *   the g_readytorun list itself.
+ *
+ ****************************************************************************/
+
+static void nxsched_detach_rtrbitmap(FAR struct tcb_s *tcb)
+{
+  uint8_t priority = tcb->sched_priority;
+  FAR struct tcb_s *prev;
+
+  if (g_rtrtail[priority] == tcb)
+    {
+      prev = tcb->blink;
+      if (prev != NULL && prev->sched_priority == priority)
+        {
+          g_rtrtail[priority] = prev;
+        }
+      else
+        {
+          g_rtrtail[priority] = NULL;
+          RTR_CLR(priority);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_add_rtrbitmap
+ *
+ * Description:
+ *   Add a TCB to the g_readytorun list in constant time.  The TCB is placed
+ *   after all TCBs of the same or higher priority, exactly as
+ *   nxsched_add_prioritized() would place it.
+ *
+ * Input Parameters:
+ *   tcb - The TCB to add.  tcb->sched_priority may be that of the IDLE
+ *         task.
+ *
+ * Returned Value:
+ *   true if the TCB was added at the head of the g_readytorun list.
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+bool nxsched_add_rtrbitmap(FAR struct tcb_s *tcb)
+{
+  FAR dq_queue_t *list = list_readytorun();
+  uint8_t priority = tcb->sched_priority;
+  bool ret = false;
+  int prio;
+
+  prio = nxsched_find_rtrpriority(priority);
+  if (prio < 0)
+    {
+      /* No TCB of the same or higher priority, the TCB becomes the head */
+
+      dq_addfirst((FAR dq_entry_t *)tcb, list);
+      ret = true;
+    }
+  else
+    {
+      dq_addafter((FAR dq_entry_t *)g_rtrtail[prio],
+                  (FAR dq_entry_t *)tcb, list);
+    }
+
+  g_rtrtail[priority] = tcb;
+  RTR_SET(priority);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxsched_remove_rtrbitmap
+ *
+ * Description:
+ *   Remove a TCB from the g_readytorun list in constant time.
+ *
+ * Input Parameters:
+ *   tcb - The TCB to remove.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_remove_rtrbitmap(FAR struct tcb_s *tcb)
+{
+  nxsched_detach_rtrbitmap(tcb);
+  dq_rem((FAR dq_entry_t *)tcb, list_readytorun());
+}
+
+/****************************************************************************
+ * Name: nxsched_update_rtrbitmap
+ *
+ * Description:
+ *   Change the priority of the TCB at the head of the g_readytorun list
+ *   without moving it.  The caller must ensure that the new priority is
+ *   still greater than or equal to the priority of the next TCB.
+ *
+ * Input Parameters:
+ *   tcb      - The TCB at the head of the g_readytorun list.
+ *   priority - The new priority.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_update_rtrbitmap(FAR struct tcb_s *tcb, uint8_t priority)
+{
+  DEBUGASSERT(tcb->blink == NULL);
+  DEBUGASSERT(tcb->flink == NULL ||
+              ((FAR struct tcb_s *)tcb->flink)->sched_priority <= priority);
+
+  nxsched_detach_rtrbitmap(tcb);
+  tcb->sched_priority = priority;
+
+  /* The head is the last TCB of its priority only if no other TCB has
+   * the same priority.
+   */
+
+  if (!RTR_ISSET(priority))
+    {
+      g_rtrtail[priority] = tcb;
+      RTR_SET(priority);
+    }
+}
@@ -119,6 +119,16 @@ static FAR struct tcb_s *nxsched_nexttcb(FAR struct tcb_s *tcb)
 
   if (!nxsched_islocked_tcb(this_task()))
     {
+#ifdef CONFIG_SCHED_PERCPU_READYTORUN
+      /* A task queued on another CPU may have a higher priority */
+
+      rtrtcb = nxsched_steal_task(tcb->cpu, nxttcb);
+      if (rtrtcb != NULL)
+        {
+          nxttcb = rtrtcb;
+        }
+#endif
+
       /* Search for the highest priority task that can run on tcb->cpu. */
 
       for (rtrtcb = (FAR struct tcb_s *)list_readytorun()->head;
@@ -216,7 +226,11 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
           /* Change the task priority */
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+          nxsched_update_rtrbitmap(tcb, (uint8_t)sched_priority);
+#else
           tcb->sched_priority = (uint8_t)sched_priority;
+#endif
         }
       else
         {
@@ -262,7 +276,11 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
     {
       /* Change the task priority */
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+      nxsched_update_rtrbitmap(tcb, (uint8_t)sched_priority);
+#else
       tcb->sched_priority = (uint8_t)sched_priority;
+#endif
     }
 }
 
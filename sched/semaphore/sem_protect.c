@@ -76,7 +76,11 @@ int nxsem_protect_wait(FAR sem_t *sem)
         }
 
       sem->saved = rtcb->sched_priority;
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+      nxsched_update_rtrbitmap(rtcb, sem->ceiling);
+#else
       rtcb->sched_priority = sem->ceiling;
+#endif
     }
 
   return OK;
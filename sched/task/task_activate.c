@@ -86,6 +86,14 @@ void nxtask_activate(FAR struct tcb_s *tcb)
 
   nxsched_remove_blocked(tcb);
 
+#ifdef CONFIG_SCHED_PERCPU_READYTORUN
+  /* A new task has not run on any CPU yet, queue it on the CPU that runs
+   * the lowest priority task rather than on CPU0.
+   */
+
+  tcb->cpu = nxsched_select_cpu(tcb->affinity);
+#endif
+
   sinfo("%s pid=%d,TCB=%p\n", get_task_name(tcb),
         tcb->pid, tcb);
 
@@ -80,7 +80,15 @@ int wd_cancel(FAR struct wdog_s *wdog)
    * cancellation is complete
    */
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* The wheel does not know which watchdog expires first.  Leaving the
+   * timer armed only costs one spurious timer event.
+   */
+
+  head = false;
+#else
   head = list_is_head(&g_wdactivelist, &wdog->node);
+#endif
 
   /* Now, remove the watchdog from the timer queue */
 
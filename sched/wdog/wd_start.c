@@ -129,6 +129,14 @@ static inline_function void wd_expiration(clock_t ticks)
   g_wdtimernested++;
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Process all watchdogs in the wheel that became ready to run at this
+   * time.  wd_wheel_pop() removes them from the wheel.
+   */
+
+  while ((wdog = wd_wheel_pop(ticks)) != NULL)
+    {
+#else
   /* Process the watchdog at the head of the list as well as any
    * other watchdogs that became ready to run at this time
    */
@@ -147,6 +155,7 @@ static inline_function void wd_expiration(clock_t ticks)
       /* Remove the watchdog from the head of the list */
 
       list_delete(&wdog->node);
+#endif
 
       /* Indicate that the watchdog is no longer active. */
 
@@ -194,6 +203,21 @@ static inline_function void wd_expiration(clock_t ticks)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+static inline_function
+bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
+               wdentry_t wdentry, wdparm_t arg)
+{
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+  wdog->expired = expired;
+
+  /* Return whether the next timer event has become earlier. */
+
+  return wd_wheel_insert(wdog);
+}
+#else
 static inline_function
 bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
@@ -233,6 +257,7 @@ bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
 
   return head == curr;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -298,7 +323,9 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
   if (WDOG_ISACTIVE(wdog))
     {
+#ifndef CONFIG_WDOG_TIMERWHEEL
       reassess |= list_is_head(&g_wdactivelist, &wdog->node);
+#endif
       list_delete(&wdog->node);
       wdog->func = NULL;
     }
@@ -416,7 +443,11 @@ int wd_start(FAR struct wdog_s *wdog, clock_t delay,
 #ifdef CONFIG_SCHED_TICKLESS
 clock_t wd_timer(clock_t ticks, bool noswitches)
 {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  clock_t next;
+#else
   FAR struct wdog_s *wdog;
+#endif
   irqstate_t flags;
   sclock_t ret;
 
@@ -431,6 +462,19 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
 
   /* Return the delay for the next watchdog to expire */
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* The next wheel event may be a cascade of a higher level slot rather
+   * than an expiration.  That only costs an extra timer interrupt.
+   */
+
+  if (!wd_wheel_next(&next))
+    {
+      spin_unlock_irqrestore(&g_wdspinlock, flags);
+      return 0;
+    }
+
+  ret = next - ticks;
+#else
   if (list_is_empty(&g_wdactivelist))
     {
       spin_unlock_irqrestore(&g_wdspinlock, flags);
@@ -443,6 +487,7 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
 
   wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
   ret = wdog->expired - ticks;
+#endif
 
   spin_unlock_irqrestore(&g_wdspinlock, flags);
 
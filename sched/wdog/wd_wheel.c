@@ -0,0 +1,396 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each level of the wheel has 64 slots so that the occupied slots of a
+ * level can be kept in one 64-bit bitmap.  Level n covers delays up to
+ * 64^(n+1) ticks with a resolution of 64^n ticks.
+ */
+
+#define WHEEL_BITS          6
+#define WHEEL_SLOTS         (1 << WHEEL_BITS)
+#define WHEEL_MASK          (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS        CONFIG_WDOG_TIMERWHEEL_LEVELS
+
+#define WHEEL_SHIFT(l)      ((l) * WHEEL_BITS)
+#define WHEEL_SPAN(l)       ((clock_t)1 << WHEEL_SHIFT(l))
+#define WHEEL_INDEX(t, l)   ((unsigned int)((t) >> WHEEL_SHIFT(l)) & WHEEL_MASK)
+#define WHEEL_RANGE         WHEEL_SPAN(WHEEL_LEVELS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct wd_wheel_s
+{
+  /* All watchdogs that expire before base have been dispatched */
+
+  clock_t          base;
+
+  /* A bit is set in occupied[] if the corresponding slot may hold
+   * watchdogs.  The slot list head is only valid while its bit is set.
+   * Bits are cleared lazily because wd_cancel() removes watchdogs without
+   * knowing their slot.
+   */
+
+  uint64_t         occupied[WHEEL_LEVELS];
+  struct list_node slot[WHEEL_LEVELS][WHEEL_SLOTS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct wd_wheel_s g_wdwheel;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Add a watchdog to the slot covering its expiration time relative to
+ *   the current wheel position.  Watchdogs that are already due go to the
+ *   current slot of level 0 and watchdogs beyond the range of the wheel
+ *   are parked in the last slot of the highest level; they are re-filed
+ *   when that slot is cascaded.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_add(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *slot;
+  clock_t when = wdog->expired;
+  sclock_t delta = when - g_wdwheel.base;
+  unsigned int index;
+  int level;
+
+  if (delta < 0)
+    {
+      when  = g_wdwheel.base;
+      delta = 0;
+    }
+  else if (delta >= (sclock_t)WHEEL_RANGE)
+    {
+      when  = g_wdwheel.base + WHEEL_RANGE - 1;
+      delta = WHEEL_RANGE - 1;
+    }
+
+  for (level = 0;
+       level < WHEEL_LEVELS - 1 && delta >= (sclock_t)WHEEL_SPAN(level + 1);
+       level++);
+
+  index = WHEEL_INDEX(when, level);
+  slot  = &g_wdwheel.slot[level][index];
+
+  if ((g_wdwheel.occupied[level] & ((uint64_t)1 << index)) == 0)
+    {
+      list_initialize(slot);
+      g_wdwheel.occupied[level] |= (uint64_t)1 << index;
+    }
+
+  list_add_tail(slot, &wdog->node);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_slot
+ *
+ * Description:
+ *   Return the slot list if the slot is occupied, otherwise NULL.  A slot
+ *   that was emptied by wd_cancel() is marked free here.
+ *
+ ****************************************************************************/
+
+static FAR struct list_node *wd_wheel_slot(int level, unsigned int index)
+{
+  FAR struct list_node *slot = &g_wdwheel.slot[level][index];
+  uint64_t bit = (uint64_t)1 << index;
+
+  if ((g_wdwheel.occupied[level] & bit) == 0)
+    {
+      return NULL;
+    }
+
+  if (list_is_empty(slot))
+    {
+      g_wdwheel.occupied[level] &= ~bit;
+      return NULL;
+    }
+
+  return slot;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_distance
+ *
+ * Description:
+ *   Return the distance (in slots) from 'start' to the next occupied slot
+ *   of the level, wrapping around the level, or -1 if the level is empty.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_distance(int level, unsigned int start)
+{
+  unsigned int rot = start & WHEEL_MASK;
+  uint64_t bits;
+  int distance;
+
+  for (; ; )
+    {
+      bits = g_wdwheel.occupied[level];
+      if (bits == 0)
+        {
+          return -1;
+        }
+
+      if (rot != 0)
+        {
+          bits = (bits >> rot) | (bits << (WHEEL_SLOTS - rot));
+        }
+
+      distance = ffsll(bits) - 1;
+      if (wd_wheel_slot(level, (rot + distance) & WHEEL_MASK) != NULL)
+        {
+          return distance;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Move the wheel to 'base' and cascade every slot whose interval starts
+ *   at 'base' down to the lower levels.  The caller guarantees that no
+ *   occupied slot was skipped.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_advance(clock_t base)
+{
+  FAR struct list_node *slot;
+  FAR struct wdog_s *wdog;
+  int level;
+
+  g_wdwheel.base = base;
+
+  /* Cascade from the top so that watchdogs moved down one level are
+   * cascaded again if their new slot also starts at 'base'.
+   */
+
+  for (level = WHEEL_LEVELS - 1; level > 0; level--)
+    {
+      if ((base & (WHEEL_SPAN(level) - 1)) != 0)
+        {
+          continue;
+        }
+
+      slot = wd_wheel_slot(level, WHEEL_INDEX(base, level));
+      if (slot == NULL)
+        {
+          continue;
+        }
+
+      g_wdwheel.occupied[level] &= ~((uint64_t)1 << WHEEL_INDEX(base, level));
+      while (!list_is_empty(slot))
+        {
+          wdog = list_first_entry(slot, struct wdog_s, node);
+          list_delete(&wdog->node);
+          wd_wheel_add(wdog);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the tick at which the wheel next needs service: either the
+ *   expiration time of the earliest level 0 slot or the time at which a
+ *   higher level slot must be cascaded.  The result is never later than
+ *   the earliest watchdog expiration time.
+ *
+ * Input Parameters:
+ *   next - Location to return the tick.
+ *
+ * Returned Value:
+ *   false if there are no active watchdogs.
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next)
+{
+  clock_t base = g_wdwheel.base;
+  bool found = false;
+  clock_t upper;
+  clock_t when;
+  unsigned int start;
+  int distance;
+  int level;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      /* The current slot of a higher level has already been cascaded,
+       * anything in it belongs to the next revolution of that level.
+       */
+
+      start = WHEEL_INDEX(base, level) + (level > 0);
+      distance = wd_wheel_distance(level, start);
+      if (distance < 0)
+        {
+          continue;
+        }
+
+      upper = base & ~(WHEEL_SPAN(level + 1) - 1);
+      when  = upper + ((clock_t)(start + distance) << WHEEL_SHIFT(level));
+
+      if (!found || (sclock_t)(when - *next) < 0)
+        {
+          *next = when;
+          found = true;
+        }
+    }
+
+  return found;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add an armed watchdog (wdog->expired is valid) to the wheel.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to add.
+ *
+ * Returned Value:
+ *   true if the time of the next wheel event became earlier, i.e. the
+ *   timer needs to be reassessed in tickless mode.
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  clock_t next;
+  bool reassess;
+
+  if (wd_wheel_next(&next))
+    {
+      reassess = !clock_compare(next, wdog->expired);
+    }
+  else
+    {
+      /* The wheel is empty so it may have fallen far behind the current
+       * time (e.g. after a long tickless sleep).  Catch up first, otherwise
+       * the new expiration time could look like it was in the past.  All
+       * slots are empty, so nothing needs to be cascaded.
+       */
+
+      g_wdwheel.base = clock_systime_ticks();
+      reassess = true;
+    }
+
+  wd_wheel_add(wdog);
+  return reassess;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_pop
+ *
+ * Description:
+ *   Remove and return one watchdog that has expired at 'ticks', advancing
+ *   the wheel (and cascading higher levels) as needed.  Empty stretches of
+ *   the wheel are skipped using the slot bitmaps, so the cost does not
+ *   depend on the number of elapsed ticks.
+ *
+ * Input Parameters:
+ *   ticks - The current time.
+ *
+ * Returned Value:
+ *   An expired watchdog or NULL if there is none.
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_pop(clock_t ticks)
+{
+  FAR struct list_node *slot;
+  FAR struct wdog_s *wdog;
+  clock_t next;
+
+  while (clock_compare(g_wdwheel.base, ticks))
+    {
+      slot = wd_wheel_slot(0, WHEEL_INDEX(g_wdwheel.base, 0));
+      if (slot != NULL)
+        {
+          wdog = list_first_entry(slot, struct wdog_s, node);
+          list_delete(&wdog->node);
+          return wdog;
+        }
+
+      /* Nothing is left at the current tick, skip to the next event */
+
+      if (wd_wheel_next(&next) && clock_compare(next, ticks))
+        {
+          wd_wheel_advance(next);
+        }
+      else
+        {
+          wd_wheel_advance(ticks + 1);
+        }
+    }
+
+  return NULL;
+}
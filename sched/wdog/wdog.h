@@ -125,6 +125,24 @@ void wd_timer(clock_t ticks);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: wd_wheel_insert, wd_wheel_pop, wd_wheel_next
+ *
+ * Description:
+ *   Hierarchical timer wheel used instead of g_wdactivelist if
+ *   CONFIG_WDOG_TIMERWHEEL is selected.  See sched/wdog/wd_wheel.c.
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+bool wd_wheel_insert(FAR struct wdog_s *wdog);
+FAR struct wdog_s *wd_wheel_pop(clock_t ticks);
+bool wd_wheel_next(FAR clock_t *next);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
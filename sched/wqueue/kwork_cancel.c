@@ -132,7 +132,7 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
 
 int work_cancel(int qid, FAR struct work_s *work)
 {
-  return work_qcancel(work_qid2wq(qid), false, work);
+  return work_qcancel(work_get_wqueue(qid, work), false, work);
 }
 
 int work_cancel_wq(FAR struct kwork_wqueue_s *wqueue,
@@ -165,7 +165,7 @@ int work_cancel_wq(FAR struct kwork_wqueue_s *wqueue,
 
 int work_cancel_sync(int qid, FAR struct work_s *work)
 {
-  return work_qcancel(work_qid2wq(qid), true, work);
+  return work_qcancel(work_get_wqueue(qid, work), true, work);
 }
 
 int work_cancel_sync_wq(FAR struct kwork_wqueue_s *wqueue,
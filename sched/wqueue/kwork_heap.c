@@ -0,0 +1,268 @@
+/****************************************************************************
+ * sched/wqueue/kwork_heap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_WORKQUEUE_HEAP
+
+/* The pending work of a work queue is kept in an intrusive pairing heap
+ * ordered by the expiration time.  Each node has a pointer to its first
+ * child, to its next sibling and to either its parent (if it is the first
+ * child) or its previous sibling.  The root has neither a parent nor
+ * siblings.
+ */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_heap_link
+ *
+ * Description:
+ *   Link two heap roots together.  The root that expires later becomes
+ *   the first child of the other one.  On equal expiration times, the
+ *   first root wins so that re-queuing does not bypass older work.
+ *
+ * Input Parameters:
+ *   a - The first root, must not be NULL.
+ *   b - The second root, must not be NULL.
+ *
+ * Returned Value:
+ *   The new root.
+ *
+ ****************************************************************************/
+
+static FAR struct work_s *work_heap_link(FAR struct work_s *a,
+                                         FAR struct work_s *b)
+{
+  FAR struct work_s *tmp;
+
+  if (!clock_compare(a->qtime, b->qtime))
+    {
+      tmp = a;
+      a   = b;
+      b   = tmp;
+    }
+
+  b->hprev = a;
+  b->hnext = a->hchild;
+  if (a->hchild != NULL)
+    {
+      a->hchild->hprev = b;
+    }
+
+  a->hchild = b;
+  return a;
+}
+
+/****************************************************************************
+ * Name: work_heap_merge
+ *
+ * Description:
+ *   Merge a list of siblings into one heap using the standard two-pass
+ *   pairing:  Link the siblings in pairs from left to right, then link
+ *   the resulting heaps from right to left.
+ *
+ * Input Parameters:
+ *   first - The first sibling, may be NULL.
+ *
+ * Returned Value:
+ *   The root of the merged heap or NULL if the list was empty.
+ *
+ ****************************************************************************/
+
+static FAR struct work_s *work_heap_merge(FAR struct work_s *first)
+{
+  FAR struct work_s *pairs = NULL;
+  FAR struct work_s *root;
+  FAR struct work_s *next;
+  FAR struct work_s *a;
+  FAR struct work_s *b;
+
+  /* First pass:  Link the siblings in pairs and push the resulting heaps
+   * onto the list of pairs in reverse order.
+   */
+
+  while (first != NULL)
+    {
+      a = first;
+      b = a->hnext;
+      next = b != NULL ? b->hnext : NULL;
+
+      a->hnext = NULL;
+      a->hprev = NULL;
+
+      if (b != NULL)
+        {
+          b->hnext = NULL;
+          b->hprev = NULL;
+          a = work_heap_link(a, b);
+        }
+
+      a->hnext = pairs;
+      pairs    = a;
+      first    = next;
+    }
+
+  if (pairs == NULL)
+    {
+      return NULL;
+    }
+
+  /* Second pass:  Link the pairs from right to left into one heap. */
+
+  root        = pairs;
+  pairs       = root->hnext;
+  root->hnext = NULL;
+
+  while (pairs != NULL)
+    {
+      next         = pairs->hnext;
+      pairs->hnext = NULL;
+      root         = work_heap_link(root, pairs);
+      pairs        = next;
+    }
+
+  return root;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_heap_insert
+ *
+ * Description:
+ *   Insert the work into the pending heap of the work queue.  The caller
+ *   must hold the work queue lock.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *   work   - The work to be inserted.
+ *
+ * Returned Value:
+ *   Return whether the work became the earliest pending work.
+ *
+ ****************************************************************************/
+
+bool work_heap_insert(FAR struct kwork_wqueue_s *wqueue,
+                      FAR struct work_s *work)
+{
+  DEBUGASSERT(wqueue != NULL && work != NULL);
+
+  work->hchild = NULL;
+  work->hnext  = NULL;
+  work->hprev  = NULL;
+
+  if (wqueue->pending == NULL)
+    {
+      wqueue->pending = work;
+    }
+  else
+    {
+      wqueue->pending = work_heap_link(wqueue->pending, work);
+    }
+
+  return wqueue->pending == work;
+}
+
+/****************************************************************************
+ * Name: work_heap_remove
+ *
+ * Description:
+ *   Remove the work from the pending heap of the work queue.  The work
+ *   must be in the heap and the caller must hold the work queue lock.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *   work   - The work to be removed.
+ *
+ * Returned Value:
+ *   Return whether the earliest pending work has changed.
+ *
+ ****************************************************************************/
+
+bool work_heap_remove(FAR struct kwork_wqueue_s *wqueue,
+                      FAR struct work_s *work)
+{
+  FAR struct work_s *subheap;
+  bool head = wqueue->pending == work;
+
+  DEBUGASSERT(head || work->hprev != NULL);
+
+  if (head)
+    {
+      wqueue->pending = work_heap_merge(work->hchild);
+    }
+  else
+    {
+      /* Unlink the subtree rooted at the work from its parent or from its
+       * previous sibling.
+       */
+
+      if (work->hprev->hchild == work)
+        {
+          work->hprev->hchild = work->hnext;
+        }
+      else
+        {
+          work->hprev->hnext = work->hnext;
+        }
+
+      if (work->hnext != NULL)
+        {
+          work->hnext->hprev = work->hprev;
+        }
+
+      /* Then merge the children of the work back into the heap.  The root
+       * cannot change since all children expire no earlier than the work.
+       */
+
+      subheap = work_heap_merge(work->hchild);
+      if (subheap != NULL)
+        {
+          wqueue->pending = work_heap_link(wqueue->pending, subheap);
+        }
+    }
+
+  work->hchild = NULL;
+  work->hnext  = NULL;
+  work->hprev  = NULL;
+
+  return head;
+}
+
+#endif /* CONFIG_SCHED_WORKQUEUE_HEAP */
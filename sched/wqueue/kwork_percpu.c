@@ -0,0 +1,303 @@
+/****************************************************************************
+ * sched/wqueue/kwork_percpu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <stdio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/list.h>
+#include <nuttx/sched.h>
+#include <nuttx/wqueue.h>
+
+#include "sched/sched.h"
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+/* The per-CPU, high priority work queues */
+
+static FAR struct kwork_wqueue_s *g_hpwork_percpu[CONFIG_SMP_NCPUS];
+#endif
+
+#ifdef CONFIG_SCHED_LPWORK
+/* The per-CPU, low priority work queues */
+
+static FAR struct kwork_wqueue_s *g_lpwork_percpu[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_cpu2wq
+ *
+ * Description:
+ *   Get the per-CPU work queue of the given queue ID and CPU.
+ *
+ * Input Parameters:
+ *   qid - The work queue ID
+ *   cpu - The CPU index
+ *
+ * Returned Value:
+ *   The per-CPU work queue or NULL if it is not running.
+ *
+ ****************************************************************************/
+
+static FAR struct kwork_wqueue_s *work_cpu2wq(int qid, int cpu)
+{
+#ifdef CONFIG_SCHED_HPWORK
+  if (qid == HPWORK)
+    {
+      return g_hpwork_percpu[cpu];
+    }
+  else
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+  if (qid == LPWORK)
+    {
+      return g_lpwork_percpu[cpu];
+    }
+  else
+#endif
+    {
+      return NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: work_percpu_create
+ *
+ * Description:
+ *   Create one work queue per CPU and pin its worker thread to that CPU.
+ *
+ * Input Parameters:
+ *   name       - The name prefix of the worker threads
+ *   priority   - Priority of the worker threads
+ *   stack_size - Size (in bytes) of the worker thread stacks
+ *   wqueues    - The array that receives the per-CPU work queues
+ *
+ * Returned Value:
+ *   Return zero (OK) on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static int work_percpu_create(FAR const char *name, int priority,
+                              int stack_size,
+                              FAR struct kwork_wqueue_s **wqueues)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  FAR struct kworker_s *worker;
+  char thname[CONFIG_TASK_NAME_SIZE + 1];
+  cpu_set_t cpuset;
+  int ret;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      snprintf(thname, sizeof(thname), "%s%d", name, cpu);
+
+      wqueue = work_queue_create(thname, priority, NULL, stack_size, 1);
+      if (wqueue == NULL)
+        {
+          serr("ERROR: Failed to create %s\n", thname);
+          return -ENOMEM;
+        }
+
+      /* Pin the worker thread to the CPU */
+
+      worker = wq_get_worker(wqueue);
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+
+      ret = nxsched_set_affinity(worker[0].pid, sizeof(cpu_set_t), &cpuset);
+      if (ret < 0)
+        {
+          serr("ERROR: Failed to pin %s: %d\n", thname, ret);
+          work_queue_free(wqueue);
+          return ret;
+        }
+
+      /* The queue becomes visible to work_queue_cpu() only now.  Until
+       * then, work for this CPU goes to the global queue.
+       */
+
+      wqueues[cpu] = wqueue;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue work on the per-CPU work queue of the given CPU.  The work is
+ *   performed by a worker thread pinned to that CPU.  If the per-CPU queue
+ *   is not running or already has a backlog of expired work, the work is
+ *   queued on the global work queue instead.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   cpu    - The CPU to run the work on, or a negative value to select the
+ *            calling CPU.
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, clock_t delay)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+
+  if (cpu < 0)
+    {
+      cpu = this_cpu();
+    }
+  else if (cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  wqueue = work_cpu2wq(qid, cpu);
+
+  /* Fall back to the global queue if the per-CPU queue is not running yet
+   * or if its worker thread is lagging behind.  The check of the expired
+   * queue is only a hint, so it is done without taking the queue lock.
+   */
+
+  if (wqueue == NULL || (delay == 0 && !list_is_empty(&wqueue->expired)))
+    {
+      wqueue = work_qid2wq(qid);
+    }
+
+  return work_queue_wq(wqueue, work, worker, arg, delay);
+}
+
+/****************************************************************************
+ * Name: work_queue_stats_cpu
+ *
+ * Description:
+ *   Get a snapshot of the statistics of the per-CPU work queue of the given
+ *   CPU.
+ *
+ * Input Parameters:
+ *   qid   - The work queue ID (must be HPWORK or LPWORK)
+ *   cpu   - The CPU index
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure.  -ENODEV is returned if
+ *   the per-CPU queue is not running.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+int work_queue_stats_cpu(int qid, int cpu, FAR struct work_stats_s *stats)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  wqueue = work_cpu2wq(qid, cpu);
+  if (wqueue == NULL)
+    {
+      return -ENODEV;
+    }
+
+  return work_queue_stats_wq(wqueue, stats);
+}
+#endif
+
+/****************************************************************************
+ * Name: work_start_percpu
+ *
+ * Description:
+ *   Start the per-CPU, kernel-mode work queues.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Return zero (OK) on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int work_start_percpu(void)
+{
+  int ret = OK;
+
+#ifdef CONFIG_SCHED_HPWORK
+  sinfo("Starting per-CPU high-priority kernel worker thread(s)\n");
+
+  ret = work_percpu_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
+                           CONFIG_SCHED_HPWORKSTACKSIZE, g_hpwork_percpu);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
+#ifdef CONFIG_SCHED_LPWORK
+  sinfo("Starting per-CPU low-priority kernel worker thread(s)\n");
+
+  ret = work_percpu_create(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY,
+                           CONFIG_SCHED_LPWORKSTACKSIZE, g_lpwork_percpu);
+#endif
+
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_WORKQUEUE_PERCPU */
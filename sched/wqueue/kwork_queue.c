@@ -84,6 +84,9 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
   work->worker = worker; /* Work callback. non-NULL means queued */
   work->arg    = arg;    /* Callback argument */
   work->qtime += delay;  /* Expected time based on last expiration time */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  work->wq     = wqueue; /* The queue the work is queued to */
+#endif
 
   flags = spin_lock_irqsave(&wqueue->lock);
 
@@ -103,7 +106,7 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
     {
       /* Insert to the expired list of the wqueue. */
 
-      list_add_tail(&wqueue->expired, &work->node);
+      work_insert_expired(wqueue, work);
     }
 
   spin_unlock_irqrestore(&wqueue->lock, flags);
@@ -170,6 +173,18 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
 
   expected = clock_delay2abstick(delay);
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  /* The work may still be queued to another work queue, e.g. to a per-CPU
+   * queue when it is now queued to the global one.  Remove it from there
+   * first.
+   */
+
+  if (work->wq != NULL && work->wq != wqueue)
+    {
+      work_cancel_wq(work->wq, work);
+    }
+#endif
+
   /* Interrupts are disabled so that this logic can be called from with
    * task logic or from interrupt handling logic.
    */
@@ -185,6 +200,9 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
   work->worker = worker;   /* Work callback. non-NULL means queued */
   work->arg    = arg;      /* Callback argument */
   work->qtime  = expected; /* Expected time */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  work->wq     = wqueue;   /* The queue the work is queued to */
+#endif
 
   if (delay)
     {
@@ -203,7 +221,7 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
     {
       /* Insert to the expired list of the wqueue. */
 
-      list_add_tail(&wqueue->expired, &work->node);
+      work_insert_expired(wqueue, work);
     }
 
   if (retimer)
@@ -85,7 +85,7 @@ struct hp_wqueue_s g_hpwork =
 {
   {
     LIST_INITIAL_VALUE(g_hpwork.wq.expired),
-    LIST_INITIAL_VALUE(g_hpwork.wq.pending),
+    WQUEUE_PENDING_INITIALIZER(g_hpwork.wq.pending),
     SEM_INITIALIZER(0),
     SEM_INITIALIZER(0),
     SP_UNLOCKED,
@@ -102,7 +102,7 @@ struct lp_wqueue_s g_lpwork =
 {
   {
     LIST_INITIAL_VALUE(g_lpwork.wq.expired),
-    LIST_INITIAL_VALUE(g_lpwork.wq.pending),
+    WQUEUE_PENDING_INITIALIZER(g_lpwork.wq.pending),
     SEM_INITIALIZER(0),
     SEM_INITIALIZER(0),
     SP_UNLOCKED,
@@ -120,7 +120,6 @@ static inline_function
 void work_dispatch(FAR struct kwork_wqueue_s *wq)
 {
   FAR struct work_s *work;
-  FAR struct work_s *next;
   unsigned int count = 0;
   clock_t      ticks = clock_systime_ticks();
 
@@ -133,7 +132,7 @@ void work_dispatch(FAR struct kwork_wqueue_s *wq)
    * In this case we should not wake up any worker thread.
    */
 
-  list_for_every_entry_safe(&wq->pending, work, next, struct work_s, node)
+  while ((work = work_peek_pending(wq)) != NULL)
     {
       /* Check whether the work has expired. */
 
@@ -146,7 +145,7 @@ void work_dispatch(FAR struct kwork_wqueue_s *wq)
 
       /* Expired work will be moved to tail of the expired queue. */
 
-      list_delete(&work->node);
+      work_remove_pending(wq, work);
       list_add_tail(&wq->expired, &work->node);
 
       /* Note that the thread execution this function is also
@@ -191,6 +190,9 @@ static int work_thread(int argc, FAR char *argv[])
   worker_t      worker;
   irqstate_t    flags;
   FAR void     *arg;
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  clock_t       now;
+#endif
 
   /* Get the handle from argv */
 
@@ -228,6 +230,18 @@ static int work_thread(int argc, FAR char *argv[])
           work = list_first_entry(&wqueue->expired, struct work_s, node);
 
           list_delete(&work->node);
+          work_stats_dequeue(wqueue);
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          /* Record how late the work is dispatched */
+
+          now = clock_systime_ticks();
+          if (clock_compare(work->qtime, now) &&
+              now - work->qtime > wqueue->stats.maxlag)
+            {
+              wqueue->stats.maxlag = now - work->qtime;
+            }
+#endif
 
           /* Extract the work description from the entry (in case the
            * work instance will be reused after it has been de-queued).
@@ -254,10 +268,28 @@ static int work_thread(int argc, FAR char *argv[])
            * performed... we don't have any idea how long this will take!
            */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          now = perf_gettime();
+          CALL_WORKER(worker, arg);
+          now = perf_gettime() - now;
+#else
           CALL_WORKER(worker, arg);
+#endif
           flags = spin_lock_irqsave(&wqueue->lock);
           sched_lock();
 
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          /* Account the execution time of the work */
+
+          wqueue->stats.ndispatch++;
+          wqueue->stats.totalexec += now;
+          if (now > wqueue->stats.maxexec)
+            {
+              wqueue->stats.maxexec   = now;
+              wqueue->stats.maxworker = worker;
+            }
+#endif
+
           /* Mark the thread un-busy */
 
           kworker->work = NULL;
@@ -419,7 +451,9 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
   /* Initialize the work queue structure */
 
   list_initialize(&wqueue->expired);
+#ifndef CONFIG_SCHED_WORKQUEUE_HEAP
   list_initialize(&wqueue->pending);
+#endif
   wqueue->timer.func = NULL;
   nxsem_init(&wqueue->sem, 0, 0);
   nxsem_init(&wqueue->exsem, 0, 0);
@@ -532,6 +566,45 @@ int work_queue_priority(int qid)
   return work_queue_priority_wq(work_qid2wq(qid));
 }
 
+/****************************************************************************
+ * Name: work_queue_stats_wq
+ *
+ * Description:
+ *   Get a snapshot of the statistics of the work queue.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue handle
+ *   stats  - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+int work_queue_stats_wq(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_stats_s *stats)
+{
+  irqstate_t flags;
+
+  if (wqueue == NULL || stats == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave(&wqueue->lock);
+  *stats = wqueue->stats;
+  spin_unlock_irqrestore(&wqueue->lock, flags);
+
+  return OK;
+}
+
+int work_queue_stats(int qid, FAR struct work_stats_s *stats)
+{
+  return work_queue_stats_wq(work_qid2wq(qid), stats);
+}
+#endif
+
 /****************************************************************************
  * Name: work_start_highpri
  *
@@ -55,6 +55,32 @@
 #define wq_get_worker(wq) \
   (FAR struct kworker_s *)((FAR char *)(wq) + sizeof(struct kwork_wqueue_s))
 
+/* Static initializer of the pending work of a work queue */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_HEAP
+#  define WQUEUE_PENDING_INITIALIZER(pending) NULL
+#else
+#  define WQUEUE_PENDING_INITIALIZER(pending) LIST_INITIAL_VALUE(pending)
+#endif
+
+/* Track the number of work queued in the work queue */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+#  define work_stats_enqueue(wq) \
+     do \
+       { \
+         if (++(wq)->stats.depth > (wq)->stats.maxdepth) \
+           { \
+             (wq)->stats.maxdepth = (wq)->stats.depth; \
+           } \
+       } \
+     while (0)
+#  define work_stats_dequeue(wq) ((wq)->stats.depth--)
+#else
+#  define work_stats_enqueue(wq)
+#  define work_stats_dequeue(wq)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -74,13 +100,20 @@ struct kworker_s
 struct kwork_wqueue_s
 {
   struct list_node expired;   /* The queue of expired work. */
+#ifdef CONFIG_SCHED_WORKQUEUE_HEAP
+  FAR struct work_s *pending; /* The heap of pending work. */
+#else
   struct list_node pending;   /* The queue of pending work. */
+#endif
   sem_t            sem;       /* The counting semaphore of the wqueue */
   sem_t            exsem;     /* Sync waiting for thread exit */
   spinlock_t       lock;      /* Spinlock */
   uint8_t          nthreads;  /* Number of worker threads */
   bool             exit;      /* A flag to request the thread to exit */
   struct wdog_s    timer;     /* Timer to pending. */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  struct work_stats_s stats;  /* Statistics of the work queue */
+#endif
 };
 
 /* This structure defines the state of one high-priority work queue.  This
@@ -154,6 +187,76 @@ static inline_function FAR struct kwork_wqueue_s *work_qid2wq(int qid)
     }
 }
 
+/****************************************************************************
+ * Name: work_get_wqueue
+ *
+ * Description:
+ *   Get the work queue that a work should be cancelled from.  With per-CPU
+ *   work queues, this is the queue that the work was last queued to rather
+ *   than the global queue identified by qid.
+ *
+ * Input Parameters:
+ *   qid  - The work queue ID.
+ *   work - The work.
+ *
+ * Returned Value:
+ *   The work queue or NULL if the qid is invalid.
+ *
+ ****************************************************************************/
+
+static inline_function
+FAR struct kwork_wqueue_s *work_get_wqueue(int qid, FAR struct work_s *work)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  if (work != NULL && work->wq != NULL)
+    {
+      return work->wq;
+    }
+#endif
+
+  return work_qid2wq(qid);
+}
+
+/****************************************************************************
+ * Name: work_heap_insert
+ *
+ * Description:
+ *   Insert the work into the pending heap of the work queue.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *   work   - The work to be inserted.
+ *
+ * Returned Value:
+ *   Return whether the work became the earliest pending work.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_HEAP
+bool work_heap_insert(FAR struct kwork_wqueue_s *wqueue,
+                      FAR struct work_s *work);
+#endif
+
+/****************************************************************************
+ * Name: work_heap_remove
+ *
+ * Description:
+ *   Remove the work from the pending heap of the work queue.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *   work   - The work to be removed.
+ *
+ * Returned Value:
+ *   Return whether the earliest pending work has changed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_HEAP
+bool work_heap_remove(FAR struct kwork_wqueue_s *wqueue,
+                      FAR struct work_s *work);
+#endif
+
 /****************************************************************************
  * Name: work_insert_pending
  *
@@ -174,11 +277,17 @@ static inline_function
 bool work_insert_pending(FAR struct kwork_wqueue_s *wqueue,
                          FAR struct work_s         *work)
 {
+#ifdef CONFIG_SCHED_WORKQUEUE_HEAP
+  work_stats_enqueue(wqueue);
+  return work_heap_insert(wqueue, work);
+#else
   FAR struct work_s *curr;
   FAR struct work_s *head;
 
   DEBUGASSERT(wqueue != NULL && work != NULL);
 
+  work_stats_enqueue(wqueue);
+
   /* Insert the work into the wait queue sorted by the expired time. */
 
   head = list_first_entry(&wqueue->pending, struct work_s, node);
@@ -207,6 +316,101 @@ bool work_insert_pending(FAR struct kwork_wqueue_s *wqueue,
    */
 
   return curr == head;
+#endif
+}
+
+/****************************************************************************
+ * Name: work_insert_expired
+ *
+ * Description:
+ *   Internal public function to append the work to the expired queue of
+ *   the workqueue.  Require wqueue != NULL and work != NULL.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *   work   - The work to be inserted.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+static inline_function
+void work_insert_expired(FAR struct kwork_wqueue_s *wqueue,
+                         FAR struct work_s         *work)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE_HEAP
+  /* Make sure that work_remove() does not mistake the work as pending. */
+
+  work->hprev = NULL;
+#endif
+
+  work_stats_enqueue(wqueue);
+  list_add_tail(&wqueue->expired, &work->node);
+}
+
+/****************************************************************************
+ * Name: work_peek_pending
+ *
+ * Description:
+ *   Internal public function to get the earliest pending work.
+ *   Require wqueue != NULL.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *
+ * Returned Value:
+ *   The earliest pending work or NULL if there is no pending work.
+ *
+ ****************************************************************************/
+
+static inline_function
+FAR struct work_s *work_peek_pending(FAR struct kwork_wqueue_s *wqueue)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE_HEAP
+  return wqueue->pending;
+#else
+  if (list_is_empty(&wqueue->pending))
+    {
+      return NULL;
+    }
+
+  return list_first_entry(&wqueue->pending, struct work_s, node);
+#endif
+}
+
+/****************************************************************************
+ * Name: work_remove_pending
+ *
+ * Description:
+ *   Internal public function to remove the work from the pending queue
+ *   without seizing its ownership.  Require wqueue != NULL and the work
+ *   being in the pending queue.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *   work   - The work to be removed.
+ *
+ * Returned Value:
+ *   Return whether the head of the pending queue has changed.
+ *
+ ****************************************************************************/
+
+static inline_function
+bool work_remove_pending(FAR struct kwork_wqueue_s *wqueue,
+                         FAR struct work_s         *work)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE_HEAP
+  return work_heap_remove(wqueue, work);
+#else
+  FAR struct work_s *head;
+
+  head = list_first_entry(&wqueue->pending, struct work_s, node);
+
+  list_delete(&work->node);
+
+  return head == work;
+#endif
 }
 
 /****************************************************************************
@@ -229,17 +433,23 @@ static inline_function
 bool work_remove(FAR struct kwork_wqueue_s *wqueue,
                  FAR struct work_s         *work)
 {
-  FAR struct work_s *head;
-
-  head = list_first_entry(&wqueue->pending, struct work_s, node);
-
   /* Seize the ownership from the work thread. */
 
   work->worker = NULL;
 
-  list_delete(&work->node);
+  work_stats_dequeue(wqueue);
 
-  return head == work;
+#ifdef CONFIG_SCHED_WORKQUEUE_HEAP
+  /* The work is either in the pending heap or in the expired queue. */
+
+  if (work->hprev == NULL && wqueue->pending != work)
+    {
+      list_delete(&work->node);
+      return false;
+    }
+#endif
+
+  return work_remove_pending(wqueue, work);
 }
 
 /****************************************************************************
@@ -273,12 +483,10 @@ void work_timer_expired(wdparm_t arg);
 static inline_function
 void work_timer_reset(FAR struct kwork_wqueue_s *wqueue)
 {
-  if (!list_is_empty(&wqueue->pending))
-    {
-      FAR struct work_s *work;
-
-      work = list_first_entry(&wqueue->pending, struct work_s, node);
+  FAR struct work_s *work = work_peek_pending(wqueue);
 
+  if (work != NULL)
+    {
       wd_start_abstick(&wqueue->timer, work->qtime,
                        work_timer_expired, (wdparm_t)wqueue);
     }
@@ -326,6 +534,25 @@ int work_start_highpri(void);
 int work_start_lowpri(void);
 #endif
 
+/****************************************************************************
+ * Name: work_start_percpu
+ *
+ * Description:
+ *   Start the per-CPU, kernel-mode work queues.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Return zero (OK) on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+int work_start_percpu(void);
+#endif
+
 /****************************************************************************
  * Name: work_initialize_notifier
  *